@@ -0,0 +1,97 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef GAP_FRONTEND_ANALYSIS_OPTIONS_H
+#define GAP_FRONTEND_ANALYSIS_OPTIONS_H
+
+#include <gap_util/dependence_analyser.h>
+
+namespace gap
+{
+
+	/// Forward declaration
+	namespace util
+	{
+		class ThreadPool;
+	}
+
+	namespace dep
+	{
+		class DependenceCache;
+	}
+
+	/// Options controlling how the nest analysis is carried out. They are
+	/// set once from the command line and passed down from the compilation
+	/// driver to every nest being analysed
+	struct AnalysisOptions
+	{
+		AnalysisOptions()
+			: m_thread_pool(nullptr)
+			, m_dependence_cache(nullptr)
+			, m_query_driven(false)
+			, m_uniform_lattice(false)
+			, m_dump_dep_graph(false)
+		{
+		}
+
+		/// Pool used to test array subscript pairs concurrently. Null means
+		/// that the pairs are tested sequentially on the calling thread
+		util::ThreadPool* m_thread_pool;
+
+		/// Cache of exact dependence test results shared by all nests of the
+		/// compilation. Null means that every pair is tested from scratch
+		dep::DependenceCache* m_dependence_cache;
+
+		/// When set, the analysers only answer the questions the transformations
+		/// ask about the distance vectors (see dep::DistanceQuery) and stop as
+		/// soon as the answers are fixed. The cache is not used in this mode
+		bool m_query_driven;
+
+		/// When set, distances of uniform subscript pairs are described by
+		/// dep::DistanceLattice instead of being enumerated (see DependenceGraph).
+		/// Ignored in query-driven mode
+		bool m_uniform_lattice;
+
+		/// When set, the dependence graph of every analysed nest is printed
+		/// in Graphviz DOT format
+		bool m_dump_dep_graph;
+
+		/// Options passed to the exact dependence analysers (e.g. the engine
+		/// used to find integer solutions of the dependence system)
+		dep::DependenceTestOptions m_dep_test_options;
+	};
+
+} /// namespace gap
+
+#endif /// GAP_FRONTEND_ANALYSIS_OPTIONS_H
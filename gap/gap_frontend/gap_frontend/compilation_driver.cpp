@@ -60,8 +60,9 @@ namespace gap
 	} /// Anonymous namespace
 
 
-	CompilationDriver::CompilationDriver(clang::ASTContext& ast_ctx)
+	CompilationDriver::CompilationDriver(clang::ASTContext& ast_ctx, const AnalysisOptions& options)
 		: m_ast_ctx(ast_ctx)
+		, m_options(options)
 		, m_code_gen(m_ast_ctx)
 	{
 		auto & src_mngr = m_ast_ctx.getSourceManager();
@@ -94,7 +95,7 @@ namespace gap
 				try
 				{
 					NestInfoCollector collector(m_ast_ctx, sym_tbl_builder.GetSymTblTree(), *nest);
-					NestAnalysisDriver analysis_driver(m_ast_ctx, collector.GetConstructedNest());
+					NestAnalysisDriver analysis_driver(m_ast_ctx, collector.GetConstructedNest(), m_options);
 					m_code_gen.HandleLoopNest(
 						analysis_driver
 						, sym_tbl_builder.GetSymTblTree()
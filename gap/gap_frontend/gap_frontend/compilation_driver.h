@@ -40,6 +40,7 @@
 #include <clang/Basic/FileManager.h>
 #include <utility>
 #include "code_generator.h"
+#include "analysis_options.h"
 
 namespace gap
 {
@@ -52,13 +53,14 @@ namespace gap
 	{
 	public:
 
-		explicit CompilationDriver(clang::ASTContext& ast_ctx);
+		CompilationDriver(clang::ASTContext& ast_ctx, const AnalysisOptions& options);
 		~CompilationDriver();
 		virtual bool HandleTopLevelDecl(clang::DeclGroupRef decl_group_ref);
 
 	private:
 
 		clang::ASTContext& m_ast_ctx;
+		AnalysisOptions m_options;
 		CodeGenerator m_code_gen;
 		std::pair<clang::FileID, const clang::FileEntry*> m_main_file;
 	};
@@ -0,0 +1,791 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "dependence_graph.h"
+#include "dependence_mdl.h"
+#include "perfect_loop_nest.h"
+#include <gap_util/dependence_analyser.h>
+#include <gap_util/dependence_cache.h>
+#include <gap_util/distance_query.h>
+#include <gap_util/thread_pool.h>
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <deque>
+#include <map>
+#include <tuple>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <atomic>
+
+
+namespace gap
+{
+	namespace
+	{
+
+		/// Totals reported by GetPairPlanStatistics()
+		std::atomic<unsigned long long> subscript_pairs_total(0);
+		std::atomic<unsigned long long> dep_tests_total(0);
+
+		/// Distinct pair of subscript matrices shared by subscript pairs that differ only in
+		/// constant offsets (e.g. a[i][j] vs a[i+1][j-1] and a[i][j] vs a[i][j+2]). The
+		/// diophantine system of all these pairs is reduced to echelon form only once, by
+		/// whichever pair reaches the exact analyser first
+		struct SubscriptShape
+		{
+			const util::IntMatrixType* m_first_mat;
+			const util::IntMatrixType* m_second_mat;
+			bool m_is_uniform;
+			std::once_flag m_factor_once;
+			std::unique_ptr<dep::DependenceSystemFactorization> m_factorization;
+
+			SubscriptShape(
+				const util::IntMatrixType* first_mat
+				, const util::IntMatrixType* second_mat
+				, bool is_uniform)
+				: m_first_mat(first_mat)
+				, m_second_mat(second_mat)
+				, m_is_uniform(is_uniform)
+			{
+			}
+
+			const dep::DependenceSystemFactorization& GetFactorization()
+			{
+				std::call_once(m_factor_once, [this]()
+				{
+					m_factorization.reset(new dep::DependenceSystemFactorization(
+						*m_first_mat
+						, *m_second_mat
+						, m_is_uniform ? dep::SYSTEM_UNIFORM : dep::SYSTEM_GENERAL));
+				});
+				return *m_factorization;
+			}
+		};
+
+		bool SameMatrices(const util::IntMatrixType& x, const util::IntMatrixType& y)
+		{
+			return x.n_rows == y.n_rows && x.n_cols == y.n_cols && util::Equal(x, y);
+		}
+
+		void SelectDependenceAnalyser(
+			const IntMatVecPair& low_bnd
+			, const IntMatVecPair& upp_bnd
+			, const IntMatVecPair& first_arr_sub
+			, const IntMatVecPair& second_arr_sub
+			, SubscriptShape& shape
+			, const dep::DependenceSink& sink
+			, const std::function<void(const dep::DistanceLattice&)>& lattice_sink
+			, bool subs_are_in_distinct_stmts
+			, const AnalysisOptions& options)
+		{
+			/// Cheap inexact tests go first, exact analysers are run only when
+			/// these cannot prove that subscripts are independent
+			if (dep::PrefilterDependenceTest(
+				first_arr_sub.m_mat
+				, first_arr_sub.m_vec
+				, second_arr_sub.m_mat
+				, second_arr_sub.m_vec
+				, low_bnd.m_mat
+				, low_bnd.m_vec
+				, upp_bnd.m_mat
+				, upp_bnd.m_vec) != dep::PREFILTER_UNDECIDED)
+				return;
+
+			/// Results are taken from the cache when one is provided, the analysers
+			/// are run directly otherwise. Either way every dependence is handed to
+			/// the sink, and both reuse the factorization of the shape
+			bool is_uniform(shape.m_is_uniform);
+			const dep::DependenceSystemFactorization* factorization(&shape.GetFactorization());
+			dep::DependenceCache* dep_cache(options.m_dependence_cache);
+
+			/// In lattice mode the distances of uniform pairs are handed over as the
+			/// lattice. Pairs with a single distance are still enumerated, as this
+			/// costs no more than describing them
+			if (is_uniform && options.m_uniform_lattice && options.m_dep_test_options.query == nullptr)
+			{
+				dep::DistanceLattice lattice;
+				if (!dep::UniformLinearDependenceLattice(
+					first_arr_sub.m_mat
+					, first_arr_sub.m_vec
+					, second_arr_sub.m_vec
+					, low_bnd.m_mat
+					, low_bnd.m_vec
+					, upp_bnd.m_vec
+					, lattice
+					, subs_are_in_distinct_stmts
+					, factorization))
+					return;
+
+				if (lattice.generators.n_rows > 0)
+				{
+					lattice_sink(lattice);
+					return;
+				}
+			}
+
+			if (is_uniform && dep_cache != nullptr)
+				dep_cache->UniformLinearDependenceTest(
+					first_arr_sub.m_mat
+					, first_arr_sub.m_vec
+					, second_arr_sub.m_vec
+					, low_bnd.m_mat
+					, low_bnd.m_vec
+					, upp_bnd.m_vec
+					, sink
+					, subs_are_in_distinct_stmts
+					, options.m_dep_test_options
+					, factorization);
+			else if (is_uniform)
+				dep::UniformLinearDependenceTest(
+					first_arr_sub.m_mat
+					, first_arr_sub.m_vec
+					, second_arr_sub.m_vec
+					, low_bnd.m_mat
+					, low_bnd.m_vec
+					, upp_bnd.m_vec
+					, sink
+					, subs_are_in_distinct_stmts
+					, options.m_dep_test_options
+					, factorization);
+			else if (dep_cache != nullptr)
+				dep_cache->GeneralLinearDependenceTest(
+					first_arr_sub.m_mat
+					, first_arr_sub.m_vec
+					, second_arr_sub.m_mat
+					, second_arr_sub.m_vec
+					, low_bnd.m_mat
+					, low_bnd.m_vec
+					, upp_bnd.m_mat
+					, upp_bnd.m_vec
+					, sink
+					, subs_are_in_distinct_stmts
+					, options.m_dep_test_options
+					, factorization);
+			else
+				dep::GeneralLinearDependenceTest(
+					first_arr_sub.m_mat
+					, first_arr_sub.m_vec
+					, second_arr_sub.m_mat
+					, second_arr_sub.m_vec
+					, low_bnd.m_mat
+					, low_bnd.m_vec
+					, upp_bnd.m_mat
+					, upp_bnd.m_vec
+					, sink
+					, subs_are_in_distinct_stmts
+					, options.m_dep_test_options
+					, factorization);
+		}
+
+		/// Single array subscript pair collected from the nest. Pairs that differ only in
+		/// the stmts (or arrays) they come from share the same dependence test. The first
+		/// subscript is always the LHS of its stmt, the second one is either the LHS or
+		/// one of the RHS subscripts of its stmt
+		struct SubscriptPairTask
+		{
+			const VarDeclMatVecPair* m_first_arr_sub;
+			const VarDeclMatVecPair* m_second_arr_sub;
+			std::size_t m_first_stmt;
+			std::size_t m_second_stmt;
+			bool m_second_is_lhs;
+			bool m_subs_are_in_distinct_stmts;
+			std::size_t m_test;
+			bool m_swapped;		/// The test has the subscripts in the opposite order
+		};
+
+		/// Distinct (subscript, subscript, distinct stmts flag) combination that has to be
+		/// handed to the dependence analyser, with the pairs its result is fanned out to
+		struct SubscriptPairTest
+		{
+			const IntMatVecPair* m_first_arr_sub;
+			const IntMatVecPair* m_second_arr_sub;
+			bool m_subs_are_in_distinct_stmts;
+			SubscriptShape* m_shape;
+			std::vector<std::size_t> m_tasks;
+		};
+
+		/// Each LHS array sub of each assign stmt has to be checked against each LHS
+		/// array sub of other assign stmts (excluding its own stmt) as well as against
+		/// RHS array subs in all assign stmts (including its own stmt)
+		std::vector<SubscriptPairTask> CollectSubscriptPairs(const DependenceMdl& dep_mdl)
+		{
+			std::vector<SubscriptPairTask> tasks;
+			auto & assign_stmts = dep_mdl.GetAssignStmts();
+			for (std::size_t curr = 0; curr < assign_stmts.size(); ++curr)
+			{
+				if (assign_stmts[curr].GetLhs() == nullptr)
+					continue;
+
+				const VarDeclMatVecPair& lhs_arr_sub = *assign_stmts[curr].GetLhs();
+				for (std::size_t other = 0; other < assign_stmts.size(); ++other)
+				{
+					auto & other_assign_stmt = assign_stmts[other];
+					if (curr != other
+						&& other_assign_stmt.GetLhs() != nullptr
+						&& lhs_arr_sub.first == other_assign_stmt.GetLhs()->first)
+						tasks.push_back({ &lhs_arr_sub, other_assign_stmt.GetLhs(), curr, other, true, true, 0, false });
+
+					for (auto & rhs_arr_sub : other_assign_stmt.GetRhs())
+						if (lhs_arr_sub.first == rhs_arr_sub.first)
+							tasks.push_back({ &lhs_arr_sub, &rhs_arr_sub, curr, other, false, curr != other, 0, false });
+				}
+			}
+
+			return tasks;
+		}
+
+		/// Subscript in canonical form: dimensions of the matrix followed by the elements
+		/// of the matrix and of the vector. The array is left out as the analysers don't
+		/// depend on it
+		std::vector<long long> CanonicalizeSubscript(const IntMatVecPair& arr_sub)
+		{
+			std::vector<long long> key;
+			key.reserve(2 + arr_sub.m_mat.n_elem + arr_sub.m_vec.n_elem);
+			key.push_back(static_cast<long long>(arr_sub.m_mat.n_rows));
+			key.push_back(static_cast<long long>(arr_sub.m_mat.n_cols));
+			key.insert(key.end(), arr_sub.m_mat.begin(), arr_sub.m_mat.end());
+			key.insert(key.end(), arr_sub.m_vec.begin(), arr_sub.m_vec.end());
+			return key;
+		}
+
+		/// Assigns every pair to the test of its canonical subscripts. Testing X against Y
+		/// yields the dependences of testing Y against X with the roles of the subscripts
+		/// swapped, so the subscripts of a test are ordered by their canonical index (this
+		/// also merges LHS/LHS pairs that are collected in both orders)
+		std::vector<SubscriptPairTest> PlanSubscriptPairTests(std::vector<SubscriptPairTask>& tasks)
+		{
+			std::map<std::vector<long long>, std::size_t> arr_sub_idxs;
+			auto canonical_idx = [&](const IntMatVecPair& arr_sub)
+			{
+				return arr_sub_idxs.emplace(CanonicalizeSubscript(arr_sub), arr_sub_idxs.size()).first->second;
+			};
+
+			std::vector<SubscriptPairTest> tests;
+			std::map<std::tuple<std::size_t, std::size_t, bool>, std::size_t> test_idxs;
+			for (std::size_t i = 0; i < tasks.size(); ++i)
+			{
+				auto & task = tasks[i];
+				std::size_t first_idx(canonical_idx(task.m_first_arr_sub->second));
+				std::size_t second_idx(canonical_idx(task.m_second_arr_sub->second));
+				task.m_swapped = first_idx > second_idx;
+
+				auto inserted = test_idxs.emplace(
+					std::make_tuple(std::min(first_idx, second_idx), std::max(first_idx, second_idx), task.m_subs_are_in_distinct_stmts)
+					, tests.size());
+				if (inserted.second)
+					tests.push_back({
+						task.m_swapped ? &task.m_second_arr_sub->second : &task.m_first_arr_sub->second
+						, task.m_swapped ? &task.m_first_arr_sub->second : &task.m_second_arr_sub->second
+						, task.m_subs_are_in_distinct_stmts
+						, nullptr
+						, {} });
+
+				task.m_test = inserted.first->second;
+				tests[task.m_test].m_tasks.push_back(i);
+			}
+
+			return tests;
+		}
+
+		/// Assigns every test to the shape of its subscript matrices. Shapes are kept in
+		/// a deque as they are neither copyable nor movable
+		void GroupSubscriptPairsByShape(
+			std::vector<SubscriptPairTest>& tests
+			, bool is_regular_or_rect_nest
+			, std::deque<SubscriptShape>& shapes)
+		{
+			for (auto & test : tests)
+			{
+				const util::IntMatrixType& first_mat(test.m_first_arr_sub->m_mat);
+				const util::IntMatrixType& second_mat(test.m_second_arr_sub->m_mat);
+				auto shape = std::find_if(shapes.begin(), shapes.end(), [&](const SubscriptShape& s)
+				{
+					return SameMatrices(*s.m_first_mat, first_mat) && SameMatrices(*s.m_second_mat, second_mat);
+				});
+
+				if (shape == shapes.end())
+				{
+					shapes.emplace_back(
+						&first_mat
+						, &second_mat
+						, is_regular_or_rect_nest && SameMatrices(first_mat, second_mat));
+					shape = std::prev(shapes.end());
+				}
+				test.m_shape = &*shape;
+			}
+		}
+
+		bool SameRowVecs(const util::IntRowVecType& x, const util::IntRowVecType& y)
+		{
+			return x.n_cols == y.n_cols && std::equal(x.begin(), x.end(), y.begin());
+		}
+
+		DependenceEdge& FindOrAddEdge(
+			std::size_t src_stmt
+			, std::size_t sink_stmt
+			, const clang::VarDecl* array
+			, DependenceEdge::DependenceKind kind
+			, std::size_t nest_depth
+			, std::vector<DependenceEdge>& edges)
+		{
+			auto edge = std::find_if(edges.begin(), edges.end(), [&](const DependenceEdge& e)
+			{
+				return e.m_src_stmt == src_stmt && e.m_sink_stmt == sink_stmt && e.m_array == array && e.m_kind == kind;
+			});
+
+			if (edge != edges.end())
+				return *edge;
+
+			edges.emplace_back(src_stmt, sink_stmt, array, kind, nest_depth);
+			return edges.back();
+		}
+
+		void AddDirectionVec(const util::IntRowVecType& sig, DependenceEdge& edge)
+		{
+			if (std::none_of(
+				edge.m_direction_vecs.begin()
+				, edge.m_direction_vecs.end()
+				, [&](const util::IntRowVecType& dir) { return SameRowVecs(dir, sig); }))
+				edge.m_direction_vecs.push_back(sig);
+		}
+
+		/// Adds the dependence to the edge it belongs to. Instance of the first stmt
+		/// executes before the instance of the second one when its iteration is smaller
+		/// or, within the same iteration, when the first stmt precedes the second one
+		void AddDependence(
+			const SubscriptPairTask& task
+			, const util::IntRowVecType& dist
+			, const util::IntRowVecType& sig
+			, bool first_is_earlier_iter
+			, std::size_t nest_depth
+			, std::vector<DependenceEdge>& edges)
+		{
+			/// The first subscript is always the LHS of its stmt
+			dep::DependenceClass dep_class(dep::ClassifyDependence(
+				dist
+				, first_is_earlier_iter
+				, task.m_first_stmt < task.m_second_stmt
+				, true
+				, task.m_second_is_lhs));
+
+			DependenceEdge& edge(FindOrAddEdge(
+				dep_class.first_is_src ? task.m_first_stmt : task.m_second_stmt
+				, dep_class.first_is_src ? task.m_second_stmt : task.m_first_stmt
+				, task.m_first_arr_sub->first
+				, dep_class.kind
+				, nest_depth
+				, edges));
+
+			edge.m_carried_level = std::min(edge.m_carried_level, static_cast<std::size_t>(dep_class.level));
+			edge.m_distances.Insert(dist);
+			AddDirectionVec(sig, edge);
+		}
+
+		bool SameLattices(const dep::DistanceLattice& x, const dep::DistanceLattice& y)
+		{
+			return SameRowVecs(x.base, y.base)
+				&& SameMatrices(x.generators, y.generators)
+				&& SameMatrices(x.constraints, y.constraints)
+				&& SameRowVecs(x.constraints_rhs, y.constraints_rhs);
+		}
+
+		void AddEdgeLattice(const dep::DistanceLattice& lattice, DependenceEdge& edge)
+		{
+			if (std::none_of(
+				edge.m_lattices.begin()
+				, edge.m_lattices.end()
+				, [&](const dep::DistanceLattice& l) { return SameLattices(l, lattice); }))
+				edge.m_lattices.push_back(lattice);
+		}
+
+		/// Adds the lexicographically positive vectors of the lattice to the edges they
+		/// belong to. All loop carried ones go to the same edge, whose level is the
+		/// outermost level the bounds of the lattice allow. Zero vector, when the bounds
+		/// allow it and it is a dependence (see AddDependence()), is added as distance
+		void AddLattice(
+			const SubscriptPairTask& task
+			, const dep::DistanceLattice& lattice
+			, bool first_is_earlier_iter
+			, bool zero_is_dependence
+			, std::size_t nest_depth
+			, std::vector<DependenceEdge>& edges)
+		{
+			std::size_t level(0);
+			while (level < nest_depth && !lattice.MayHaveLevel(level))
+				++level;
+
+			if (level < nest_depth)
+			{
+				util::IntRowVecType unit(nest_depth);
+				unit(level) = 1;
+				dep::DependenceClass dep_class(dep::ClassifyDependence(
+					unit
+					, first_is_earlier_iter
+					, task.m_first_stmt < task.m_second_stmt
+					, true
+					, task.m_second_is_lhs));
+
+				DependenceEdge& edge(FindOrAddEdge(
+					dep_class.first_is_src ? task.m_first_stmt : task.m_second_stmt
+					, dep_class.first_is_src ? task.m_second_stmt : task.m_first_stmt
+					, task.m_first_arr_sub->first
+					, dep_class.kind
+					, nest_depth
+					, edges));
+
+				edge.m_carried_level = std::min(edge.m_carried_level, level);
+				AddEdgeLattice(lattice, edge);
+			}
+
+			if (zero_is_dependence && lattice.MayHaveLevel(nest_depth))
+			{
+				util::IntRowVecType zero(nest_depth);
+				AddDependence(task, zero, zero, first_is_earlier_iter, nest_depth, edges);
+			}
+		}
+
+		void MergeEdge(const DependenceEdge& edge, std::size_t nest_depth, std::vector<DependenceEdge>& edges)
+		{
+			DependenceEdge& target(FindOrAddEdge(
+				edge.m_src_stmt
+				, edge.m_sink_stmt
+				, edge.m_array
+				, edge.m_kind
+				, nest_depth
+				, edges));
+
+			target.m_carried_level = std::min(target.m_carried_level, edge.m_carried_level);
+			target.m_distances.Merge(edge.m_distances);
+			for (auto & dir : edge.m_direction_vecs)
+				AddDirectionVec(dir, target);
+			for (auto & lattice : edge.m_lattices)
+				AddEdgeLattice(lattice, target);
+		}
+
+		std::string KindToStr(DependenceEdge::DependenceKind kind)
+		{
+			switch (kind)
+			{
+			case dep::DEPENDENCE_FLOW:
+				return "flow";
+			case dep::DEPENDENCE_ANTI:
+				return "anti";
+			case dep::DEPENDENCE_OUTPUT:
+				return "output";
+			default:
+				return "unknown";
+			}
+		}
+
+		std::string RowVecToStr(const util::IntRowVecType& vec, bool as_direction)
+		{
+			std::string str("(");
+			for (std::size_t k = 0; k < vec.n_cols; ++k)
+			{
+				if (k > 0)
+					str += ", ";
+				str += !as_direction ? std::to_string(vec(k)) : (vec(k) > 0 ? "<" : (vec(k) < 0 ? ">" : "="));
+			}
+			return str + ")";
+		}
+
+		/// Base, generators and, for every level, the directions the bounds of the
+		/// lattice allow (e.g. "<=" when the component may be positive or zero)
+		std::string LatticeToStr(const dep::DistanceLattice& lattice)
+		{
+			std::string str("lattice " + RowVecToStr(lattice.base, false) + " gen");
+			for (std::size_t row = 0; row < lattice.generators.n_rows; ++row)
+				str += " " + RowVecToStr(util::IntRowVecType(util::IntMatrixType(lattice.generators.row(row))), false);
+
+			str += " dir (";
+			for (std::size_t k = 0; k < lattice.base.n_cols; ++k)
+			{
+				unsigned directions(lattice.Directions(k));
+				if (k > 0)
+					str += ", ";
+				if (directions & dep::DistanceLattice::Positive)
+					str += "<";
+				if (directions & dep::DistanceLattice::Zero)
+					str += "=";
+				if (directions & dep::DistanceLattice::Negative)
+					str += ">";
+			}
+			return str + ")";
+		}
+
+	} /// Anonymous namespace
+
+
+	DependenceEdge::DependenceEdge(
+		std::size_t src_stmt
+		, std::size_t sink_stmt
+		, const clang::VarDecl* array
+		, DependenceKind kind
+		, std::size_t nest_depth)
+
+		: m_src_stmt(src_stmt)
+		, m_sink_stmt(sink_stmt)
+		, m_array(array)
+		, m_kind(kind)
+		, m_carried_level(nest_depth)
+		, m_distances(nest_depth, false)
+	{
+	}
+
+	DependenceGraph::DependenceGraph(const DependenceMdl& dep_mdl, const AnalysisOptions& options)
+		: m_nest_depth(dep_mdl.GetNest().GetNestDepth())
+		, m_stmt_cnt(dep_mdl.GetAssignStmts().size())
+		, m_subscript_pair_cnt(0)
+		, m_dep_test_cnt(0)
+		, m_has_edges(!options.m_query_driven)
+		, m_out_edges(m_stmt_cnt)
+		, m_in_edges(m_stmt_cnt)
+	{
+		bool is_regular_or_rect_nest(
+			util::Equal(dep_mdl.GetLowerBnd().m_mat, dep_mdl.GetUpperBnd().m_mat));
+
+		std::vector<SubscriptPairTask> tasks(CollectSubscriptPairs(dep_mdl));
+		std::vector<SubscriptPairTest> tests(PlanSubscriptPairTests(tasks));
+		std::deque<SubscriptShape> shapes;
+		GroupSubscriptPairsByShape(tests, is_regular_or_rect_nest, shapes);
+
+		m_subscript_pair_cnt = tasks.size();
+		m_dep_test_cnt = tests.size();
+		subscript_pairs_total += m_subscript_pair_cnt;
+		dep_tests_total += m_dep_test_cnt;
+
+		/// In query-driven mode the analysers hand the distances to a query shared
+		/// by all pairs, which keeps only the distinct ones and stops the analysis
+		/// once the rank and the hyperplane multiplier can no longer change
+		std::unique_ptr<dep::DistanceQuery> query;
+		AnalysisOptions task_options(options);
+		if (options.m_query_driven)
+		{
+			query.reset(new dep::DistanceQuery(m_nest_depth, dep::QUERY_RANK | dep::QUERY_MULTIPLIER));
+
+			util::IntRowVecType dist_lower(m_nest_depth), dist_upper(m_nest_depth);
+			if (dep::FindDistanceBounds(
+				dep_mdl.GetLowerBnd().m_mat
+				, dep_mdl.GetLowerBnd().m_vec
+				, dep_mdl.GetUpperBnd().m_mat
+				, dep_mdl.GetUpperBnd().m_vec
+				, dist_lower
+				, dist_upper))
+				query->SetDistanceBounds(dist_lower, dist_upper);
+
+			task_options.m_dependence_cache = nullptr;
+			task_options.m_dep_test_options.query = query.get();
+		}
+
+		std::size_t nest_depth(m_nest_depth);
+		auto run_test = [&](const SubscriptPairTest& test, std::vector<DependenceEdge>& out)
+		{
+			if (query != nullptr && query->IsAnswered())
+				return;
+
+			/// Every dependence is fanned out to every pair of the test as soon as it
+			/// is found, so nothing is kept per point apart from the edges
+			SelectDependenceAnalyser(
+				dep_mdl.GetLowerBnd()
+				, dep_mdl.GetUpperBnd()
+				, *test.m_first_arr_sub
+				, *test.m_second_arr_sub
+				, *test.m_shape
+				, [&](const util::IntRowVecType& dist, dep::DependenceDirection direction)
+				{
+					bool second_on_first(direction == dep::DEPENDENCE_T_ON_S);
+					util::IntRowVecType sig(arma::sign(static_cast<const arma::Mat<long long>&>(dist)));
+					for (auto task_idx : test.m_tasks)
+					{
+						const SubscriptPairTask& task(tasks[task_idx]);
+						AddDependence(task, dist, sig, second_on_first != task.m_swapped, nest_depth, out);
+					}
+					return true;
+				}
+				, [&](const dep::DistanceLattice& lattice)
+				{
+					/// Positive vectors of the lattice are distances of T on S, positive
+					/// vectors of the negated lattice are distances of S on T. Zero vector
+					/// counts as T on S, as it does for the analysers
+					const dep::DistanceLattice negated(lattice.Negated());
+					for (auto second_on_first : { true, false })
+						for (auto task_idx : test.m_tasks)
+						{
+							const SubscriptPairTask& task(tasks[task_idx]);
+							AddLattice(
+								task
+								, second_on_first ? lattice : negated
+								, second_on_first != task.m_swapped
+								, second_on_first && test.m_subs_are_in_distinct_stmts
+								, nest_depth
+								, out);
+						}
+				}
+				, test.m_subs_are_in_distinct_stmts
+				, task_options);
+		};
+
+		if (options.m_thread_pool == nullptr || tests.size() < 2)
+		{
+			for (auto & test : tests)
+				run_test(test, m_edges);
+		}
+		else
+		{
+			/// Every test gets its own edges so that workers never share state. Edges
+			/// are merged in the order in which tests were planned, so the graph
+			/// doesn't depend on scheduling
+			std::vector<std::vector<DependenceEdge>> test_edges(tests.size());
+			for (std::size_t i = 0; i < tests.size(); ++i)
+				options.m_thread_pool->Submit(
+					[&, i](unsigned) { run_test(tests[i], test_edges[i]); });
+
+			options.m_thread_pool->Wait();
+			for (auto & edges : test_edges)
+				for (auto & edge : edges)
+					MergeEdge(edge, m_nest_depth, m_edges);
+		}
+
+		if (query != nullptr)
+		{
+			m_distance_vecs = query->GetDistances();
+			return;
+		}
+
+		/// Edges keep every distinct distance, the transformations only get the
+		/// ones that can change the unimodular matrix
+		util::DistanceSet distances(m_nest_depth);
+		for (std::size_t i = 0; i < m_edges.size(); ++i)
+		{
+			m_out_edges[m_edges[i].m_src_stmt].push_back(i);
+			m_in_edges[m_edges[i].m_sink_stmt].push_back(i);
+			distances.Merge(m_edges[i].m_distances);
+			for (auto & lattice : m_edges[i].m_lattices)
+				dep::InsertLatticeDistances(lattice, distances);
+		}
+		m_distance_vecs = distances.ToVectors();
+	}
+
+	PairPlanStatistics GetPairPlanStatistics()
+	{
+		PairPlanStatistics stats;
+		stats.subscript_pairs = subscript_pairs_total;
+		stats.dep_tests = dep_tests_total;
+		return stats;
+	}
+
+	std::size_t DependenceGraph::GetNestDepth() const
+	{
+		return m_nest_depth;
+	}
+
+	std::size_t DependenceGraph::GetStmtCnt() const
+	{
+		return m_stmt_cnt;
+	}
+
+	std::size_t DependenceGraph::GetSubscriptPairCnt() const
+	{
+		return m_subscript_pair_cnt;
+	}
+
+	std::size_t DependenceGraph::GetDependenceTestCnt() const
+	{
+		return m_dep_test_cnt;
+	}
+
+	bool DependenceGraph::HasEdges() const
+	{
+		return m_has_edges;
+	}
+
+	const std::vector<DependenceEdge>& DependenceGraph::GetEdges() const
+	{
+		return m_edges;
+	}
+
+	const std::vector<std::size_t>& DependenceGraph::GetOutEdges(std::size_t stmt) const
+	{
+		return m_out_edges.at(stmt);
+	}
+
+	const std::vector<std::size_t>& DependenceGraph::GetInEdges(std::size_t stmt) const
+	{
+		return m_in_edges.at(stmt);
+	}
+
+	const std::vector<util::IntRowVecType>& DependenceGraph::GetDistanceVecs() const
+	{
+		return m_distance_vecs;
+	}
+
+	void DependenceGraph::Serialize(std::ostream& out) const
+	{
+		out << "digraph dependences {\n";
+		out << "\t// " << m_subscript_pair_cnt << " subscript pairs tested by " << m_dep_test_cnt << " dependence tests\n";
+		if (!m_has_edges)
+			out << "\t// dependences are not recorded in query-driven mode\n";
+
+		for (std::size_t stmt = 0; stmt < m_stmt_cnt; ++stmt)
+			out << "\tS" << stmt + 1 << ";\n";
+
+		for (auto & edge : m_edges)
+		{
+			out
+				<< "\tS" << edge.m_src_stmt + 1 << " -> S" << edge.m_sink_stmt + 1
+				<< " [label=\"" << edge.m_array->getNameAsString() << " " << KindToStr(edge.m_kind)
+				<< ", level " << (edge.m_carried_level < m_nest_depth ? std::to_string(edge.m_carried_level + 1) : "independent")
+				<< "\\ndist";
+			for (auto & d : edge.m_distances.ToVectors())
+				out << " " << RowVecToStr(d, false);
+			out << "\\ndir";
+			for (auto & dir : edge.m_direction_vecs)
+				out << " " << RowVecToStr(dir, true);
+			for (auto & lattice : edge.m_lattices)
+				out << "\\n" << LatticeToStr(lattice);
+			out << "\"];\n";
+		}
+
+		out << "}\n";
+	}
+
+	void DependenceGraph::Dump() const
+	{
+		Serialize(std::cout);
+	}
+
+} /// namespace gap
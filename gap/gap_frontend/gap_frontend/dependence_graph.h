@@ -0,0 +1,166 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef GAP_FRONTEND_DEPENDENCE_GRAPH_H
+#define GAP_FRONTEND_DEPENDENCE_GRAPH_H
+
+#include "analysis_options.h"
+#include <gap_util/dependence_info.h>
+#include <gap_util/distance_set.h>
+#include <gap_util/types.h>
+#include <clang/AST/Decl.h>
+#include <ostream>
+#include <vector>
+
+namespace gap
+{
+
+	/// Forward declaration
+	class DependenceMdl;
+
+	/// Single edge of the dependence graph. Source statement instance executes
+	/// before the sink statement instance and both of them access the same
+	/// element of the array. Statements are identified by their position in
+	/// DependenceMdl::GetAssignStmts()
+	struct DependenceEdge
+	{
+		/// Flow, anti or output (see dep::DependenceKind)
+		typedef dep::DependenceKind DependenceKind;
+
+		DependenceEdge(
+			std::size_t src_stmt
+			, std::size_t sink_stmt
+			, const clang::VarDecl* array
+			, DependenceKind kind
+			, std::size_t nest_depth);
+
+		std::size_t m_src_stmt;
+		std::size_t m_sink_stmt;
+		const clang::VarDecl* m_array;
+		DependenceKind m_kind;
+
+		/// Outermost loop that carries the dependence. Equal to the nest depth
+		/// when the edge holds only loop independent (zero distance) dependences
+		std::size_t m_carried_level;
+
+		/// All distinct distances (sink iteration minus source iteration) and
+		/// direction vectors. Distances are not reduced, util::DistanceSet only
+		/// drops the duplicates
+		util::DistanceSet m_distances;
+		std::vector<util::IntRowVecType> m_direction_vecs;
+
+		/// Distances found in lattice mode (see DependenceGraph): lexicographically
+		/// positive vectors of every lattice are distances of the edge. They are
+		/// not part of m_distances and m_direction_vecs
+		std::vector<dep::DistanceLattice> m_lattices;
+	};
+
+	/// Number of array subscript pairs collected from all nests and number of
+	/// distinct dependence tests they were collapsed into (see DependenceGraph)
+	struct PairPlanStatistics
+	{
+		unsigned long long subscript_pairs;
+		unsigned long long dep_tests;
+	};
+
+	PairPlanStatistics GetPairPlanStatistics();
+
+	/// Dependence graph of a perfect loop nest built from its dependence model.
+	/// Assignment stmts are the nodes and there is one edge for each (source
+	/// stmt, sink stmt, array, dependence kind) combination. Every array subscript
+	/// pair of the nest is tested once, while the graph is being constructed, so
+	/// that all transformations of the nest query the same results instead of
+	/// running the dependence analysers again. Moreover, pairs are grouped by
+	/// their subscripts (in canonical form) before testing, and the analyser is
+	/// run only once for each distinct (subscript, subscript, distinct stmts)
+	/// combination, its result being fanned out to all pairs of the group
+	///
+	/// In query-driven mode (see AnalysisOptions) the analysers stop as soon as
+	/// the distance matrix can no longer change the transformation. Dependences
+	/// are incomplete in this case, so the graph doesn't record any edges and
+	/// only the distance vectors of the nest are available
+	///
+	/// In lattice mode (see AnalysisOptions) distances of uniform pairs are not
+	/// enumerated. The edges get the lattice of the distances instead, with the
+	/// levels (and the loop independent dependence) the bounds of the lattice
+	/// allow, so they may hold dependences that don't exist. The transformations
+	/// get the exact distances: vectors of each lattice are enumerated into the
+	/// reduced distance set (dep::InsertLatticeDistances()), one per distance
+	class DependenceGraph
+	{
+	public:
+
+		DependenceGraph(const DependenceMdl& dep_mdl, const AnalysisOptions& options);
+
+		/// Accessors
+		std::size_t GetNestDepth() const;
+		std::size_t GetStmtCnt() const;
+		std::size_t GetSubscriptPairCnt() const;
+		std::size_t GetDependenceTestCnt() const;
+		bool HasEdges() const;
+		const std::vector<DependenceEdge>& GetEdges() const;
+
+		/// Indices (into GetEdges()) of the edges leaving / entering the stmt
+		const std::vector<std::size_t>& GetOutEdges(std::size_t stmt) const;
+		const std::vector<std::size_t>& GetInEdges(std::size_t stmt) const;
+
+		/// Distance vectors of all the dependences in the nest, reduced to the
+		/// ones that can affect the unimodular transformations (edges keep all
+		/// distinct distances, the reduction is applied only here). Vectors of the
+		/// edge lattices are inserted the same way
+		const std::vector<util::IntRowVecType>& GetDistanceVecs() const;
+
+		/// Writes the graph in Graphviz DOT format
+		void Serialize(std::ostream& out) const;
+
+		/// Dump
+		void Dump() const;
+
+	private:
+
+		std::size_t m_nest_depth;
+		std::size_t m_stmt_cnt;
+		std::size_t m_subscript_pair_cnt;
+		std::size_t m_dep_test_cnt;
+		bool m_has_edges;
+		std::vector<DependenceEdge> m_edges;
+		std::vector<std::vector<std::size_t>> m_out_edges;
+		std::vector<std::vector<std::size_t>> m_in_edges;
+		std::vector<util::IntRowVecType> m_distance_vecs;
+	};
+
+} /// namespace gap
+
+#endif /// GAP_FRONTEND_DEPENDENCE_GRAPH_H
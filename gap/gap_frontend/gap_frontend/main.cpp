@@ -37,12 +37,143 @@
 #include <clang/Frontend/CompilerInstance.h>
 #include <clang/Tooling/CommonOptionsParser.h>
 #include <clang/Tooling/Tooling.h>
+#include <gap_util/dependence_analyser.h>
+#include <gap_util/dependence_cache.h>
+#include <gap_util/fourier_elimination.h>
+#include <gap_util/checked_arithmetic.h>
+#include <gap_util/thread_pool.h>
+#include <iostream>
 #include "compilation_driver.h"
+#include "dependence_graph.h"
 #include "ast_helpers.h"
 
 
 static llvm::cl::OptionCategory option_category("C2CUDA");
 
+static llvm::cl::opt<unsigned> dep_threads(
+	"dep-threads"
+	, llvm::cl::desc("Number of threads used to test array subscript pairs for dependences (default 1)")
+	, llvm::cl::init(1)
+	, llvm::cl::cat(option_category));
+
+static llvm::cl::opt<unsigned> enum_threads(
+	"enum-threads"
+	, llvm::cl::desc("Number of threads used to enumerate integer solutions of every dependence system with the fourier engine, on a pool separate from -dep-threads (default 1)")
+	, llvm::cl::init(1)
+	, llvm::cl::cat(option_category));
+
+static llvm::cl::opt<gap::dep::IntegerEngine> dep_engine(
+	"dep-engine"
+	, llvm::cl::desc("Engine used to find integer solutions of dependence systems:")
+	, llvm::cl::values(
+		clEnumValN(gap::dep::ENGINE_FOURIER, "fourier", "Fourier elimination followed by enumeration (default)")
+		, clEnumValN(gap::dep::ENGINE_OMEGA, "omega", "Exact integer elimination (Omega test)")
+		, clEnumValEnd)
+	, llvm::cl::init(gap::dep::ENGINE_FOURIER)
+	, llvm::cl::cat(option_category));
+
+static llvm::cl::opt<bool> fm_prune(
+	"fm-prune"
+	, llvm::cl::desc("Remove duplicated, dominated and Chernikov-redundant inequalities during Fourier elimination (default true)")
+	, llvm::cl::init(true)
+	, llvm::cl::cat(option_category));
+
+static llvm::cl::opt<bool> fm_exact_redundancy(
+	"fm-exact-redundancy"
+	, llvm::cl::desc("Additionally remove every inequality implied by the rest of the system during Fourier elimination (default false)")
+	, llvm::cl::init(false)
+	, llvm::cl::cat(option_category));
+
+static llvm::cl::opt<bool> rational_lazy_normalization(
+	"rational-lazy-normalization"
+	, llvm::cl::desc("Reduce rational numbers by GCD only once their numerators or denominators exceed 2^31 - 1 (default false)")
+	, llvm::cl::init(false)
+	, llvm::cl::cat(option_category));
+
+static llvm::cl::opt<bool> dep_cache(
+	"dep-cache"
+	, llvm::cl::desc("Reuse results of the exact dependence tests for equivalent array subscript pairs (default true)")
+	, llvm::cl::init(true)
+	, llvm::cl::cat(option_category));
+
+static llvm::cl::opt<unsigned> dep_cache_capacity(
+	"dep-cache-capacity"
+	, llvm::cl::desc("Number of distance vectors kept by the dependence cache before the least recently used results are evicted (default 65536)")
+	, llvm::cl::init(static_cast<unsigned>(gap::dep::DependenceCache::DEFAULT_CAPACITY))
+	, llvm::cl::cat(option_category));
+
+static llvm::cl::opt<bool> dep_query(
+	"dep-query"
+	, llvm::cl::desc("Stop the dependence analysis of a nest once the distances span the whole space and can't change the hyperplane used by the transformations (default false)")
+	, llvm::cl::init(false)
+	, llvm::cl::cat(option_category));
+
+static llvm::cl::opt<bool> dep_lattice(
+	"dep-lattice"
+	, llvm::cl::desc("Describe the distances of uniform array subscript pairs by lattices instead of enumerating them (default false)")
+	, llvm::cl::init(false)
+	, llvm::cl::cat(option_category));
+
+static llvm::cl::opt<bool> dep_graph(
+	"dep-graph"
+	, llvm::cl::desc("Print the dependence graph of every analysed nest in Graphviz DOT format (default false)")
+	, llvm::cl::init(false)
+	, llvm::cl::cat(option_category));
+
+/// Set up in main() once the command line has been parsed
+static gap::AnalysisOptions analysis_options;
+
+static void DumpDependenceAnalysisStatistics()
+{
+	auto prefilter_stats = gap::dep::GetPrefilterStatistics();
+	std::cout
+		<< "info: dependence pre-filter: "
+		<< prefilter_stats.hits[gap::dep::PREFILTER_ZIV] << " ZIV, "
+		<< prefilter_stats.hits[gap::dep::PREFILTER_GCD] << " GCD, "
+		<< prefilter_stats.hits[gap::dep::PREFILTER_SIV] << " SIV, "
+		<< prefilter_stats.hits[gap::dep::PREFILTER_BANERJEE] << " Banerjee, "
+		<< prefilter_stats.hits[gap::dep::PREFILTER_EMPTY_NEST] << " empty nest, "
+		<< prefilter_stats.hits[gap::dep::PREFILTER_UNDECIDED] << " passed to exact test"
+		<< std::endl;
+
+	auto pair_plan_stats = gap::GetPairPlanStatistics();
+	std::cout
+		<< "info: dependence pair planning: "
+		<< pair_plan_stats.subscript_pairs << " subscript pairs collapsed into "
+		<< pair_plan_stats.dep_tests << " tests"
+		<< std::endl;
+
+	auto fourier_stats = gap::util::GetFourierEliminationStatistics();
+	std::cout
+		<< "info: fourier elimination: "
+		<< fourier_stats.peak_inequalities << " peak inequalities, "
+		<< fourier_stats.generated_inequalities << " generated, "
+		<< fourier_stats.pruned_inequalities << " pruned"
+		<< std::endl;
+
+	auto rational_stats = gap::util::GetRationalStatistics();
+	std::cout
+		<< "info: rational arithmetic: "
+		<< rational_stats.hits[gap::util::RATIONAL_TIER_FAST] << " 64-bit, "
+		<< rational_stats.hits[gap::util::RATIONAL_TIER_WIDE] << " 128-bit, "
+		<< rational_stats.hits[gap::util::RATIONAL_TIER_BIG] << " bignum, "
+		<< rational_stats.hits[gap::util::RATIONAL_TIER_OVERFLOW] << " overflowed"
+		<< std::endl;
+
+	if (analysis_options.m_dependence_cache != nullptr)
+	{
+		auto cache_stats = analysis_options.m_dependence_cache->GetStatistics();
+		std::cout
+			<< "info: dependence cache: "
+			<< cache_stats.hits << " hits, "
+			<< cache_stats.misses << " misses, "
+			<< cache_stats.entries << " entries, "
+			<< cache_stats.distances << " distances, "
+			<< cache_stats.evictions << " evictions"
+			<< std::endl;
+	}
+}
+
 class CustomFrontendAction : public clang::ASTFrontendAction
 {
 public:
@@ -52,7 +183,7 @@ public:
 		, StringRef file)
 	{
 		RegisterDeclsWithAstCtx(CI.getASTContext());
-		return llvm::make_unique<gap::CompilationDriver>(CI.getASTContext());
+		return llvm::make_unique<gap::CompilationDriver>(CI.getASTContext(), analysis_options);
 	}
 
 private:
@@ -186,5 +317,38 @@ int main(int argc, const char **argv)
 	clang::tooling::CommonOptionsParser opt_parser(argc, argv, option_category);
 	clang::tooling::ClangTool Tool(opt_parser.getCompilations(), opt_parser.getSourcePathList());
 
-	return Tool.run(clang::tooling::newFrontendActionFactory<CustomFrontendAction>().get());
+	std::unique_ptr<gap::util::ThreadPool> thread_pool;
+	if (dep_threads > 1)
+	{
+		thread_pool.reset(new gap::util::ThreadPool(dep_threads));
+		analysis_options.m_thread_pool = thread_pool.get();
+	}
+
+	/// Dependence tests run as tasks of the pool above, and they can't wait for
+	/// tasks of their own pool, so the enumeration gets a pool of its own
+	std::unique_ptr<gap::util::ThreadPool> enumeration_pool;
+	if (enum_threads > 1)
+	{
+		enumeration_pool.reset(new gap::util::ThreadPool(enum_threads));
+		analysis_options.m_dep_test_options.enumeration_pool = enumeration_pool.get();
+	}
+
+	std::unique_ptr<gap::dep::DependenceCache> dependence_cache;
+	if (dep_cache && dep_cache_capacity > 0)
+	{
+		dependence_cache.reset(new gap::dep::DependenceCache(dep_cache_capacity));
+		analysis_options.m_dependence_cache = dependence_cache.get();
+	}
+	analysis_options.m_query_driven = dep_query;
+	analysis_options.m_uniform_lattice = dep_lattice;
+	analysis_options.m_dump_dep_graph = dep_graph;
+	analysis_options.m_dep_test_options.engine = dep_engine;
+	analysis_options.m_dep_test_options.fourier_options.prune_redundant = fm_prune;
+	analysis_options.m_dep_test_options.fourier_options.exact_redundancy_check = fm_exact_redundancy;
+	if (rational_lazy_normalization)
+		gap::util::SetRationalNormalizationThreshold(gap::util::RATIONAL_LAZY_NORMALIZATION_THRESHOLD);
+
+	int result = Tool.run(clang::tooling::newFrontendActionFactory<CustomFrontendAction>().get());
+	DumpDependenceAnalysisStatistics();
+	return result;
 }
\ No newline at end of file
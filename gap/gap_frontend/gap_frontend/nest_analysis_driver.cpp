@@ -33,7 +33,6 @@
 /// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "nest_analysis_driver.h"
-#include "dependence_mdl.h"
 
 
 namespace gap
@@ -41,11 +40,21 @@ namespace gap
 
 	NestAnalysisDriver::NestAnalysisDriver(
 		clang::ASTContext& ast_ctx
-		, PerfectLoopNest& original_nest)
+		, PerfectLoopNest& original_nest
+		, const AnalysisOptions& options)
 
-		: m_nest_transformer(DependenceMdl(original_nest))
+		: m_dep_mdl(original_nest)
+		, m_dep_graph(m_dep_mdl, options)
+		, m_nest_transformer(m_dep_mdl, m_dep_graph)
 		, m_nest_rewriter(ast_ctx, original_nest, m_nest_transformer)
 	{
+		if (options.m_dump_dep_graph)
+			m_dep_graph.Dump();
+	}
+
+	const DependenceGraph& NestAnalysisDriver::GetDependenceGraph() const
+	{
+		return m_dep_graph;
 	}
 
 	const Transformation& NestAnalysisDriver::GetTransformation() const
@@ -36,6 +36,8 @@
 #define GAP_FRONTEND_NEST_ANALYSIS_DRIVER_H
 
 #include <clang/AST/ASTContext.h>
+#include "dependence_mdl.h"
+#include "dependence_graph.h"
 #include "nest_transformer.h"
 #include "nest_rewriter.h"
 
@@ -47,7 +49,8 @@ namespace gap
 
 	/// Drives the task of nest data dependence analysis and loop transformation.
 	/// For the given perfect loop nest, it builds a dependence model that is used
-	/// to perform dependence analysis that is in turn used for loop transformation.
+	/// to perform dependence analysis. Its results are recorded in the dependence
+	/// graph of the nest, which is in turn used for loop transformation.
 	/// Selected transformation is then used to map the original loop nest to the
 	/// transformed loop nest. All of above happens during the driver's construction
 	/// and exception is thrown in case of failure
@@ -55,10 +58,12 @@ namespace gap
 	{
 	public:
 
-		explicit NestAnalysisDriver(
+		NestAnalysisDriver(
 			clang::ASTContext& ast_ctx
-			, PerfectLoopNest& original_nest);
+			, PerfectLoopNest& original_nest
+			, const AnalysisOptions& options);
 
+		const DependenceGraph& GetDependenceGraph() const;
 		const Transformation& GetTransformation() const;
 		PerfectLoopNest& GetTransformedNest();
 		const PerfectLoopNest& GetTransformedNest() const;
@@ -66,6 +71,8 @@ namespace gap
 
 	private:
 
+		DependenceMdl m_dep_mdl;
+		DependenceGraph m_dep_graph;
 		NestTransformer m_nest_transformer;
 		NestRewriter m_nest_rewriter;
 	};
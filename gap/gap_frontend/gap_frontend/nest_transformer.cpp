@@ -34,12 +34,10 @@
 
 #include "nest_transformer.h"
 #include "dependence_mdl.h"
+#include "dependence_graph.h"
 #include "perfect_loop_nest.h"
-#include <gap_util/dependence_analyser.h>
 #include <iostream>
 #include <exception>
-#include <algorithm>
-#include <iterator>
 
 
 namespace gap
@@ -62,107 +60,10 @@ namespace gap
 			}
 		}
 
-		void ExtractDistancesFromDepInfoVec(
-			std::vector<dep::DependenceInfo>&& dep_info_vec
-			, std::vector<util::IntRowVecType>& distance_vecs)
-		{
-			/// There may be duplicates in distance vectors but don't bother discovering that
-			/// as loop transformation won't be affected by it (there will be more computations
-			/// to perform as distance matrix will be larger than it could be)
-			distance_vecs.reserve(distance_vecs.size() + dep_info_vec.size());
-			std::transform(
-				dep_info_vec.begin()
-				, dep_info_vec.end()
-				, std::back_inserter(distance_vecs)
-				, [](dep::DependenceInfo& dep_info) { return std::move(dep_info.d); });
-		}
-
-		void SelectDependenceAnalyser(
-			const IntMatVecPair& low_bnd
-			, const IntMatVecPair& upp_bnd
-			, const IntMatVecPair& first_arr_sub
-			, const IntMatVecPair& second_arr_sub
-			, std::vector<util::IntRowVecType>& distance_vecs
-			, bool subs_are_in_distinct_stmts
-			, bool is_regular_or_rect_nest)
-		{
-			std::vector<dep::DependenceInfo> dep_info_vec;
-			if (is_regular_or_rect_nest && util::Equal(first_arr_sub.m_mat, second_arr_sub.m_mat))
-				dep::UniformLinearDependenceTest(
-					first_arr_sub.m_mat
-					, first_arr_sub.m_vec
-					, second_arr_sub.m_vec
-					, low_bnd.m_mat
-					, low_bnd.m_vec
-					, upp_bnd.m_vec
-					, dep_info_vec
-					, dep_info_vec
-					, subs_are_in_distinct_stmts);
-			else
-				dep::GeneralLinearDependenceTest(
-					first_arr_sub.m_mat
-					, first_arr_sub.m_vec
-					, second_arr_sub.m_mat
-					, second_arr_sub.m_vec
-					, low_bnd.m_mat
-					, low_bnd.m_vec
-					, upp_bnd.m_mat
-					, upp_bnd.m_vec
-					, dep_info_vec
-					, dep_info_vec
-					, subs_are_in_distinct_stmts);
-
-			ExtractDistancesFromDepInfoVec(std::move(dep_info_vec), distance_vecs);
-		}
-
-		void RunDependenceAnalyser(
-			const DependenceMdl& dep_mdl
-			, std::vector<util::IntRowVecType>& distance_vecs)
-		{
-			/// Each LHS array sub of each assign stmt has to be checked against each LHS
-			/// array sub of other assign stmts (excluding its own stmt) as well as against
-			/// RHS array subs in all assign stmts (including its own stmt)
-			bool is_regular_or_rect_nest(
-				util::Equal(dep_mdl.GetLowerBnd().m_mat, dep_mdl.GetUpperBnd().m_mat));
-
-			for (auto & curr_assign_stmt : dep_mdl.GetAssignStmts())
-			{
-				if (curr_assign_stmt.GetLhs() == nullptr)
-					continue;
-
-				const VarDeclMatVecPair& lhs_arr_sub = *curr_assign_stmt.GetLhs();
-				for (auto & other_assign_stmt : dep_mdl.GetAssignStmts())
-				{
-					if (&curr_assign_stmt != &other_assign_stmt
-						&& other_assign_stmt.GetLhs() != nullptr
-						&& lhs_arr_sub.first == other_assign_stmt.GetLhs()->first)
-						SelectDependenceAnalyser(
-							dep_mdl.GetLowerBnd()
-							, dep_mdl.GetUpperBnd()
-							, lhs_arr_sub.second
-							, other_assign_stmt.GetLhs()->second
-							, distance_vecs
-							, true
-							, is_regular_or_rect_nest);
-
-					for (auto & rhs_arr_sub : other_assign_stmt.GetRhs())
-						if (lhs_arr_sub.first == rhs_arr_sub.first)
-							SelectDependenceAnalyser(
-								dep_mdl.GetLowerBnd()
-								, dep_mdl.GetUpperBnd()
-								, lhs_arr_sub.second
-								, rhs_arr_sub.second
-								, distance_vecs
-								, &curr_assign_stmt != &other_assign_stmt
-								, is_regular_or_rect_nest);
-				}
-			}
-		}
-
 		/// Follows the logic documented in nest_transformer.h
 		Transformation TransformLoopNest(
 			const DependenceMdl& dep_mdl
-			, const std::vector<util::IntRowVecType> distance_vecs
+			, const std::vector<util::IntRowVecType>& distance_vecs
 			, util::IntMatrixType& transform_mat)
 		{
 			std::size_t nest_depth = dep_mdl.GetNest().GetNestDepth();
@@ -204,14 +105,13 @@ namespace gap
 	} /// Anonymous namespace
 
 
-	NestTransformer::NestTransformer(const DependenceMdl& dep_mdl)
+	NestTransformer::NestTransformer(const DependenceMdl& dep_mdl, const DependenceGraph& dep_graph)
 		: m_transform_mat(0, 0)
 	{
-		RunDependenceAnalyser(dep_mdl, m_distance_vecs);
-		/*for (auto & distance : m_distance_vecs)
+		/*for (auto & distance : dep_graph.GetDistanceVecs())
 			distance.print();*/
 
-		m_transform = TransformLoopNest(dep_mdl, m_distance_vecs, m_transform_mat);
+		m_transform = TransformLoopNest(dep_mdl, dep_graph.GetDistanceVecs(), m_transform_mat);
 		if (m_transform.GetDepFreeLoopsCnt() == 0)
 			throw std::runtime_error(
 				"the nest must have at least two dependence free loops to be "
@@ -242,9 +142,6 @@ namespace gap
 
 	void NestTransformer::Dump() const
 	{
-		/*for (auto & distance : m_distance_vecs)
-			distance.print();*/
-
 		std::cout << "Selected transformation: " << TransformationToStr(m_transform.GetTransformType()) << "\n\n";
 		m_transform_mat.print("transform_mat =");
 		std::cout << "\n";
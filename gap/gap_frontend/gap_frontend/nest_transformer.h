@@ -46,10 +46,12 @@ namespace gap
 
 	/// Forward declaration
 	class DependenceMdl;
+	class DependenceGraph;
 
-	/// Drives the data dependence and loop transformation process. It
-	/// encapsulates the logic of best-fit transformation selection and
-	/// produces a unimodular matrix representing the selected transform
+	/// Drives the loop transformation process using the distance vectors
+	/// recorded in the nest's dependence graph. It encapsulates the logic
+	/// of best-fit transformation selection and produces a unimodular
+	/// matrix representing the selected transform
 	/// as well as updated lower and upper nest bounds. Note that lower
 	/// and upper bounds are represented by rational matrix - row vector
 	/// pair. Also note that some loops may have a multiple lower and
@@ -74,7 +76,7 @@ namespace gap
 	{
 	public:
 
-		explicit NestTransformer(const DependenceMdl& dep_mdl);
+		NestTransformer(const DependenceMdl& dep_mdl, const DependenceGraph& dep_graph);
 
 		/// Accessors
 		const util::IntMatrixType& GetTransformMat() const;
@@ -87,7 +89,6 @@ namespace gap
 
 	private:
 
-		std::vector<util::IntRowVecType> m_distance_vecs;
 		util::IntMatrixType m_transform_mat;
 		std::vector<util::Bound> m_lower_bnd;
 		std::vector<util::Bound> m_upper_bnd;
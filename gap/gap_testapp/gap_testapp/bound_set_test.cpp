@@ -0,0 +1,188 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "bound_set_test.h"
+#include <gap_util/bound_set.h>
+#include <gap_util/fourier_elimination.h>
+#include <cassert>
+#include <stdexcept>
+#include <limits>
+#include <vector>
+
+using namespace gap::util;
+
+namespace
+{
+	/** Bounds of the system from the first test case of TestFourierElimination(), without removal of redundant inequalities. */
+	void GetTestBounds(std::vector<Bound>& b, std::vector<Bound>& B)
+	{
+		FourierEliminationOptions options;
+		options.prune_redundant = false;
+		bool has_solution(PerformFourierElimination(MatrixExt<long long>({ { 3, -2, 1, 1, 0, 0 },{ -5, -1, -6, 0, 2, -3 },{ 1, 3, 4, -5, -3, 0 },
+			{ 2, -8, 1, -7, 0, 5 } }), RowVector<long long>({ 6, -10, 100, -30, 10, -100 }), b, B, options));
+		assert(has_solution);
+	}
+
+	/** Exact value of bound function k of variable r of bounds at solution. */
+	Rational<long long> EvaluateExactly(const Bound& bound, uword r, uword k, const RowVector<long long>& solution)
+	{
+		Rational<long long> value(bound.second(k));
+		for (auto i = 0U; i < r; ++i)
+			value += bound.first(i, k) * solution(i);
+		return value;
+	}
+
+	long long Floor(const Rational<long long>& value)
+	{
+		long long q(value.numerator() / value.denominator());
+		return (value.numerator() % value.denominator() != 0 && value.numerator() < 0) ? q - 1 : q;
+	}
+
+	long long Ceil(const Rational<long long>& value)
+	{
+		return -Floor(-1LL * value);
+	}
+
+	/** Checks CeilMax() and FloorMin() of every bounded variable against the exact evaluation of the original bounds. */
+	void CheckEvaluation(const std::vector<Bound>& bounds, const BoundSet& set, const RowVector<long long>& solution)
+	{
+		for (auto r = 0U; r < bounds.size(); ++r)
+		{
+			if (!set.IsBounded(r))
+				continue;
+
+			long long ceil_max(0), floor_min(0);
+			for (auto k = 0U; k < set.NumBounds(r); ++k)
+			{
+				const Rational<long long> value(EvaluateExactly(bounds[r], r, k, solution));
+				ceil_max = k == 0 ? Ceil(value) : std::max(ceil_max, Ceil(value));
+				floor_min = k == 0 ? Floor(value) : std::min(floor_min, Floor(value));
+			}
+			assert(set.CeilMax(r, solution) == ceil_max);
+			assert(set.FloorMin(r, solution) == floor_min);
+		}
+	}
+}
+
+void TestBoundSetConversion()
+{
+	std::vector<Bound> b, B;
+	GetTestBounds(b, B);
+
+	for (const auto & bounds : { b, B })
+	{
+		BoundSet set(bounds);
+		assert(set.NumVariables() == bounds.size());
+		for (auto r = 0U; r < bounds.size(); ++r)
+		{
+			/** Infinite bound (the variable is not bounded from one side) has no bound functions. */
+			const bool is_infinite(bounds[r].second.n_cols == 1 && (bounds[r].second(0) == std::numeric_limits<long long>::min() ||
+				bounds[r].second(0) == std::numeric_limits<long long>::max()));
+			assert(set.IsBounded(r) == !is_infinite && set.NumBounds(r) == (is_infinite ? 0 : bounds[r].second.n_cols));
+			for (auto k = 0U; k < set.NumBounds(r); ++k)
+			{
+				assert(set.Denominator(r, k) > 0);
+				assert(set.Constant(r, k) == bounds[r].second(k));
+				for (auto i = 0U; i < r; ++i)
+					assert(set.Coefficient(r, k, i) == bounds[r].first(i, k));
+			}
+		}
+	}
+
+	// Variable x2 is not bounded from above, so it has no upper bound functions
+	std::vector<Bound> lower, upper;
+	assert(PerformFourierElimination(MatrixExt<long long>({ { -1, 1, 0 },{ 0, 0, -1 } }), RowVector<long long>({ 0, 5, -2 }), lower, upper));
+	BoundSet lower_set(lower), upper_set(upper);
+	assert(lower_set.IsBounded(1) && !upper_set.IsBounded(1) && upper_set.NumBounds(1) == 0);
+	assert(lower_set.CeilMax(1, RowVector<long long>({ 3, 0 })) == 2);
+
+	bool thrown(false);
+	try
+	{
+		upper_set.FloorMin(1, RowVector<long long>({ 3, 0 }));
+	}
+	catch (const std::logic_error&)
+	{
+		thrown = true;
+	}
+	assert(thrown);
+
+	/** The second bound must be a (2 x k) matrix. */
+	thrown = false;
+	try
+	{
+		BoundSet invalid({ b[0], b[0] });
+	}
+	catch (const std::logic_error&)
+	{
+		thrown = true;
+	}
+	assert(thrown);
+
+	assert(BoundSet().NumVariables() == 0);
+}
+
+void TestBoundSetEvaluation()
+{
+	std::vector<Bound> b, B;
+	GetTestBounds(b, B);
+	BoundSet lower(b), upper(B);
+
+	/** Small solutions take the unchecked path, large ones the checked path and the exact (Rational) fallback. */
+	unsigned long long seed(42);
+	for (const long long range : { 20LL, 1LL << 40, 1LL << 56, std::numeric_limits<long long>::max() / 4 })
+	{
+		for (auto n = 0; n < 200; ++n)
+		{
+			RowVector<long long> solution(b.size());
+			for (auto i = solution.begin(); i != solution.end(); ++i)
+			{
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				*i = static_cast<long long>((seed >> 1) % static_cast<unsigned long long>(2 * range + 1)) - range;
+			}
+
+			try
+			{
+				CheckEvaluation(b, lower, solution);
+				CheckEvaluation(B, upper, solution);
+			}
+			catch (const std::overflow_error&)
+			{
+				/** The reference evaluation itself can overflow for the largest solutions. */
+				assert(range > (1LL << 40));
+			}
+		}
+	}
+}
@@ -34,18 +34,67 @@
 
 #include "dependence_analyser_test.h"
 #include <gap_util/dependence_analyser.h>
+#include <gap_util/dependence_cache.h>
+#include <gap_util/distance_set.h>
 #include <gap_util/fourier_elimination.h>
 #include <gap_transform/unimodular_transform.h>
 #include <gap_util/row_vector.h>
+#include <gap_util/thread_pool.h>
 #include <cassert>
 #include <vector>
 #include <unordered_set>
+#include <set>
+#include <algorithm>
+#include <stdexcept>
 #include "test_utils.h"
 
 using namespace gap::util;
 using namespace gap::dep;
 using namespace gap::tran;
 
+/** Pool the integer solutions of the dependence systems are enumerated on (@see DependenceTestOptions::enumeration_pool). */
+static ThreadPool& GetEnumerationPool()
+{
+	static ThreadPool pool(4);
+	return pool;
+}
+
+static bool EqualDependences(const std::vector<DependenceInfo>& x, const std::vector<DependenceInfo>& y)
+{
+	return x.size() == y.size() && std::equal(x.begin(), x.end(), y.begin(),
+		[](const DependenceInfo& l, const DependenceInfo& r)
+		{
+			return CompareMatrices(l.i, r.i) && CompareMatrices(l.j, r.j) && CompareMatrices(l.d, r.d) && l.lev == r.lev;
+		});
+}
+
+/**
+ * Runs the sink variant of the dependence test (run_test is handed the sink) and checks that it hands over the same distance vectors, in
+ * the same order, as the ones stored in T_on_S and S_on_T. Sink that stops the enumeration has to be called only once.
+ */
+template<typename RunTest>
+static void CheckDependenceSink(RunTest run_test, bool dependence_exists, const std::vector<DependenceInfo>& T_on_S, const std::vector<DependenceInfo>& S_on_T)
+{
+	std::vector<RowVector<long long>> sunk_T_on_S, sunk_S_on_T;
+	assert(run_test(DependenceSink([&](const RowVector<long long>& d, DependenceDirection direction)
+	{
+		(direction == DEPENDENCE_T_ON_S ? sunk_T_on_S : sunk_S_on_T).push_back(d);
+		return true;
+	})) == dependence_exists);
+
+	for (auto * dep_vector : { &T_on_S, &S_on_T })
+	{
+		const std::vector<RowVector<long long>>& sunk(dep_vector == &T_on_S ? sunk_T_on_S : sunk_S_on_T);
+		assert(sunk.size() == dep_vector->size());
+		for (size_t k = 0; k < sunk.size(); ++k)
+			assert(CompareMatrices(sunk[k], (*dep_vector)[k].d));
+	}
+
+	unsigned calls(0);
+	assert(run_test(DependenceSink([&](const RowVector<long long>&, DependenceDirection) { return ++calls == 0; })) == dependence_exists);
+	assert(calls == (dependence_exists ? 1U : 0U));
+}
+
 static void TestGeneralDependenceTestInternal(const MatrixExt<long long>& A,
 	const RowVector<long long>& a0,
 	const MatrixExt<long long>& B,
@@ -59,6 +108,27 @@ static void TestGeneralDependenceTestInternal(const MatrixExt<long long>& A,
 {
 	std::vector<DependenceInfo> T_on_S, S_on_T;
 	assert(GeneralLinearDependenceTest(A, a0, B, b0, P, p0, Q, q0, T_on_S, S_on_T, are_distinct) == dependence_exists);
+
+	/** Omega engine has to find exactly the same dependences. */
+	DependenceTestOptions omega_options;
+	omega_options.engine = ENGINE_OMEGA;
+	std::vector<DependenceInfo> omega_T_on_S, omega_S_on_T;
+	assert(GeneralLinearDependenceTest(A, a0, B, b0, P, p0, Q, q0, omega_T_on_S, omega_S_on_T, are_distinct, omega_options) == dependence_exists);
+	assert(EqualDependences(T_on_S, omega_T_on_S) && EqualDependences(S_on_T, omega_S_on_T));
+
+	/** Enumeration on the pool has to hand over the same dependences in the same order. */
+	DependenceTestOptions pool_options;
+	pool_options.enumeration_pool = &GetEnumerationPool();
+	std::vector<DependenceInfo> pool_T_on_S, pool_S_on_T;
+	assert(GeneralLinearDependenceTest(A, a0, B, b0, P, p0, Q, q0, pool_T_on_S, pool_S_on_T, are_distinct, pool_options) == dependence_exists);
+	assert(EqualDependences(T_on_S, pool_T_on_S) && EqualDependences(S_on_T, pool_S_on_T));
+	CheckDependenceSink([&](const DependenceSink& sink) { return GeneralLinearDependenceTest(A, a0, B, b0, P, p0, Q, q0, sink, are_distinct); },
+		dependence_exists, T_on_S, S_on_T);
+	CheckDependenceSink([&](const DependenceSink& sink) { return GeneralLinearDependenceTest(A, a0, B, b0, P, p0, Q, q0, sink, are_distinct, pool_options); },
+		dependence_exists, T_on_S, S_on_T);
+
+	/** Pre-filter can only prove independence. */
+	assert(PrefilterDependenceTest(A, a0, B, b0, P, p0, Q, q0) == PREFILTER_UNDECIDED || !dependence_exists);
 	dependence_exists ? assert(!T_on_S.empty() || !S_on_T.empty()) : assert(T_on_S.empty() && S_on_T.empty());
 
 	for (auto * dep_vector : { &T_on_S, &S_on_T })
@@ -92,8 +162,124 @@ static void TestUniformLinearDependenceInternal(const MatrixExt<long long>& A,
 {
 	std::vector<DependenceInfo> T_on_S, S_on_T;
 	assert(UniformLinearDependenceTest(A, a0, b0, P, p0, q0, T_on_S, S_on_T, are_distinct) == dependence_exists);
+
+	/** Omega engine has to find exactly the same dependences. */
+	DependenceTestOptions omega_options;
+	omega_options.engine = ENGINE_OMEGA;
+	std::vector<DependenceInfo> omega_T_on_S, omega_S_on_T;
+	assert(UniformLinearDependenceTest(A, a0, b0, P, p0, q0, omega_T_on_S, omega_S_on_T, are_distinct, omega_options) == dependence_exists);
+	assert(EqualDependences(T_on_S, omega_T_on_S) && EqualDependences(S_on_T, omega_S_on_T));
+
+	DependenceTestOptions pool_options;
+	pool_options.enumeration_pool = &GetEnumerationPool();
+	std::vector<DependenceInfo> pool_T_on_S, pool_S_on_T;
+	assert(UniformLinearDependenceTest(A, a0, b0, P, p0, q0, pool_T_on_S, pool_S_on_T, are_distinct, pool_options) == dependence_exists);
+	assert(EqualDependences(T_on_S, pool_T_on_S) && EqualDependences(S_on_T, pool_S_on_T));
+	CheckDependenceSink([&](const DependenceSink& sink) { return UniformLinearDependenceTest(A, a0, b0, P, p0, q0, sink, are_distinct); },
+		dependence_exists, T_on_S, S_on_T);
+	CheckDependenceSink([&](const DependenceSink& sink) { return UniformLinearDependenceTest(A, a0, b0, P, p0, q0, sink, are_distinct, pool_options); },
+		dependence_exists, T_on_S, S_on_T);
 	dependence_exists ? assert(!T_on_S.empty() || !S_on_T.empty()) : assert(T_on_S.empty() && S_on_T.empty());
 
+	/** Symbolic variant has to describe exactly the same set of distance vectors (k = d for T_on_S and k = -d for S_on_T). */
+	DistanceLattice lattice;
+	bool may_depend(UniformLinearDependenceLattice(A, a0, b0, P, p0, q0, lattice, are_distinct));
+	assert(may_depend || !dependence_exists);
+	if (may_depend)
+	{
+		std::vector<RowVector<long long>> lattice_vectors;
+		if (lattice.generators.n_rows == 0)
+		{
+			lattice_vectors.push_back(lattice.base);
+		}
+		else
+		{
+			std::vector<Bound> lower_bound, upper_bound;
+			assert(PerformFourierElimination(lattice.constraints, lattice.constraints_rhs, lower_bound, upper_bound));
+			EnumerateIntegerSolutions(lower_bound, upper_bound, [&](const RowVector<long long>& params)
+			{
+				for (auto l = 0U; l < params.n_cols; ++l)
+					assert(params(l) >= lattice.param_lower(l) && params(l) <= lattice.param_upper(l));
+				lattice_vectors.push_back(lattice.base + params * lattice.generators);
+				return true;
+			});
+		}
+
+		std::set<std::vector<long long>> distances;
+		for (auto & dep_info : T_on_S)
+			distances.insert(std::vector<long long>(dep_info.d.begin(), dep_info.d.end()));
+		for (auto & dep_info : S_on_T)
+			distances.insert(std::vector<long long>(dep_info.d.begin(), dep_info.d.end()));
+
+		size_t num_distances(0);
+		for (auto & k : lattice_vectors)
+		{
+			for (auto l = 0U; l < k.n_cols; ++l)
+			{
+				assert(k(l) >= lattice.dist_lower(l) && k(l) <= lattice.dist_upper(l));
+				assert(lattice.Directions(l) & (k(l) < 0 ? DistanceLattice::Negative : k(l) > 0 ? DistanceLattice::Positive : DistanceLattice::Zero));
+			}
+
+			if (!are_distinct && std::all_of(k.begin(), k.end(), [](long long value) { return value == 0; }))
+				continue;
+
+			RowVector<long long> d(RowVector<long long>::CompareLexicographically(k, RowVector<long long>(k.n_cols)) == RowVector<long long>::RightGreater ?
+				-1LL * k : k);
+			assert(distances.count(std::vector<long long>(d.begin(), d.end())) == 1);
+			++num_distances;
+		}
+		assert(num_distances == T_on_S.size() + S_on_T.size());
+
+		/** Factorization shared with the other tests of the same subscript must give the same lattice. */
+		const DependenceSystemFactorization factorization(A, A, SYSTEM_UNIFORM);
+		DistanceLattice shared_lattice;
+		assert(UniformLinearDependenceLattice(A, a0, b0, P, p0, q0, shared_lattice, are_distinct, &factorization));
+		assert(CompareMatrices(lattice.base, shared_lattice.base) && CompareMatrices(lattice.dist_lower, shared_lattice.dist_lower) &&
+			CompareMatrices(lattice.dist_upper, shared_lattice.dist_upper));
+
+		/** Summaries must admit the level of every distance: T_on_S distances are positive vectors of the lattice, S_on_T of the negated one. */
+		const DistanceLattice negated(lattice.Negated());
+		for (auto & dep_info : T_on_S)
+			assert(lattice.MayHaveLevel(dep_info.d.GetLevel()));
+		for (auto & dep_info : S_on_T)
+			assert(negated.MayHaveLevel(dep_info.d.GetLevel()));
+
+		/**
+		 * Vectors inserted from the lattice and its negation must be exactly the non-zero distances, so that the transformations calculated
+		 * from the reduced sets are the same as in the exact mode.
+		 */
+		DistanceSet exact_all(P.n_rows, false), lattice_all(P.n_rows, false), exact_reduced(P.n_rows), lattice_reduced(P.n_rows);
+		size_t num_exact(0);
+		for (auto dep_vector : { &T_on_S, &S_on_T })
+			for (auto & dep_info : *dep_vector)
+				if (dep_info.d.GetLevel() < P.n_rows)
+				{
+					exact_all.Insert(dep_info.d);
+					exact_reduced.Insert(dep_info.d);
+					++num_exact;
+				}
+
+		size_t num_inserted(InsertLatticeDistances(lattice, lattice_all) + InsertLatticeDistances(negated, lattice_all));
+		InsertLatticeDistances(lattice, lattice_reduced);
+		InsertLatticeDistances(negated, lattice_reduced);
+		assert(num_inserted == num_exact);
+
+		std::vector<RowVector<long long>> exact_vectors(exact_all.ToVectors()), lattice_vectors_all(lattice_all.ToVectors());
+		assert(exact_vectors.size() == lattice_vectors_all.size());
+		for (size_t k = 0; k < exact_vectors.size(); ++k)
+			assert(CompareMatrices(exact_vectors[k], lattice_vectors_all[k]));
+		assert(exact_reduced.Rank() == lattice_reduced.Rank());
+
+		if (exact_reduced.Size() > 0 && P.n_rows > 1)
+		{
+			MatrixExt<long long> exact_U(0, 0), lattice_U(0, 0);
+			assert(FindInnerLoopTransformMatrix(exact_reduced.ToVectors(), exact_U) == FindInnerLoopTransformMatrix(lattice_reduced.ToVectors(), lattice_U));
+			assert(CompareMatrices(exact_U, lattice_U));
+			assert(FindOuterLoopTransformMatrix(exact_reduced.ToVectors(), exact_U) == FindOuterLoopTransformMatrix(lattice_reduced.ToVectors(), lattice_U));
+			assert(CompareMatrices(exact_U, lattice_U));
+		}
+	}
+
 	/**
 	* Uniform linear dependence test doesn't give us vectors i and j but only uniform dependence distance vector that can correspond to
 	* many (i,j) pairs. Generate all possible loop vectors I (this might be very inefficient for big loop nests) and check if distance
@@ -265,6 +451,149 @@ void TestGeneralLinearDependenceTest()
 	*/
 }
 
+static void TestPrefilterDependenceTestInternal(const MatrixExt<long long>& A,
+	const RowVector<long long>& a0,
+	const MatrixExt<long long>& B,
+	const RowVector<long long>& b0,
+	const MatrixExt<long long>& P,
+	const RowVector<long long>& p0,
+	const MatrixExt<long long>& Q,
+	const RowVector<long long>& q0,
+	PrefilterTier expected_tier)
+{
+	PrefilterStatistics stats_before(GetPrefilterStatistics());
+	assert(PrefilterDependenceTest(A, a0, B, b0, P, p0, Q, q0) == expected_tier);
+	assert(GetPrefilterStatistics().hits[expected_tier] == stats_before.hits[expected_tier] + 1);
+
+	/** Every decision of the pre-filter has to be confirmed by the exact test. */
+	std::vector<DependenceInfo> T_on_S, S_on_T;
+	if (expected_tier != PREFILTER_UNDECIDED)
+		assert(!GeneralLinearDependenceTest(A, a0, B, b0, P, p0, Q, q0, T_on_S, S_on_T));
+}
+
+void TestPrefilterDependenceTest()
+{
+	// Test case 1 (ZIV)
+	TestPrefilterDependenceTestInternal(
+	{ { 0 },{ 0 } },
+	{ 1 },
+	{ { 0 },{ 0 } },
+	{ 2 },
+	{ { 1, 0 },{ 0, 1 } },
+	{ 0, 0 },
+	{ { 1, 0 },{ 0, 1 } },
+	{ 10, 10 },
+		PREFILTER_ZIV);
+
+	// Test case 2 (GCD)
+	TestPrefilterDependenceTestInternal(
+	{ { 2, 1 },{ 4, 0 } },
+	{ 0, 0 },
+	{ { 6, 1 },{ 2, 0 } },
+	{ 1, 0 },
+	{ { 1, 0 },{ 0, 1 } },
+	{ 0, 0 },
+	{ { 1, 0 },{ 0, 1 } },
+	{ 10, 10 },
+		PREFILTER_GCD);
+
+	// Test case 3 (strong SIV)
+	TestPrefilterDependenceTestInternal(
+	{ { 1 } },
+	{ 0 },
+	{ { 1 } },
+	{ -50 },
+	{ { 1 } },
+	{ 0 },
+	{ { 1 } },
+	{ 10 },
+		PREFILTER_SIV);
+
+	// Test case 4 (weak zero SIV)
+	TestPrefilterDependenceTestInternal(
+	{ { 0 },{ 2 } },
+	{ 0 },
+	{ { 0 },{ 0 } },
+	{ 40 },
+	{ { 1, -1 },{ 0, 1 } },
+	{ 0, 0 },
+	{ { 1, -1 },{ 0, 1 } },
+	{ 10, 5 },
+		PREFILTER_SIV);
+
+	// Test case 5 (Banerjee)
+	TestPrefilterDependenceTestInternal(
+	{ { 1 },{ 1 } },
+	{ 0 },
+	{ { 1 },{ 1 } },
+	{ 100 },
+	{ { 1, -1 },{ 0, 1 } },
+	{ 0, 0 },
+	{ { 1, 0 },{ 0, 1 } },
+	{ 10, 10 },
+		PREFILTER_BANERJEE);
+
+	// Test case 6 (undecided, dependence exists)
+	TestPrefilterDependenceTestInternal(
+	{ { 2, 1 } },
+	{ -2, 3 },
+	{ { -1, 2 } },
+	{ 300, 9 },
+	{ { 1 } },
+	{ 10 },
+	{ { 1 } },
+	{ 200 },
+		PREFILTER_UNDECIDED);
+
+	// Test case 7 (undecided, bounds of the outer loop depend on the inner one)
+	TestPrefilterDependenceTestInternal(
+	{ { 1 },{ 1 } },
+	{ 0 },
+	{ { 1 },{ 1 } },
+	{ 100 },
+	{ { 1, 0 },{ -1, 1 } },
+	{ 0, 0 },
+	{ { 1, 0 },{ 0, 1 } },
+	{ 10, 10 },
+		PREFILTER_UNDECIDED);
+
+	// Test case 8 (undecided, the Banerjee bounds overflow; wrapped around, they would exclude the dependence at i = j)
+	TestPrefilterDependenceTestInternal(
+	{ { 3 } },
+	{ 0 },
+	{ { 3 } },
+	{ 0 },
+	{ { 1 } },
+	{ 0 },
+	{ { 1 } },
+	{ 4000000000000000000LL },
+		PREFILTER_UNDECIDED);
+
+	// Test case 9 (undecided, the range of the inner loop overflows)
+	TestPrefilterDependenceTestInternal(
+	{ { 0 },{ 1 } },
+	{ 0 },
+	{ { 0 },{ 1 } },
+	{ 1 },
+	{ { 1, -4 },{ 0, 1 } },
+	{ 0, 0 },
+	{ { 1, -4 },{ 0, 1 } },
+	{ 4000000000000000000LL, 10 },
+		PREFILTER_UNDECIDED);
+
+	// Test case 10 (empty nest, the upper bound of the inner loop is below its lower bound)
+	TestPrefilterDependenceTestInternal(
+	{ { 1 },{ 1 } },
+	{ 0 },
+	{ { 1 },{ 1 } },
+	{ 0 },
+	{ { 1, 0 },{ 0, 1 } },
+	{ 0, 5 },
+	{ { 1, 0 },{ 0, 1 } },
+	{ 10, 4 },
+		PREFILTER_EMPTY_NEST);
+}
+
 void TestUniformLinearDependenceTest()
 {
 	// Test case 1 (dependence exists)
@@ -303,6 +632,309 @@ void TestUniformLinearDependenceTest()
 	{ 0, 0 },
 	{ 100, 200 },
 		false);
+
+	// Test case 5 (dependence exists, distances (1,-1) and (2,-2) of rank 1)
+	TestUniformLinearDependenceInternal(
+	{ { 1 },{ 1 } },
+	{ 0 },
+	{ 0 },
+	{ { 1, 0 },{ 0, 1 } },
+	{ 0, 0 },
+	{ 2, 2 });
+}
+
+/** Distinct dependences handed to the sink by run_test, each as its set followed by distance vector, in the order of first appearance. */
+template<typename RunTest>
+static std::vector<std::vector<long long>> CollectDistinctDependences(RunTest run_test, bool& has_dependence)
+{
+	std::vector<std::vector<long long>> dependences;
+	has_dependence = run_test(DependenceSink([&](const RowVector<long long>& d, DependenceDirection direction)
+	{
+		std::vector<long long> dependence(1, static_cast<long long>(direction));
+		dependence.insert(dependence.end(), d.begin(), d.end());
+		if (std::find(dependences.begin(), dependences.end(), dependence) == dependences.end())
+			dependences.push_back(dependence);
+		return true;
+	}));
+	return dependences;
+}
+
+void TestDependenceCache()
+{
+	DependenceCache cache;
+	MatrixExt<long long> A({ { 2, 1 } }), B({ { -1, 2 } }), P({ { 1 } });
+	RowVector<long long> a0({ -2, 3 }), b0({ 300, 9 }), p0({ 10 }), q0({ 200 });
+	bool result, cached_result;
+
+	/** First lookup has to run the test and produce exactly the same distinct dependences. */
+	auto dependences = CollectDistinctDependences([&](const DependenceSink& sink)
+		{ return GeneralLinearDependenceTest(A, a0, B, b0, P, p0, P, q0, sink); }, result);
+	auto cached = CollectDistinctDependences([&](const DependenceSink& sink)
+		{ return cache.GeneralLinearDependenceTest(A, a0, B, b0, P, p0, P, q0, sink); }, cached_result);
+	assert(result && cached_result == result && cached == dependences);
+	assert(cache.GetStatistics().hits == 0 && cache.GetStatistics().misses == 1);
+	assert(cache.GetStatistics().distances == dependences.size());
+
+	/** Both offsets translated by the same constant are the same system, so this must be a hit. */
+	RowVector<long long> offset({ 7, -4 });
+	cached = CollectDistinctDependences([&](const DependenceSink& sink)
+		{ return cache.GeneralLinearDependenceTest(A, a0 + offset, B, b0 + offset, P, p0, P, q0, sink); }, cached_result);
+	assert(cached_result == result && cached == dependences);
+	assert(cache.GetStatistics().hits == 1 && cache.GetStatistics().entries == 1);
+
+	/** Different difference b0 - a0 or are_distinct flag must not be answered from the cache. */
+	cache.GeneralLinearDependenceTest(A, a0, B, b0 + offset, P, p0, P, q0, [](const RowVector<long long>&, DependenceDirection) { return true; });
+	cache.GeneralLinearDependenceTest(A, a0, B, b0, P, p0, P, q0, [](const RowVector<long long>&, DependenceDirection) { return true; }, false);
+	assert(cache.GetStatistics().hits == 1 && cache.GetStatistics().misses == 3);
+
+	/** Uniform test depends only on a0 - b0 and q0 - p0. */
+	MatrixExt<long long> UA({ { 2, 3 },{ 3, 4 } }), UP({ { 1, 0 },{ 0, 1 } });
+	RowVector<long long> ua0({ -2, 1 }), ub0({ 1, 3 }), up0({ 1, 71 }), uq0({ 1000, 300 }), shift({ 5, -9 });
+	auto uniform_dependences = CollectDistinctDependences([&](const DependenceSink& sink)
+		{ return UniformLinearDependenceTest(UA, ua0, ub0, UP, up0, uq0, sink); }, result);
+
+	for (auto i = 0LL; i < 2; ++i)
+	{
+		cached = CollectDistinctDependences([&](const DependenceSink& sink)
+		{
+			return cache.UniformLinearDependenceTest(UA, ua0 + i * shift, ub0 + i * shift, UP, up0 - i * shift, uq0 - i * shift, sink);
+		}, cached_result);
+		assert(cached_result == result && cached == uniform_dependences);
+	}
+	assert(cache.GetStatistics().hits == 2 && cache.GetStatistics().misses == 4);
+
+	cache.Clear();
+	assert(cache.GetStatistics().entries == 0 && cache.GetStatistics().hits == 0 && cache.GetStatistics().distances == 0);
+
+	/** Results of the tests whose sink has stopped the enumeration are incomplete, so they are not stored. */
+	cache.GeneralLinearDependenceTest(A, a0, B, b0, P, p0, P, q0, [](const RowVector<long long>&, DependenceDirection) { return false; });
+	assert(cache.GetStatistics().entries == 0);
+
+	/** Storing the uniform result into the cache that holds just as many distances evicts the general one. */
+	DependenceCache bounded(std::max(dependences.size(), uniform_dependences.size()));
+	auto ignore = [](const RowVector<long long>&, DependenceDirection) { return true; };
+	bounded.GeneralLinearDependenceTest(A, a0, B, b0, P, p0, P, q0, ignore);
+	bounded.UniformLinearDependenceTest(UA, ua0, ub0, UP, up0, uq0, ignore);
+	assert(bounded.GetStatistics().entries == 1 && bounded.GetStatistics().evictions == 1);
+	assert(bounded.GetStatistics().distances == uniform_dependences.size());
+	bounded.UniformLinearDependenceTest(UA, ua0, ub0, UP, up0, uq0, ignore);
+	bounded.GeneralLinearDependenceTest(A, a0, B, b0, P, p0, P, q0, ignore);
+	assert(bounded.GetStatistics().hits == 1 && bounded.GetStatistics().misses == 3);
+
+	/** Results larger than the capacity are never stored. */
+	DependenceCache tiny(1);
+	tiny.UniformLinearDependenceTest(UA, ua0, ub0, UP, up0, uq0, ignore);
+	assert(uniform_dependences.size() < 2 || tiny.GetStatistics().entries == 0);
+
+	bool thrown(false);
+	try
+	{
+		DependenceCache empty(0);
+	}
+	catch (const std::logic_error&)
+	{
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+/**
+ * Dependences of the pair with roles exchanged, each as its set (T on S is 0) followed by d, i and j. Loop index instances of the swapped
+ * pair are exchanged back and so is its set, except for i == j that is always part of T on S (it leads to dependence only when the
+ * statements are distinct, and then in both orders).
+ */
+static std::vector<std::vector<long long>> DependenceRecords(
+	const std::vector<DependenceInfo>& T_on_S,
+	const std::vector<DependenceInfo>& S_on_T,
+	bool swapped)
+{
+	std::vector<std::vector<long long>> records;
+	for (auto * dep_vector : { &T_on_S, &S_on_T })
+	{
+		for (auto & dep_info : *dep_vector)
+		{
+			const bool is_zero(std::all_of(dep_info.d.begin(), dep_info.d.end(), [](long long value) { return value == 0; }));
+			const bool is_T_on_S(dep_vector == &T_on_S);
+			std::vector<long long> record(1, is_T_on_S != (swapped && !is_zero) ? 0 : 1);
+			record.insert(record.end(), dep_info.d.begin(), dep_info.d.end());
+			record.insert(record.end(), (swapped ? dep_info.j : dep_info.i).begin(), (swapped ? dep_info.j : dep_info.i).end());
+			record.insert(record.end(), (swapped ? dep_info.i : dep_info.j).begin(), (swapped ? dep_info.i : dep_info.j).end());
+			records.push_back(record);
+		}
+	}
+	std::sort(records.begin(), records.end());
+	return records;
+}
+
+/**
+ * Testing X(iA + a0) of S against X(jB + b0) of T has to give the same dependences as testing X(jB + b0) against X(iA + a0), with the
+ * roles of S and T exchanged (DependenceGraph tests only one of the two orders and exchanges the roles itself).
+ */
+static void TestSwappedSubscriptsInternal(const MatrixExt<long long>& A,
+	const RowVector<long long>& a0,
+	const MatrixExt<long long>& B,
+	const RowVector<long long>& b0,
+	const MatrixExt<long long>& P,
+	const RowVector<long long>& p0,
+	const MatrixExt<long long>& Q,
+	const RowVector<long long>& q0)
+{
+	for (bool are_distinct : { true, false })
+	{
+		std::vector<DependenceInfo> T_on_S, S_on_T, swapped_T_on_S, swapped_S_on_T;
+		bool result(GeneralLinearDependenceTest(A, a0, B, b0, P, p0, Q, q0, T_on_S, S_on_T, are_distinct));
+		assert(GeneralLinearDependenceTest(B, b0, A, a0, P, p0, Q, q0, swapped_T_on_S, swapped_S_on_T, are_distinct) == result);
+		assert(DependenceRecords(T_on_S, S_on_T, false) == DependenceRecords(swapped_T_on_S, swapped_S_on_T, true));
+
+		/** Uniform test applies only when A = B and P = Q. */
+		if (A.n_cols != B.n_cols || !CompareMatrices(A, B) || !CompareMatrices(P, Q))
+			continue;
+
+		T_on_S.clear();
+		S_on_T.clear();
+		swapped_T_on_S.clear();
+		swapped_S_on_T.clear();
+		result = UniformLinearDependenceTest(A, a0, b0, P, p0, q0, T_on_S, S_on_T, are_distinct);
+		assert(UniformLinearDependenceTest(A, b0, a0, P, p0, q0, swapped_T_on_S, swapped_S_on_T, are_distinct) == result);
+		assert(DependenceRecords(T_on_S, S_on_T, false) == DependenceRecords(swapped_T_on_S, swapped_S_on_T, true));
+	}
+}
+
+void TestSwappedSubscripts()
+{
+	/** X(I1 + I2) and X(I1 + I2 + c) in a square nest: uniform, with and without zero distance. */
+	for (long long c : { 0LL, 1LL, -2LL })
+	{
+		TestSwappedSubscriptsInternal(
+			{ { 1 },{ 1 } }, { 0 },
+			{ { 1 },{ 1 } }, { c },
+			{ { 1, 0 },{ 0, 1 } }, { 1, 1 },
+			{ { 1, 0 },{ 0, 1 } }, { 5, 5 });
+	}
+
+	/** X(I1 + 2 * I2) and X(2 * I1 + I2) in a triangular nest (I2 <= I1), i == j for every I1 == I2. */
+	TestSwappedSubscriptsInternal(
+		{ { 1 },{ 2 } }, { 0 },
+		{ { 2 },{ 1 } }, { 0 },
+		{ { 1, 0 },{ 0, 1 } }, { 1, 1 },
+		{ { 1, -1 },{ 0, 1 } }, { 6, 0 });
+
+	/** X(2 * I1 - 2, I1 + 3) and X(-I1 + 300, 2 * I1 + 9). */
+	TestSwappedSubscriptsInternal(
+		{ { 2, 1 } }, { -2, 3 },
+		{ { -1, 2 } }, { 300, 9 },
+		{ { 1 } }, { 10 },
+		{ { 1 } }, { 200 });
+
+	/** X(2 * I1 + 3 * I2, 3 * I1 + 4 * I2) with offsets that differ, in a rectangular nest. */
+	TestSwappedSubscriptsInternal(
+		{ { 2, 3 },{ 3, 4 } }, { -2, 1 },
+		{ { 2, 3 },{ 3, 4 } }, { 1, 3 },
+		{ { 1, 0 },{ 0, 1 } }, { 1, 1 },
+		{ { 1, 0 },{ 0, 1 } }, { 30, 20 });
+}
+
+void TestClassifyDependence()
+{
+	/** Loop carried dependence goes from the earlier iteration, regardless of the order of statements in the loop body. */
+	DependenceClass dep_class(ClassifyDependence(RowVector<long long>({ 0, 2, -1 }), true, false, true, false));
+	assert(dep_class.first_is_src && dep_class.kind == DEPENDENCE_FLOW && dep_class.level == 1);
+	dep_class = ClassifyDependence(RowVector<long long>({ 1, -3, 0 }), false, true, true, false);
+	assert(!dep_class.first_is_src && dep_class.kind == DEPENDENCE_ANTI && dep_class.level == 0);
+	dep_class = ClassifyDependence(RowVector<long long>({ 0, 0, 4 }), false, true, true, true);
+	assert(!dep_class.first_is_src && dep_class.kind == DEPENDENCE_OUTPUT && dep_class.level == 2);
+
+	/** Loop independent dependence goes from the statement that comes first, and its level is the nest depth. */
+	dep_class = ClassifyDependence(RowVector<long long>({ 0, 0, 0 }), false, true, true, false);
+	assert(dep_class.first_is_src && dep_class.kind == DEPENDENCE_FLOW && dep_class.level == 3);
+	dep_class = ClassifyDependence(RowVector<long long>({ 0, 0, 0 }), true, false, true, false);
+	assert(!dep_class.first_is_src && dep_class.kind == DEPENDENCE_ANTI && dep_class.level == 3);
+	dep_class = ClassifyDependence(RowVector<long long>({ 0, 0, 0 }), true, false, false, true);
+	assert(!dep_class.first_is_src && dep_class.kind == DEPENDENCE_FLOW && dep_class.level == 3);
+
+	/**
+	 * DO I = 1, 100
+	 *   S: X(I) = ...
+	 *   T: ... = X(I + c)
+	 *
+	 * With c = -1, T reads the element written by S one iteration earlier (flow dependence of T on S). With c = 1, T reads the element
+	 * before S writes it one iteration later (anti dependence of S on T). Both are carried by I.
+	 */
+	MatrixExt<long long> A({ { 1 } }), P({ { 1 } });
+	RowVector<long long> a0({ 0 }), p0({ 1 }), q0({ 100 });
+	for (long long c : { -1LL, 1LL })
+	{
+		unsigned dep_cnt(0);
+		assert(UniformLinearDependenceTest(A, a0, RowVector<long long>({ c }), P, p0, q0, [&](const RowVector<long long>& d, DependenceDirection direction)
+		{
+			/** S (first) writes, T (second) reads and S precedes T in the loop body. */
+			DependenceClass dep_class(ClassifyDependence(d, direction == DEPENDENCE_T_ON_S, true, true, false));
+			assert(d(0) == 1 && dep_class.level == 0);
+			assert(c < 0 ? dep_class.first_is_src && dep_class.kind == DEPENDENCE_FLOW : !dep_class.first_is_src && dep_class.kind == DEPENDENCE_ANTI);
+			++dep_cnt;
+			return true;
+		}));
+		assert(dep_cnt == 1);
+	}
+}
+
+void TestDependenceSystemFactorization()
+{
+	/** Pairs of variables that differ only in constant offsets share single factorization and get the same dependences. */
+	MatrixExt<long long> A({ { 2, 1 } }), B({ { -1, 2 } }), P({ { 1 } });
+	RowVector<long long> a0({ -2, 3 }), p0({ 10 }), q0({ 200 });
+	const std::vector<RowVector<long long>> b0s{ { 300, 9 },{ 307, 5 },{ 0, 0 },{ 41, -17 } };
+
+	const DependenceSystemFactorization general(A, B, SYSTEM_GENERAL);
+	assert(general.IsSmall());
+	for (const auto& b0 : b0s)
+	{
+		std::vector<DependenceInfo> T_on_S, S_on_T, shared_T_on_S, shared_S_on_T;
+		const bool result(GeneralLinearDependenceTest(A, a0, B, b0, P, p0, P, q0, T_on_S, S_on_T));
+		assert(GeneralLinearDependenceTest(A, a0, B, b0, P, p0, P, q0, shared_T_on_S, shared_S_on_T, true, DependenceTestOptions(),
+			&general) == result);
+		assert(EqualDependences(T_on_S, shared_T_on_S) && EqualDependences(S_on_T, shared_S_on_T));
+	}
+
+	MatrixExt<long long> UA({ { 2, 3 },{ 3, 4 } }), UP({ { 1, 0 },{ 0, 1 } });
+	RowVector<long long> ua0({ -2, 1 }), up0({ 1, 71 }), uq0({ 1000, 300 });
+	const std::vector<RowVector<long long>> ub0s{ { 1, 3 },{ -2, 1 },{ 50, -7 } };
+
+	const DependenceSystemFactorization uniform(UA, UA, SYSTEM_UNIFORM);
+	for (const auto& ub0 : ub0s)
+	{
+		std::vector<DependenceInfo> T_on_S, S_on_T, shared_T_on_S, shared_S_on_T;
+		const bool result(UniformLinearDependenceTest(UA, ua0, ub0, UP, up0, uq0, T_on_S, S_on_T, false));
+		assert(UniformLinearDependenceTest(UA, ua0, ub0, UP, up0, uq0, shared_T_on_S, shared_S_on_T, false, DependenceTestOptions(),
+			&uniform) == result);
+		assert(EqualDependences(T_on_S, shared_T_on_S) && EqualDependences(S_on_T, shared_S_on_T));
+	}
+
+	/** Factorization of a different kind or shape must be rejected. */
+	bool thrown(false);
+	try
+	{
+		std::vector<DependenceInfo> T_on_S, S_on_T;
+		GeneralLinearDependenceTest(UA, ua0, UA, ub0s[0], UP, up0, UP, uq0, T_on_S, S_on_T, true, DependenceTestOptions(), &uniform);
+	}
+	catch (const std::logic_error&)
+	{
+		thrown = true;
+	}
+	assert(thrown);
+
+	const DependenceSystemFactorization other_shape(A, A, SYSTEM_UNIFORM);
+	thrown = false;
+	try
+	{
+		std::vector<DependenceInfo> T_on_S, S_on_T;
+		UniformLinearDependenceTest(UA, ua0, ub0s[0], UP, up0, uq0, T_on_S, S_on_T, true, DependenceTestOptions(), &other_shape);
+	}
+	catch (const std::logic_error&)
+	{
+		thrown = true;
+	}
+	assert(thrown);
 }
 
 void ThesisInitialProgram()
@@ -45,9 +45,19 @@ void ThesisMRI_Q_Computation();
 
 void TestGeneralLinearDependenceTest();
 void TestUniformLinearDependenceTest();
+void TestPrefilterDependenceTest();
+void TestDependenceCache();
+void TestDependenceSystemFactorization();
+void TestSwappedSubscripts();
+void TestClassifyDependence();
 
 #define RUN_DEPENDENCE_ANALYSER_TESTS() \
 	TestGeneralLinearDependenceTest(); \
-	TestUniformLinearDependenceTest();
+	TestUniformLinearDependenceTest(); \
+	TestPrefilterDependenceTest(); \
+	TestDependenceCache(); \
+	TestDependenceSystemFactorization(); \
+	TestSwappedSubscripts(); \
+	TestClassifyDependence();
 
 #endif /// GAP_TESTAPP_DEPENDENCE_ANALYSER_TEST_H
\ No newline at end of file
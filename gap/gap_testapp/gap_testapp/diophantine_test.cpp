@@ -38,6 +38,7 @@
 #include <gap_util/row_vector.h>
 #include <cassert>
 #include <string>
+#include <vector>
 
 using namespace arma;
 using namespace gap::util;
@@ -92,6 +93,13 @@ static void TestSolveDiophantineSystemInternal(const MatrixExt<long long>& A, co
 				assert(!"Valid solution vector t doesn't satisfy one of the equations");
 		}
 	}
+
+	// Echelon reduction based on Hermite Normal Form has to give the same answer and a valid solution
+	MatrixExt<long long> U_hermite(A.n_rows, A.n_rows);
+	RowVector<long long> t_hermite(A.n_rows);
+	uword rank_hermite(0);
+	assert(SolveDiophantineSystem(A, c, U_hermite, t_hermite, rank_hermite, ECHELON_HERMITE) == has_solution);
+	assert(!has_solution || (rank_hermite == rank_s && CompareMatrices(t_hermite * U_hermite * A, c)));
 }
 
 void TestSolveDiophantineEquation()
@@ -135,3 +143,49 @@ void TestSolveDiophantineSystem()
 	{ -2, 2, 1, -2 },
 		true);
 }
+
+void TestSolveFactoredDiophantineSystems()
+{
+	const MatrixExt<long long> A({ { 2, 1, 0 },{ 6, 3, -2 },{ 4, 0, 3 },{ -2, 5, -1 } });
+	const std::vector<RowVector<long long>> c{ { 4, 2, 8 },{ 1, 0, 0 },{ 0, 0, 0 },{ -6, 7, 3 },{ 3, 1, 2 } };
+
+	DiophantineFactorization<MatrixExt<long long>> factorization;
+	FactorDiophantineSystem(A, factorization);
+
+	std::vector<RowVector<long long>> t;
+	std::vector<bool> has_solution;
+	std::size_t num_solved(SolveFactoredDiophantineSystems(factorization, c, t, has_solution));
+	assert(t.size() == c.size() && has_solution.size() == c.size());
+
+	/** Every right-hand side of the batch must give the same answer as solving the system from scratch. */
+	std::size_t expected_solved(0);
+	for (auto k = 0U; k < c.size(); ++k)
+	{
+		MatrixExt<long long> U(A.n_rows, A.n_rows);
+		RowVector<long long> single_t(A.n_rows);
+		uword rank_s(0);
+		const bool result(SolveDiophantineSystem(A, c[k], U, single_t, rank_s));
+
+		assert(result == has_solution[k]);
+		assert(rank_s == factorization.rank_s && CompareMatrices(U, factorization.U));
+		if (result)
+		{
+			++expected_solved;
+			assert(CompareMatrices(single_t, t[k]));
+			assert(CompareMatrices(t[k] * factorization.U * A, c[k]));
+		}
+	}
+	assert(num_solved == expected_solved);
+
+	/** Same factorization on matrices with inline storage. */
+	DiophantineFactorization<SmallMatrix<long long>> small_factorization;
+	FactorDiophantineSystem(SmallMatrix<long long>(A), small_factorization);
+	assert(small_factorization.rank_s == factorization.rank_s);
+	for (auto k = 0U; k < c.size(); ++k)
+	{
+		SmallRowVector<long long> small_t;
+		assert(SolveFactoredDiophantineSystem(small_factorization, SmallRowVector<long long>(c[k]), small_t) == has_solution[k]);
+		if (has_solution[k])
+			assert(CompareMatrices(small_t.ToRowVector(0, small_t.n_cols), t[k]));
+	}
+}
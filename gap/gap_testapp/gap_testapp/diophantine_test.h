@@ -37,9 +37,11 @@
 
 void TestSolveDiophantineEquation();
 void TestSolveDiophantineSystem();
+void TestSolveFactoredDiophantineSystems();
 
 #define RUN_DIOPHANTINE_TESTS() \
     TestSolveDiophantineEquation(); \
-    TestSolveDiophantineSystem()
+    TestSolveDiophantineSystem(); \
+    TestSolveFactoredDiophantineSystems()
 
 #endif /// GAP_TESTAPP_DIOPHANTINE_TEST_H
@@ -0,0 +1,153 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "distance_query_test.h"
+#include "test_utils.h"
+#include <gap_util/distance_query.h>
+#include <gap_util/dependence_analyser.h>
+#include <gap_transform/unimodular_transform.h>
+#include <cassert>
+#include <stdexcept>
+#include <vector>
+
+using namespace gap::util;
+using namespace gap::dep;
+
+namespace
+{
+	/** Runs the uniform test of X(I1) against X(I1 + offset) in the nest 0 <= I1, I2 <= n, storing the distances or handing them to query. */
+	void UniformTestX(long long offset, long long n, DistanceQuery* query, std::vector<RowVector<long long>>& distances)
+	{
+		const MatrixExt<long long> A({ { 1 },{ 0 } }), P({ { 1, 0 },{ 0, 1 } });
+		const RowVector<long long> a0({ offset }), b0({ 0 }), p0({ 0, 0 }), q0({ n, n });
+
+		DependenceTestOptions options;
+		options.query = query;
+		std::vector<DependenceInfo> T_on_S, S_on_T;
+		assert(UniformLinearDependenceTest(A, a0, b0, P, p0, q0, T_on_S, S_on_T, true, options));
+		assert(query == nullptr || (T_on_S.empty() && S_on_T.empty()));
+
+		for (auto& dep : T_on_S)
+			distances.push_back(dep.d);
+		for (auto& dep : S_on_T)
+			distances.push_back(dep.d);
+	}
+}
+
+void TestDistanceQueryRank()
+{
+	DistanceQuery query(3, QUERY_RANK);
+	assert(query.Add(RowVector<long long>({ 1, 0, 0 })));
+	assert(query.Add(RowVector<long long>({ 1, 0, 0 })));
+	assert(query.Add(RowVector<long long>({ 0, 0, 0 })));
+	assert(query.Add(RowVector<long long>({ 0, 2, -4 })));
+	assert(query.Add(RowVector<long long>({ 2, 3, -6 })));
+	assert(query.GetRank() == 2 && !query.IsAnswered());
+
+	/** Duplicates are kept once, the result is sorted. */
+	std::vector<RowVector<long long>> distances(query.GetDistances());
+	assert(distances.size() == 4);
+	assert(CompareMatrices(distances[0], RowVector<long long>({ 0, 0, 0 })));
+	assert(CompareMatrices(distances[1], RowVector<long long>({ 0, 2, -4 })));
+	assert(CompareMatrices(distances[3], RowVector<long long>({ 2, 3, -6 })));
+
+	/** The third independent distance answers the query. */
+	assert(!query.Add(RowVector<long long>({ 0, 1, 1 })));
+	assert(query.GetRank() == 3 && query.IsAnswered());
+	assert(!query.Add(RowVector<long long>({ 5, 5, 5 })));
+	assert(query.GetDistances().size() == 5 && query.GetAddedCnt() == 7);
+
+	bool thrown(false);
+	try
+	{
+		query.Add(RowVector<long long>({ 1, 0 }));
+	}
+	catch (const std::logic_error&)
+	{
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+void TestDistanceQueryMultiplier()
+{
+	/**
+	 * Both pairs X(I1) = X(I1) and X(I1) = X(I1 - 1) in the nest 0 <= I1, I2 <= 20 produce every distance (0, k) and (1, k) within the
+	 * bounds, so the hyperplane multiplier is fixed once (0, 1) and (1, -20) have been seen.
+	 */
+	const long long n(20);
+	std::vector<RowVector<long long>> all_distances;
+	UniformTestX(0, n, nullptr, all_distances);
+	UniformTestX(1, n, nullptr, all_distances);
+
+	DistanceQuery query(2, QUERY_RANK | QUERY_MULTIPLIER);
+	RowVector<long long> lower(2), upper(2);
+	assert(FindDistanceBounds(MatrixExt<long long>({ { 1, 0 },{ 0, 1 } }), RowVector<long long>({ 0, 0 }),
+		MatrixExt<long long>({ { 1, 0 },{ 0, 1 } }), RowVector<long long>({ n, n }), lower, upper));
+	query.SetDistanceBounds(lower, upper);
+
+	std::vector<RowVector<long long>> unused;
+	UniformTestX(0, n, &query, unused);
+	UniformTestX(1, n, &query, unused);
+	assert(query.IsAnswered() && query.GetRank() == 2);
+	assert(query.GetAddedCnt() < all_distances.size());
+
+	/** Transformations found from the distances kept before the stop are the same as the ones found from all distances. */
+	const std::vector<RowVector<long long>> query_distances(query.GetDistances());
+	MatrixExt<long long> U_all(0, 0), U_query(0, 0);
+	assert(gap::tran::FindOuterLoopTransformMatrix(all_distances, U_all) == gap::tran::FindOuterLoopTransformMatrix(query_distances, U_query));
+	assert(gap::tran::FindInnerLoopTransformMatrix(all_distances, U_all) == gap::tran::FindInnerLoopTransformMatrix(query_distances, U_query));
+	assert(CompareMatrices(U_all, U_query));
+
+	/** Without bounds the multiplier can't be fixed, every distance is added. */
+	DistanceQuery unbounded(2, QUERY_RANK | QUERY_MULTIPLIER);
+	UniformTestX(0, n, &unbounded, unused);
+	UniformTestX(1, n, &unbounded, unused);
+	assert(!unbounded.IsAnswered() && unbounded.GetAddedCnt() == all_distances.size());
+}
+
+void TestFindDistanceBounds()
+{
+	/** Triangular nest 0 <= I1 <= 10, I1 + 2 <= I2 <= 15. */
+	RowVector<long long> lower(2), upper(2);
+	assert(FindDistanceBounds(MatrixExt<long long>({ { 1, -1 },{ 0, 1 } }), RowVector<long long>({ 0, 2 }),
+		MatrixExt<long long>({ { 1, 0 },{ 0, 1 } }), RowVector<long long>({ 10, 15 }), lower, upper));
+	assert(CompareMatrices(lower, RowVector<long long>({ -10, -13 })));
+	assert(CompareMatrices(upper, RowVector<long long>({ 10, 13 })));
+
+	/** Empty nest 5 <= I1 <= 4. */
+	assert(!FindDistanceBounds(MatrixExt<long long>({ { 1 } }), RowVector<long long>({ 5 }), MatrixExt<long long>({ { 1 } }),
+		RowVector<long long>({ 4 }), lower, upper));
+}
@@ -0,0 +1,228 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "distance_set_test.h"
+#include "test_utils.h"
+#include <gap_util/distance_set.h>
+#include <gap_transform/unimodular_transform.h>
+#include <cassert>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+using namespace gap::util;
+
+namespace
+{
+	/** Generates count lexicographically non-negative distances of an m-deep nest with elements within [-range, range]. */
+	std::vector<RowVector<long long>> GenerateDistances(uword m, long long range, unsigned count, unsigned long long seed)
+	{
+		std::vector<RowVector<long long>> distances;
+		while (distances.size() < count)
+		{
+			RowVector<long long> d(m);
+			for (auto k = 0U; k < m; ++k)
+			{
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				d(k) = static_cast<long long>((seed >> 33) % static_cast<unsigned long long>(2 * range + 1)) - range;
+			}
+
+			uword level(0);
+			while (level < m && d(level) == 0)
+				++level;
+			if (level == m || d(level) > 0)
+				distances.push_back(d);
+		}
+		return distances;
+	}
+
+	/** Checks that the kept distances give the same transformations as all of the distances. */
+	void CheckTransforms(const std::vector<RowVector<long long>>& all_distances, const DistanceSet& set)
+	{
+		const std::vector<RowVector<long long>> kept(set.ToVectors());
+		MatrixExt<long long> U_all(0, 0), U_kept(0, 0);
+		assert(gap::tran::FindOuterLoopTransformMatrix(all_distances, U_all) == gap::tran::FindOuterLoopTransformMatrix(kept, U_kept));
+		assert(gap::tran::FindInnerLoopTransformMatrix(all_distances, U_all) == gap::tran::FindInnerLoopTransformMatrix(kept, U_kept));
+		assert(CompareMatrices(U_all, U_kept));
+	}
+}
+
+void TestDistanceSetInsert()
+{
+	DistanceSet set(2);
+	assert(set.Insert(RowVector<long long>({ 0, 0 })) && !set.Insert(RowVector<long long>({ 0, 0 })));
+	assert(set.HasZero() && set.Size() == 0 && set.Rank() == 0);
+
+	/** (1, 3) is dominated by (1, 2) but it raises the rank, so it is kept. */
+	assert(set.Insert(RowVector<long long>({ 1, 2 })) && !set.Insert(RowVector<long long>({ 1, 2 })));
+	assert(set.Insert(RowVector<long long>({ 1, 3 })));
+	assert(set.Rank() == 2 && set.NumDistances(0) == 2);
+
+	/** Once the rank is full, dominated distances are dropped and dominating ones replace the dominated distances. */
+	assert(!set.Insert(RowVector<long long>({ 1, 5 })));
+	assert(set.Insert(RowVector<long long>({ 1, 1 })));
+	assert(set.Insert(RowVector<long long>({ 1, 0 })));
+	assert(!set.Insert(RowVector<long long>({ 1, 1 })));
+	assert(set.NumDistances(0) == 3);
+
+	/** Distances of the same level with different leading elements don't dominate each other. */
+	assert(set.Insert(RowVector<long long>({ 2, -1 })) && set.Insert(RowVector<long long>({ 0, 4 })));
+	assert(set.NumDistances(0) == 4 && set.NumDistances(1) == 1 && set.Size() == 5);
+
+	/** The result is sorted and doesn't hold the removed (1, 1). */
+	std::vector<RowVector<long long>> distances(set.ToVectors());
+	assert(distances.size() == 6);
+	assert(CompareMatrices(distances[0], RowVector<long long>({ 0, 0 })));
+	assert(CompareMatrices(distances[1], RowVector<long long>({ 0, 4 })));
+	assert(CompareMatrices(distances[2], RowVector<long long>({ 1, 0 })));
+	assert(CompareMatrices(distances[3], RowVector<long long>({ 1, 2 })));
+	assert(CompareMatrices(distances[4], RowVector<long long>({ 1, 3 })));
+	assert(CompareMatrices(distances[5], RowVector<long long>({ 2, -1 })));
+
+	bool thrown(false);
+	try
+	{
+		set.Insert(RowVector<long long>({ 0, -1 }));
+	}
+	catch (const std::logic_error&)
+	{
+		thrown = true;
+	}
+	assert(thrown);
+
+	thrown = false;
+	try
+	{
+		set.Insert(RowVector<long long>({ 1, 0, 0 }));
+	}
+	catch (const std::logic_error&)
+	{
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+void TestDistanceSetTransforms()
+{
+	for (unsigned long long seed = 1; seed <= 20; ++seed)
+	{
+		const std::vector<RowVector<long long>> all_distances(GenerateDistances(3, 6, 2000, seed));
+		DistanceSet set(3);
+		for (const auto& d : all_distances)
+			set.Insert(d);
+
+		assert(set.Size() < all_distances.size() / 4);
+		CheckTransforms(all_distances, set);
+	}
+
+	/** Distances that span only a plane keep the rank. */
+	std::vector<RowVector<long long>> planar;
+	for (long long k = 1; k <= 50; ++k)
+		planar.push_back(RowVector<long long>({ k, 2 * k, 0 }));
+	planar.push_back(RowVector<long long>({ 0, 1, 0 }));
+
+	DistanceSet set(3);
+	for (const auto& d : planar)
+		set.Insert(d);
+	assert(set.Rank() == 2);
+	CheckTransforms(planar, set);
+}
+
+void TestDistanceSetMerge()
+{
+	const std::vector<RowVector<long long>> all_distances(GenerateDistances(4, 4, 4000, 7));
+
+	DistanceSet sequential(4);
+	std::vector<DistanceSet> parts(4, DistanceSet(4));
+	for (auto k = 0U; k < all_distances.size(); ++k)
+	{
+		sequential.Insert(all_distances[k]);
+		parts[k % parts.size()].Insert(all_distances[k]);
+	}
+
+	DistanceSet merged(4);
+	for (const auto& part : parts)
+		merged.Merge(part);
+
+	assert(merged.Rank() == sequential.Rank() && merged.HasZero() == sequential.HasZero());
+	CheckTransforms(all_distances, merged);
+	CheckTransforms(all_distances, sequential);
+
+	bool thrown(false);
+	try
+	{
+		merged.Merge(DistanceSet(3));
+	}
+	catch (const std::logic_error&)
+	{
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+void TestDistanceSetKeepAll()
+{
+	/** Dominated distances are kept, only duplicates are dropped. */
+	DistanceSet set(2, false);
+	assert(!set.DropsDominated());
+	assert(set.Insert(RowVector<long long>({ 1, 2 })) && set.Insert(RowVector<long long>({ 1, 3 })) && set.Insert(RowVector<long long>({ 1, 5 })));
+	assert(set.Insert(RowVector<long long>({ 1, 0 })) && !set.Insert(RowVector<long long>({ 1, 5 })));
+	assert(set.NumDistances(0) == 4 && set.Rank() == 2);
+
+	for (unsigned long long seed = 1; seed <= 5; ++seed)
+	{
+		const std::vector<RowVector<long long>> all_distances(GenerateDistances(3, 3, 500, seed));
+		std::vector<std::vector<long long>> distinct;
+		DistanceSet keep_all(3, false);
+		for (auto & d : all_distances)
+		{
+			keep_all.Insert(d);
+			distinct.push_back(std::vector<long long>(d.begin(), d.end()));
+		}
+		std::sort(distinct.begin(), distinct.end());
+		distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+
+		const std::vector<RowVector<long long>> kept(keep_all.ToVectors());
+		assert(kept.size() == distinct.size());
+		for (std::size_t k = 0; k < kept.size(); ++k)
+			assert(std::vector<long long>(kept[k].begin(), kept[k].end()) == distinct[k]);
+
+		/** Merging into the reducing set applies the reduction. */
+		DistanceSet reduced(3);
+		reduced.Merge(keep_all);
+		assert(reduced.Size() <= keep_all.Size());
+		CheckTransforms(all_distances, reduced);
+	}
+}
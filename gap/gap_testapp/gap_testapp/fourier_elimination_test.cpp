@@ -34,11 +34,15 @@
 
 #include "fourier_elimination_test.h"
 #include <gap_util/fourier_elimination.h>
+#include <gap_util/thread_pool.h>
 #include "test_utils.h"
 #include <cassert>
 #include <vector>
 #include <algorithm>
 #include <limits>
+#include <stdexcept>
+#include <atomic>
+#include <thread>
 
 using namespace gap::util;
 
@@ -49,8 +53,12 @@ static void TestFourierEliminationInternal(
 	const std::vector<Bound>& B_expect,
 	bool has_solution = true)
 {
+	/** Expected bounds are those of the plain algorithm, without removal of redundant inequalities. */
+	FourierEliminationOptions options;
+	options.prune_redundant = false;
+
 	std::vector<std::pair<MatrixExt<Rational<long long>>, RowVector<Rational<long long>>>> b, B;
-	assert(PerformFourierElimination(A, c, b, B) == has_solution);
+	assert(PerformFourierElimination(A, c, b, B, options) == has_solution);
 
 	assert(b.size() == b_expect.size() && B.size() == B_expect.size());
 	assert(std::equal(b_expect.begin(), b_expect.end(), b.begin(),
@@ -91,6 +99,22 @@ static void TestEnumerateSolutionsInternal(
 				}
 			}
 		}
+
+		/** Streaming variant must visit exactly the same solutions in the same order. */
+		size_t visited(0);
+		auto expected = solution_sets[0].begin();
+		assert(EnumerateIntegerSolutions(b, B, [&](const RowVector<long long>& solution)
+		{
+			assert(expected != solution_sets[0].end() && CompareMatrices(*expected++, solution));
+			++visited;
+			return true;
+		}) == has_int_solution);
+		assert(visited == solution_sets[0].size());
+
+		/** Enumeration must stop as soon as visitor returns false. */
+		visited = 0;
+		EnumerateIntegerSolutions(b, B, [&visited](const RowVector<long long>&) { ++visited; return false; });
+		assert(visited == (has_int_solution ? 1U : 0U));
 	}
 	catch (const std::logic_error&)
 	{
@@ -298,6 +322,420 @@ void TestFourierElimination()
 		false);
 }
 
+/** Collects every integer solution of the system, or returns FALSE if the solution set is infinite. */
+static bool CollectIntegerSolutions(
+	const std::vector<Bound>& b,
+	const std::vector<Bound>& B,
+	std::vector<RowVector<long long>>& solutions)
+{
+	try
+	{
+		EnumerateIntegerSolutions(b, B, [&solutions](const RowVector<long long>& solution)
+		{
+			solutions.push_back(solution);
+			return true;
+		});
+	}
+	catch (const std::logic_error&)
+	{
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Solves the system with and without removal of redundant inequalities. Pruned bounds must describe the same solution set, with no more
+ * bound functions than the plain ones.
+ */
+static void TestFourierEliminationPruningInternal(
+	const MatrixExt<long long>& A,
+	const RowVector<long long>& c,
+	bool has_solution = true)
+{
+	FourierEliminationOptions plain_options, chernikov_options, exact_options;
+	plain_options.prune_redundant = false;
+	exact_options.exact_redundancy_check = true;
+
+	std::vector<Bound> b_plain, B_plain;
+	assert(PerformFourierElimination(A, c, b_plain, B_plain, plain_options) == has_solution);
+
+	std::vector<RowVector<long long>> plain_solutions;
+	bool is_finite(has_solution && CollectIntegerSolutions(b_plain, B_plain, plain_solutions));
+
+	for (const auto & options : { chernikov_options, exact_options })
+	{
+		std::vector<Bound> b, B;
+		assert(PerformFourierElimination(A, c, b, B, options) == has_solution);
+		if (!has_solution)
+			continue;
+
+		assert(b.size() == b_plain.size() && B.size() == B_plain.size());
+		for (auto i = 0U; i < b.size(); ++i)
+			assert(b[i].first.n_cols <= b_plain[i].first.n_cols && B[i].first.n_cols <= B_plain[i].first.n_cols);
+
+		if (is_finite)
+		{
+			std::vector<RowVector<long long>> solutions;
+			assert(CollectIntegerSolutions(b, B, solutions));
+			assert(solutions.size() == plain_solutions.size());
+			assert(std::equal(solutions.begin(), solutions.end(), plain_solutions.begin(),
+				[](const RowVector<long long>& s1, const RowVector<long long>& s2) { return CompareMatrices(s1, s2); }));
+		}
+	}
+}
+
+void TestFourierEliminationPruning()
+{
+	// Test case 1 (systems from TestFourierElimination())
+	TestFourierEliminationPruningInternal({ { -1, 2, 0 },{ 1, 0, -10 } }, { 0, 5, -23 });
+	TestFourierEliminationPruningInternal({ { 2, -1, 2, -1, 0, 0 },{ 3, 1, 1, 0, -1, 0 },{ -1, -1, 1, 0, 0, -1 } }, { 3, 2, 4, 0, 0, 0 });
+	TestFourierEliminationPruningInternal(
+	{ { 3, -2, 1, 1, 0, 0 },{ -5, -1, -6, 0, 2, -3 },{ 1, 3, 4, -5, -3, 0 },{ 2, -8, 1, -7, 0, 5 } },
+	{ 6, -10, 100, -30, 10, -100 });
+	TestFourierEliminationPruningInternal(
+	{ { 3, -3, -3, -1, 0, 3, -3, -2 },{ 1, 1, -1, -1, -1, 0, 0, 0 } },
+	{ 103, -1, -4, -2, -1, 101, -2, -2 });
+
+	// Test case 2 (cube 0 <= xi <= 3 with duplicated and dominated faces, as well as redundant diagonal cuts)
+	MatrixExt<long long> A(
+	{
+		{ 1, -1, 0, 0, 0, 0, 2, -1, 1, 1, -1 },
+		{ 0, 0, 1, -1, 0, 0, 0, 0, 1, 1, -1 },
+		{ 0, 0, 0, 0, 1, -1, 0, 0, 1, 1, -1 }
+	});
+	RowVector<long long> c({ 3, 0, 3, 0, 3, 0, 8, 0, 9, 12, 0 });
+
+	ResetFourierEliminationStatistics();
+	std::vector<Bound> b, B;
+	FourierEliminationOptions plain_options;
+	plain_options.prune_redundant = false;
+	assert(PerformFourierElimination(A, c, b, B, plain_options));
+	FourierEliminationStatistics plain_stats(GetFourierEliminationStatistics());
+	assert(plain_stats.pruned_inequalities == 0 && plain_stats.peak_inequalities >= A.n_cols);
+
+	ResetFourierEliminationStatistics();
+	assert(PerformFourierElimination(A, c, b, B));
+	FourierEliminationStatistics pruned_stats(GetFourierEliminationStatistics());
+	assert(pruned_stats.pruned_inequalities > 0 && pruned_stats.peak_inequalities < plain_stats.peak_inequalities);
+	assert(pruned_stats.generated_inequalities < plain_stats.generated_inequalities);
+
+	/** Only faces of the cube remain once redundant inequalities are removed exactly. */
+	FourierEliminationOptions exact_options;
+	exact_options.exact_redundancy_check = true;
+	assert(PerformFourierElimination(A, c, b, B, exact_options));
+	for (auto i = 0U; i < b.size(); ++i)
+	{
+		assert(b[i].second.n_cols == 1 && b[i].second(0) == 0LL);
+		assert(B[i].second.n_cols == 1 && B[i].second(0) == 3LL);
+	}
+	TestFourierEliminationPruningInternal(A, c);
+
+	// Test case 3 (negative, contradiction appears only after elimination)
+	TestFourierEliminationPruningInternal({ { 1, -1, 1 },{ 1, 0, -1 } }, { 1, -2, -3 }, false);
+}
+
+static bool CompareBounds(const std::vector<Bound>& b1, const std::vector<Bound>& b2)
+{
+	return b1.size() == b2.size() && std::equal(b1.begin(), b1.end(), b2.begin(), [](const Bound& v1, const Bound& v2)
+	{
+		return CompareMatrices(v1.first, v2.first) && CompareMatrices(v1.second, v2.second);
+	});
+}
+
+/** Fraction-free elimination must produce exactly the same bounds as the rational one, with and without removal of redundant inequalities. */
+static void TestIntegerFourierEliminationInternal(const MatrixExt<long long>& A, const RowVector<long long>& c)
+{
+	FourierEliminationOptions plain_options, chernikov_options, exact_options;
+	plain_options.prune_redundant = false;
+	exact_options.exact_redundancy_check = true;
+
+	for (auto options : { plain_options, chernikov_options, exact_options })
+	{
+		std::vector<Bound> b_rational, B_rational, b, B;
+		const bool has_solution(PerformFourierElimination(A, c, b_rational, B_rational, options));
+
+		assert(PerformIntegerFourierElimination(A, c, b, B, options) == has_solution);
+		assert(!has_solution || (CompareBounds(b, b_rational) && CompareBounds(B, B_rational)));
+
+		options.arithmetic = FOURIER_INTEGER;
+		assert(PerformFourierElimination(A, c, b, B, options) == has_solution);
+		assert(!has_solution || (CompareBounds(b, b_rational) && CompareBounds(B, B_rational)));
+
+		MatrixExt<int> A_int(A.n_rows, A.n_cols);
+		RowVector<int> c_int(c.n_cols);
+		std::transform(A.begin(), A.end(), A_int.begin(), [](long long x) { return static_cast<int>(x); });
+		std::transform(c.begin(), c.end(), c_int.begin(), [](long long x) { return static_cast<int>(x); });
+		assert(PerformIntegerFourierElimination(A_int, c_int, b, B, options) == has_solution);
+		assert(!has_solution || (CompareBounds(b, b_rational) && CompareBounds(B, B_rational)));
+	}
+}
+
+void TestIntegerFourierElimination()
+{
+	// Test case 1 (systems from TestFourierElimination() and TestFourierEliminationPruning())
+	TestIntegerFourierEliminationInternal({ { -1, 2, 0 },{ 1, 0, -10 } }, { 0, 5, -23 });
+	TestIntegerFourierEliminationInternal({ { 2, -1, 2, -1, 0, 0 },{ 3, 1, 1, 0, -1, 0 },{ -1, -1, 1, 0, 0, -1 } }, { 3, 2, 4, 0, 0, 0 });
+	TestIntegerFourierEliminationInternal(
+	{ { 3, -2, 1, 1, 0, 0 },{ -5, -1, -6, 0, 2, -3 },{ 1, 3, 4, -5, -3, 0 },{ 2, -8, 1, -7, 0, 5 } },
+	{ 6, -10, 100, -30, 10, -100 });
+	TestIntegerFourierEliminationInternal(
+	{ { 3, -3, -3, -1, 0, 3, -3, -2 },{ 1, 1, -1, -1, -1, 0, 0, 0 } },
+	{ 103, -1, -4, -2, -1, 101, -2, -2 });
+	TestIntegerFourierEliminationInternal(
+	{
+		{ 1, -1, 0, 0, 0, 0, 2, -1, 1, 1, -1 },
+		{ 0, 0, 1, -1, 0, 0, 0, 0, 1, 1, -1 },
+		{ 0, 0, 0, 0, 1, -1, 0, 0, 1, 1, -1 }
+	},
+	{ 3, 0, 3, 0, 3, 0, 8, 0, 9, 12, 0 });
+	TestIntegerFourierEliminationInternal({ { 1, -1, 1 },{ 1, 0, -1 } }, { 1, -2, -3 });
+	TestIntegerFourierEliminationInternal({ { 0, 0, 0 } }, { 1, 0, 2 });
+	TestIntegerFourierEliminationInternal({ { 0, 0, 0 } }, { 1, -1, 2 });
+
+	// Test case 2 (pseudo-random systems with 2 to 4 variables)
+	unsigned long long seed(17);
+	for (auto k = 0U; k < 60; ++k)
+	{
+		const uword m(2 + k % 3), n(4 + k % 5);
+		MatrixExt<long long> A(m, n);
+		RowVector<long long> c(n);
+		for (auto i = A.begin(); i != A.end(); ++i)
+		{
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			*i = static_cast<long long>((seed >> 33) % 13) - 6;
+		}
+		for (auto i = c.begin(); i != c.end(); ++i)
+		{
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			*i = static_cast<long long>((seed >> 33) % 41) - 10;
+		}
+		TestIntegerFourierEliminationInternal(A, c);
+	}
+
+	// Test case 3 (intermediate coefficient doesn't fit into long long, so elimination falls back to rational arithmetic)
+	const long long big(1LL << 62);
+	MatrixExt<long long> A({ { big, big },{ 2, -2 } });
+	RowVector<long long> c({ 1, 1 });
+
+	std::vector<Bound> b_rational, B_rational, b, B;
+	assert(PerformFourierElimination(A, c, b_rational, B_rational));
+
+	bool overflow(false);
+	try
+	{
+		PerformIntegerFourierElimination(A, c, b, B);
+	}
+	catch (const std::overflow_error&)
+	{
+		overflow = true;
+	}
+	assert(overflow);
+
+	FourierEliminationOptions options;
+	options.arithmetic = FOURIER_INTEGER;
+	assert(PerformFourierElimination(A, c, b, B, options));
+	assert(CompareBounds(b, b_rational) && CompareBounds(B, B_rational));
+}
+
+/** Integer points of the box [lower, upper]^m that satisfy xA <= c, in lexicographic order. */
+static std::vector<RowVector<long long>> BruteForceSolutions(const MatrixExt<long long>& A, const RowVector<long long>& c, long long lower,
+	long long upper)
+{
+	std::vector<RowVector<long long>> solutions;
+	RowVector<long long> x(A.n_rows);
+	x.fill(lower);
+	for (;;)
+	{
+		bool satisfied(true);
+		for (auto j = 0U; j < A.n_cols && satisfied; ++j)
+		{
+			long long lhs(0);
+			for (auto i = 0U; i < A.n_rows; ++i)
+				lhs += x(i) * A(i, j);
+			satisfied = lhs <= c(j);
+		}
+		if (satisfied)
+			solutions.push_back(x);
+
+		auto level(A.n_rows);
+		while (level > 0 && x(level - 1) == upper)
+			x(--level) = lower;
+		if (level == 0)
+			return solutions;
+		++x(level - 1);
+	}
+}
+
+void TestIntegerSolutionEnumerator()
+{
+	/** Box 0 <= xi <= 6 with pseudo-random cuts, so that inner ranges are often empty and the space is unbalanced. */
+	unsigned long long seed(5);
+	for (auto k = 0U; k < 40; ++k)
+	{
+		const uword m(1 + k % 3), num_cuts(k % 4);
+		MatrixExt<long long> A(m, 2 * m + num_cuts);
+		RowVector<long long> c(2 * m + num_cuts);
+		A.zeros();
+		for (auto i = 0U; i < m; ++i)
+		{
+			A(i, 2 * i) = -1;
+			A(i, 2 * i + 1) = 1;
+			c(2 * i) = 0;
+			c(2 * i + 1) = 6;
+		}
+		for (auto j = 2 * m; j < A.n_cols; ++j)
+		{
+			for (auto i = 0U; i < m; ++i)
+			{
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				A(i, j) = static_cast<long long>((seed >> 33) % 7) - 3;
+			}
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			c(j) = static_cast<long long>((seed >> 33) % 15) - 2;
+		}
+
+		const std::vector<RowVector<long long>> expected(BruteForceSolutions(A, c, 0, 6));
+
+		BoundSet lower, upper;
+		if (!PerformFourierElimination(A, c, lower, upper))
+		{
+			assert(expected.empty());
+			continue;
+		}
+
+		IntegerSolutionEnumerator enumerator(lower, upper);
+		auto expected_it = expected.begin();
+		while (enumerator.Next())
+		{
+			assert(expected_it != expected.end() && CompareMatrices(enumerator.Solution(), *expected_it));
+			++expected_it;
+		}
+		assert(expected_it == expected.end());
+		assert(!enumerator.Next());
+	}
+}
+
+void TestParallelEnumerateIntegerSolutions()
+{
+	/** Triangular space 0 <= x3 <= x2 <= x1 <= 40, the subtree of x1 grows quadratically with its value. */
+	const MatrixExt<long long> A({ { -1, 1, 0, -1, 0, 0 },{ 0, 0, -1, 1, 0, -1 },{ 0, 0, 0, 0, -1, 1 } });
+	const RowVector<long long> c({ 0, 40, 0, 0, 0, 0 });
+
+	BoundSet lower, upper;
+	assert(PerformFourierElimination(A, c, lower, upper));
+
+	std::vector<RowVector<long long>> expected;
+	assert(EnumerateIntegerSolutions(lower, upper, [&expected](const RowVector<long long>& solution)
+	{
+		expected.push_back(solution);
+		return true;
+	}));
+	assert(expected.size() == 12341);
+
+	auto less = [](const RowVector<long long>& x, const RowVector<long long>& y)
+	{
+		return std::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
+	};
+
+	for (unsigned thread_cnt : { 1U, 3U, 8U, 64U })
+	{
+		ThreadPool pool(thread_cnt);
+
+		/** Collected solutions are in the sequential order. */
+		std::vector<RowVector<long long>> solutions;
+		assert(EnumerateIntegerSolutions(lower, upper, pool, solutions));
+		assert(solutions.size() == expected.size());
+		for (auto i = 0U; i < expected.size(); ++i)
+			assert(CompareMatrices(solutions[i], expected[i]));
+
+		/** Ordered variant hands over the sequential order, and stopping it hands over exactly the solutions up to the stop. */
+		size_t next(0);
+		assert(EnumerateIntegerSolutionsInOrder(lower, upper, pool, [&expected, &next](const RowVector<long long>& solution)
+		{
+			assert(next < expected.size() && CompareMatrices(solution, expected[next]));
+			++next;
+			return true;
+		}));
+		assert(next == expected.size());
+
+		for (size_t stop_at : { size_t(1), size_t(5000), expected.size() - 1 })
+		{
+			next = 0;
+			assert(EnumerateIntegerSolutionsInOrder(lower, upper, pool, [&expected, &next, stop_at](const RowVector<long long>& solution)
+			{
+				assert(CompareMatrices(solution, expected[next]));
+				return ++next < stop_at;
+			}));
+			assert(next == stop_at);
+		}
+
+		/** Every worker has its own sink, together they hold every solution exactly once. */
+		std::vector<std::vector<RowVector<long long>>> sinks(thread_cnt);
+		assert(EnumerateIntegerSolutions(lower, upper, pool, [&sinks](unsigned worker_idx, const RowVector<long long>& solution)
+		{
+			sinks[worker_idx].push_back(solution);
+			return true;
+		}));
+
+		std::vector<RowVector<long long>> merged;
+		for (const auto& sink : sinks)
+			merged.insert(merged.end(), sink.begin(), sink.end());
+		std::sort(merged.begin(), merged.end(), less);
+		assert(merged.size() == expected.size());
+		for (auto i = 0U; i < expected.size(); ++i)
+			assert(CompareMatrices(merged[i], expected[i]));
+
+		/** Returning FALSE stops every worker. */
+		std::atomic<unsigned> visited(0);
+		assert(EnumerateIntegerSolutions(lower, upper, pool, [&visited](unsigned, const RowVector<long long>&)
+		{
+			++visited;
+			return false;
+		}));
+		assert(visited >= 1 && visited <= thread_cnt);
+
+		/** Threads outside the pool can share it, every enumeration waits only for its own tasks. */
+		std::vector<std::vector<RowVector<long long>>> concurrent(3);
+		std::vector<std::thread> callers;
+		for (auto& collected : concurrent)
+			callers.emplace_back([&lower, &upper, &pool, &collected]() { EnumerateIntegerSolutions(lower, upper, pool, collected); });
+		for (auto& caller : callers)
+			caller.join();
+		for (const auto& collected : concurrent)
+		{
+			assert(collected.size() == expected.size());
+			for (auto i = 0U; i < expected.size(); ++i)
+				assert(CompareMatrices(collected[i], expected[i]));
+		}
+
+		/** x1 <= -1 leaves no solution. */
+		BoundSet empty_lower, empty_upper;
+		const RowVector<long long> c_empty({ 0, -1, 0, 0, 0, 0 });
+		if (PerformFourierElimination(A, c_empty, empty_lower, empty_upper))
+		{
+			std::vector<RowVector<long long>> none;
+			assert(!EnumerateIntegerSolutions(empty_lower, empty_upper, pool, none) && none.empty());
+		}
+
+		/** x3 is not bounded from above. */
+		const MatrixExt<long long> A_infinite({ { -1, 1, 0, -1, 0 },{ 0, 0, -1, 1, 0 },{ 0, 0, 0, 0, -1 } });
+		const RowVector<long long> c_infinite({ 0, 40, 0, 0, 0 });
+		BoundSet infinite_lower, infinite_upper;
+		assert(PerformFourierElimination(A_infinite, c_infinite, infinite_lower, infinite_upper));
+		bool thrown(false);
+		try
+		{
+			std::vector<RowVector<long long>> infinite;
+			EnumerateIntegerSolutions(infinite_lower, infinite_upper, pool, infinite);
+		}
+		catch (const std::logic_error&)
+		{
+			thrown = true;
+		}
+		assert(thrown);
+	}
+}
+
 void TestEnumerateIntegerSolutions()
 {
 	// Test case 1 (negative)
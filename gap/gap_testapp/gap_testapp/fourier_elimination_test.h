@@ -37,9 +37,17 @@
 
 void TestFourierElimination();
 void TestEnumerateIntegerSolutions();
+void TestFourierEliminationPruning();
+void TestIntegerFourierElimination();
+void TestIntegerSolutionEnumerator();
+void TestParallelEnumerateIntegerSolutions();
 
 #define RUN_FOURIER_ELIMINATION_TESTS() \
 	TestFourierElimination(); \
-	TestEnumerateIntegerSolutions()
+	TestEnumerateIntegerSolutions(); \
+	TestFourierEliminationPruning(); \
+	TestIntegerFourierElimination(); \
+	TestIntegerSolutionEnumerator(); \
+	TestParallelEnumerateIntegerSolutions()
 
 #endif /// GAP_TESTAPP_FOURIER_ELIMINATION_TEST
\ No newline at end of file
@@ -39,18 +39,32 @@
 #include "row_col_vector_test.h"
 #include "diophantine_test.h"
 #include "fourier_elimination_test.h"
+#include "omega_elimination_test.h"
 #include "dependence_analyser_test.h"
 #include "unimodular_transform_test.h"
+#include "thread_pool_test.h"
+#include "small_matrix_test.h"
+#include "normal_form_test.h"
+#include "bound_set_test.h"
+#include "distance_query_test.h"
+#include "distance_set_test.h"
 
 int main()
 {
 	/*RUN_RATIONAL_NUMBER_TESTS();
 	RUN_MATRIX_EXT_TESTS();
+	RUN_SMALL_MATRIX_TESTS();
+	RUN_NORMAL_FORM_TESTS();
 	RUN_ROW_COL_VECTOR_TESTS();
 	RUN_DIOPHANTINE_TESTS();
 	RUN_FOURIER_ELIMINATION_TESTS();
+	RUN_BOUND_SET_TESTS();
+	RUN_OMEGA_ELIMINATION_TESTS();
 	//RUN_DEPENDENCE_ANALYSER_TESTS();
 	//RUN_UNIMODULAR_TRANSFORMATION_TESTS();
+	RUN_THREAD_POOL_TESTS();
+	RUN_DISTANCE_QUERY_TESTS();
+	RUN_DISTANCE_SET_TESTS();
 
 	std::cout << "================== All tests passed ==================\n";*/
 
@@ -59,5 +73,9 @@ int main()
 	//ThesisMatrixMult();
 	ThesisMRI_Q_Computation();
 
+	/******************************** BENCHMARKS ***********************************/
+	//BenchmarkRationalNormalization();
+	//BenchmarkNormalForms();
+
     return 0;
 }
@@ -37,6 +37,7 @@
 #include <gap_util/rational_number.hpp>
 #include <cassert>
 #include <stdexcept>
+#include <vector>
 #include "test_utils.h"
 
 using namespace arma;
@@ -674,6 +675,11 @@ void TestMatrixEchelonReduction()
 
     rank_s = G.ReduceToEchelon(U,S);
     assert(CompareMatrices(U*G, S) && rank_s == 2);
+
+    /** Leading zero column. */
+    MatrixExt<int> H = { { 0, 1, 2 }, { 0, 1, 5 }, { 0, 2, 4 } };
+    rank_s = H.ReduceToEchelon(U,S);
+    assert(CompareMatrices(U*H, S) && S.IsEchelon() && rank_s == 2);
 }
 
 void TestMatrixEchelonReduction2()
@@ -706,6 +712,11 @@ void TestMatrixEchelonReduction2()
 
     D.ReduceToEchelon2(V,S);
     assert(CompareMatrices(D, V*S));
+
+    /** Leading zero column. */
+    MatrixExt<int> E = { { 0, 1, 2 }, { 0, 1, 5 }, { 0, 2, 4 } };
+    uword rank_s = E.ReduceToEchelon2(V,S);
+    assert(CompareMatrices(E, V*S) && S.IsEchelon() && rank_s == 2);
 }
 
 void TestMatrixDiagonalization()
@@ -739,3 +750,39 @@ void TestMatrixDiagonalization()
     E.ReduceToDiagonal(U, V, D);
     assert(CompareMatrices(U*E*V, D));
 }
+
+void TestInvertUnimodular()
+{
+	const long long big((1LL << 30) + 1);
+	std::vector<MatrixExt<long long>> unimodular = {
+		{ { 1 } },
+		{ { -1 } },
+		{ { 2, 1 }, { 1, 1 } },
+		{ { 0, 1, 0 }, { 1, 0, 0 }, { 0, 0, -1 } },
+		{ { 1, 2, 3 }, { 0, 1, 4 }, { 5, 6, 0 } },
+		{ { 1, big, 0 }, { 0, 1, big }, { 0, 0, 1 } },		/** Large skewing factors can't be inverted exactly in floating point. */
+		{ { 3, 2, 0, 1 }, { 4, 0, 1, 2 }, { 0, 1, 0, 0 }, { 1, 0, 0, 0 } }
+	};
+
+	for (auto & A : unimodular)
+	{
+		MatrixExt<long long> A_inv(0, 0);
+		assert(A.InvertUnimodular(A_inv));
+		assert(CompareMatrices(A * A_inv, MatrixExt<long long>(A.n_rows, A.n_rows, arma::fill::eye)));
+		assert(CompareMatrices(A_inv * A, MatrixExt<long long>(A.n_rows, A.n_rows, arma::fill::eye)));
+	}
+
+	/** Singular, non-unimodular and non-square matrices don't have integer inverse. */
+	std::vector<MatrixExt<long long>> others = {
+		{ { 2 } },
+		{ { 1, 2 }, { 2, 4 } },
+		{ { 2, 0 }, { 0, 1 } },
+		{ { 1, 0, 0 }, { 0, 1, 0 } }
+	};
+
+	for (auto & A : others)
+	{
+		MatrixExt<long long> A_inv(0, 0);
+		assert(!A.InvertUnimodular(A_inv));
+	}
+}
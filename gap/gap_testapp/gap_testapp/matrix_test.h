@@ -48,6 +48,7 @@ void TestDoSkewingOperation();
 void TestMatrixEchelonReduction();
 void TestMatrixEchelonReduction2();
 void TestMatrixDiagonalization();
+void TestInvertUnimodular();
 
 #define RUN_MATRIX_EXT_TESTS()			\
 	TestRationalMatrixArithmetic();		\
@@ -62,6 +63,7 @@ void TestMatrixDiagonalization();
     TestDoSkewingOperation();			\
     TestMatrixEchelonReduction();		\
     TestMatrixEchelonReduction2();		\
-    TestMatrixDiagonalization()
+    TestMatrixDiagonalization();		\
+    TestInvertUnimodular()
 
 #endif // GAP_TESTAPP_MATRIX_TEST_H
@@ -0,0 +1,185 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "normal_form_test.h"
+#include "test_utils.h"
+#include <gap_util/normal_form.h>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace arma;
+using namespace gap::util;
+
+namespace
+{
+	const std::vector<MatrixExt<long long>>& GetTestMatrices()
+	{
+		static const std::vector<MatrixExt<long long>> matrices = {
+			{ { 4, 4, 1 }, { 6, 0, 1 }, { 4, 3, 2 } },
+			{ { 3, 1, -2, 4 }, { 1, 0, 2, 3 }, { 2, 1, -1, 1 } },
+			{ { 1, -4 }, { -5, 0 }, { 1, -6 }, { 0, 0 }, { 8, -1 }, { -3, 3 } },
+			{ { -1, 3, 0 }, { 0, -4, 1 }, { 0, 0, 9 }, { 0, 0, 0 } },
+			{ { 0, 1, 2 }, { 0, 1, 5 }, { 0, 2, 4 } },
+			{ { 2, 4, 4 }, { -6, 6, 12 }, { 10, -4, -16 } },
+			{ { 0, 0 }, { 0, 0 } }
+		};
+		return matrices;
+	}
+
+	long long MaxAbsElement(const MatrixExt<long long>& X)
+	{
+		long long max_abs(0);
+		for (auto i = X.begin(); i != X.end(); ++i)
+			max_abs = std::max(max_abs, std::llabs(*i));
+		return max_abs;
+	}
+
+	bool IsUnimodular(const MatrixExt<long long>& U)
+	{
+		MatrixExt<long long> U_inv(0, 0);
+		return U.InvertUnimodular(U_inv);
+	}
+
+	/** Pseudo-random (m x n) matrix with elements in range [-9, 9]. */
+	MatrixExt<long long> GenerateMatrix(uword m, uword n, unsigned long long& seed)
+	{
+		MatrixExt<long long> A(m, n);
+		for (auto i = A.begin(); i != A.end(); ++i)
+		{
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			*i = static_cast<long long>((seed >> 33) % 19) - 9;
+		}
+		return A;
+	}
+}
+
+void TestHermiteNormalForm()
+{
+	const uword ranks[] = { 3, 3, 2, 3, 2, 3, 0 };
+	for (auto k = 0U; k < GetTestMatrices().size(); ++k)
+	{
+		const MatrixExt<long long>& A(GetTestMatrices()[k]);
+		MatrixExt<long long> U(0, 0), H(0, 0);
+		const uword rank(ComputeHermiteNormalForm(A, U, H));
+
+		assert(rank == ranks[k] && rank == A.ComputeRank());
+		assert(CompareMatrices(U * A, H) && IsUnimodular(U) && H.IsEchelon());
+
+		/** Pivots are positive and elements above them are reduced modulo the pivot. */
+		for (auto r = 0U; r < rank; ++r)
+		{
+			const uword j(H.GetRowLevel(r));
+			assert(H(r, j) > 0);
+			for (auto i = 0U; i < r; ++i)
+				assert(H(i, j) >= 0 && H(i, j) < H(r, j));
+		}
+
+		/** Hermite Normal Form is unique, so reducing the echelon matrix of the Euclid's algorithm gives the same matrix. */
+		MatrixExt<long long> U_euclid(A.n_rows, A.n_rows), S_euclid(A.n_rows, A.n_cols), U2(0, 0), H2(0, 0);
+		A.ReduceToEchelon(U_euclid, S_euclid);
+		ComputeHermiteNormalForm(S_euclid, U2, H2);
+		assert(CompareMatrices(H, H2));
+	}
+}
+
+void TestSmithNormalForm()
+{
+	const std::vector<std::vector<long long>> invariant_factors = {
+		{ 1, 1, 26 }, { 1, 1, 3 }, { 1, 1 }, { 1, 1, 36 }, { 1, 3, 0 }, { 2, 6, 12 }, { 0, 0 }
+	};
+
+	for (auto k = 0U; k < GetTestMatrices().size(); ++k)
+	{
+		const MatrixExt<long long>& A(GetTestMatrices()[k]);
+		MatrixExt<long long> U(0, 0), V(0, 0), D(0, 0);
+		const uword rank(ComputeSmithNormalForm(A, U, V, D));
+
+		assert(rank == A.ComputeRank());
+		assert(CompareMatrices(U * A * V, D) && IsUnimodular(U) && IsUnimodular(V) && D.IsDiagonal());
+		for (auto i = 0U; i < invariant_factors[k].size(); ++i)
+			assert(D(i, i) == invariant_factors[k][i]);
+
+		/** Every diagonal element divides the next one. */
+		for (auto i = 1U; i < rank; ++i)
+			assert(D(i, i) % D(i - 1, i - 1) == 0);
+	}
+}
+
+void BenchmarkNormalForms()
+{
+	/**
+	 * MatrixExt::ReduceToDiagonal() is not measured, it fails on many of these matrices (division by zero). Normal forms of larger
+	 * matrices don't fit into long long.
+	 */
+	const int n_runs(200);
+	for (auto dim : { 4U, 6U, 8U })
+	{
+		unsigned long long seed(dim);
+		std::vector<MatrixExt<long long>> matrices;
+		for (int i = 0; i < n_runs; ++i)
+			matrices.push_back(GenerateMatrix(dim, dim, seed));
+
+		long long max_euclid(0), max_hermite(0), max_smith(0);
+		double euclid = MeasureNanoseconds(n_runs, [&]() {
+			for (auto & A : matrices)
+			{
+				MatrixExt<long long> U(dim, dim), S(dim, dim);
+				A.ReduceToEchelon(U, S);
+				max_euclid = std::max(max_euclid, MaxAbsElement(U));
+			}
+		});
+		double hermite = MeasureNanoseconds(n_runs, [&]() {
+			for (auto & A : matrices)
+			{
+				MatrixExt<long long> U(0, 0), H(0, 0);
+				ComputeHermiteNormalForm(A, U, H);
+				max_hermite = std::max(max_hermite, MaxAbsElement(U));
+			}
+		});
+		double smith = MeasureNanoseconds(n_runs, [&]() {
+			for (auto & A : matrices)
+			{
+				MatrixExt<long long> U(0, 0), V(0, 0), D(0, 0);
+				ComputeSmithNormalForm(A, U, V, D);
+				max_smith = std::max(max_smith, std::max(MaxAbsElement(U), MaxAbsElement(V)));
+			}
+		});
+
+		std::cout << dim << "x" << dim << " echelon: ReduceToEchelon " << euclid / 1000 << " us (max |U| " << max_euclid << "), Hermite "
+			<< hermite / 1000 << " us (max |U| " << max_hermite << ")\n";
+		std::cout << dim << "x" << dim << " diagonal: Smith " << smith / 1000 << " us (max |U|,|V| " << max_smith << ")\n";
+	}
+}
@@ -0,0 +1,161 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "omega_elimination_test.h"
+#include <gap_util/omega_elimination.h>
+#include <gap_util/fourier_elimination.h>
+#include "test_utils.h"
+#include <cassert>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+using namespace gap::util;
+
+static void TestOmegaTestInternal(const MatrixExt<long long>& A, const RowVector<long long>& c, bool has_int_solution)
+{
+	assert(OmegaTest(A, c) == has_int_solution);
+}
+
+/** Omega enumeration must produce exactly the same sequence of solutions as Fourier elimination followed by the enumeration. */
+static void TestOmegaEnumerateInternal(const MatrixExt<long long>& A, const RowVector<long long>& c)
+{
+	std::vector<RowVector<long long>> fourier_solutions, omega_solutions;
+	std::vector<Bound> b, B;
+	if (PerformFourierElimination(A, c, b, B))
+		EnumerateIntegerSolutions(b, B, [&](const RowVector<long long>& x) { fourier_solutions.push_back(x); return true; });
+
+	bool found(OmegaEnumerateIntegerSolutions(A, c, [&](const RowVector<long long>& x) { omega_solutions.push_back(x); return true; }));
+	assert(found == !fourier_solutions.empty());
+	assert(OmegaTest(A, c) == found);
+	assert(omega_solutions.size() == fourier_solutions.size());
+	assert(std::equal(omega_solutions.begin(), omega_solutions.end(), fourier_solutions.begin(),
+		[](const RowVector<long long>& x, const RowVector<long long>& y) { return CompareMatrices(x, y); }));
+
+	/** Integer bounds are attained by the solutions. */
+	RowVector<long long> lower(0), upper(0);
+	assert(FindIntegerBounds(A, c, lower, upper) == found);
+	for (auto k = 0U; found && k < A.n_rows; ++k)
+	{
+		auto by_var = [k](const RowVector<long long>& x, const RowVector<long long>& y) { return x(k) < y(k); };
+		assert(std::min_element(omega_solutions.begin(), omega_solutions.end(), by_var)->at(k) == lower(k));
+		assert(std::max_element(omega_solutions.begin(), omega_solutions.end(), by_var)->at(k) == upper(k));
+	}
+
+	/** Visitor can stop the enumeration. */
+	std::size_t visited(0);
+	OmegaEnumerateIntegerSolutions(A, c, [&](const RowVector<long long>&) { return ++visited < 2; });
+	assert(visited == std::min<std::size_t>(2, omega_solutions.size()));
+}
+
+void TestOmegaTest()
+{
+	// Test case 1 (real solution exists, but there is no integer solution: 1 <= 3x <= 2)
+	TestOmegaTestInternal({ { 3, -3 } }, { 2, -1 }, false);
+
+	// Test case 2 (exact equality elimination: 2x + 4y = 7 has no integer solution)
+	TestOmegaTestInternal({ { 2, -2 },{ 4, -4 } }, { 7, -7 }, false);
+
+	// Test case 3 (equality 3x + 5y = 1 with bounded x and y)
+	TestOmegaTestInternal({ { 3, -3, 1, -1, 0, 0 },{ 5, -5, 0, 0, 1, -1 } }, { 1, -1, 10, 10, 10, 10 }, true);
+
+	// Test case 4 (Pugh's example with real but without integer solution: 27 <= 11x + 13y <= 45, -10 <= 7x - 9y <= 4)
+	TestOmegaTestInternal({ { 11, -11, 7, -7 },{ 13, -13, -9, 9 } }, { 45, -27, 4, 10 }, false);
+
+	// Test case 5 (the same system with 7x - 9y <= 5 has the single solution (2, 1) found by the splinters)
+	TestOmegaTestInternal({ { 11, -11, 7, -7 },{ 13, -13, -9, 9 } }, { 45, -27, 5, 10 }, true);
+
+	// Test case 6 (no real solution)
+	TestOmegaTestInternal({ { 1, -1 },{ 1, -1 } }, { 3, -4 }, false);
+
+	// Test case 7 (system without variables)
+	TestOmegaTestInternal({ { 0, 0 } }, { 1, 0 }, true);
+	TestOmegaTestInternal({ { 0, 0 } }, { 1, -1 }, false);
+
+	// Test case 8 (integer bounds of a variable whose range spans most of long long: -4e18 <= x <= 4e18)
+	RowVector<long long> lower(0), upper(0);
+	assert(FindIntegerBounds({ { 1, -1 } }, { 4000000000000000000LL, 4000000000000000000LL }, lower, upper));
+	assert(lower(0) == -4000000000000000000LL && upper(0) == 4000000000000000000LL);
+
+	// Test case 9 (invalid arguments)
+	bool thrown(false);
+	try
+	{
+		OmegaTest(MatrixExt<long long>(2, 2), RowVector<long long>(3));
+	}
+	catch (const std::logic_error&)
+	{
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+void TestOmegaEnumerateIntegerSolutions()
+{
+	// Test case 1 (triangle 0 <= x, 0 <= y, 2x + 3y <= 12)
+	TestOmegaEnumerateInternal({ { -1, 0, 2 },{ 0, -1, 3 } }, { 0, 0, 12 });
+
+	// Test case 2 (thin slab 1 <= 3x - 3y <= 2 within a box has real but no integer solutions)
+	TestOmegaEnumerateInternal({ { 3, -3, 1, -1, 0, 0 },{ -3, 3, 0, 0, 1, -1 } }, { 2, -1, 10, 10, 10, 10 });
+
+	// Test case 3 (randomly generated bounded systems)
+	std::mt19937 generator(2016);
+	std::uniform_int_distribution<int> coeff_distr(-4, 4), const_distr(-6, 12);
+	for (auto test = 0; test < 150; ++test)
+	{
+		arma::uword var_cnt(1 + test % 3), extra_cnt(1 + test % 4);
+		MatrixExt<long long> A(var_cnt, 2 * var_cnt + extra_cnt);
+		RowVector<long long> c(2 * var_cnt + extra_cnt);
+		A.zeros();
+		c.zeros();
+
+		/** Every variable is within [-5, 5] so the solution set is finite. */
+		for (auto i = 0U; i < var_cnt; ++i)
+		{
+			A(i, 2 * i) = 1;
+			A(i, 2 * i + 1) = -1;
+			c(2 * i) = 5;
+			c(2 * i + 1) = 5;
+		}
+
+		for (auto j = 2 * var_cnt; j < A.n_cols; ++j)
+		{
+			for (auto i = 0U; i < var_cnt; ++i)
+				A(i, j) = coeff_distr(generator);
+			c(j) = const_distr(generator);
+		}
+
+		TestOmegaEnumerateInternal(A, c);
+	}
+}
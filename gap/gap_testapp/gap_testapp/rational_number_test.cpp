@@ -33,11 +33,16 @@
 /// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "rational_number_test.h"
+#include "test_utils.h"
 #include <gap_util/rational_number.hpp>
+#include <gap_util/checked_arithmetic.h>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 #include <string>
 #include <sstream>
 #include <cassert>
+#include <vector>
 
 void TestConstruction()
 {
@@ -143,4 +148,157 @@ void TestOutput()
 	ss << a + b;
 	ss_expected << "(" << (a + b).numerator() << " / " << (a + b).denominator() << ")";
 	assert(ss.str() == ss_expected.str());*/
-}
\ No newline at end of file
+}
+static bool IsRational(const gap::util::Rational<long long>& value, long long numerator, long long denominator)
+{
+	return value.numerator() == numerator && value.denominator() == denominator;
+}
+
+void TestCheckedArithmetic()
+{
+	using gap::util::Rational;
+	using gap::util::BigInteger;
+
+#ifdef GAP_UTIL_HAS_INT128
+	const gap::util::RationalTier slow_tier(gap::util::RATIONAL_TIER_WIDE);
+#else
+	const gap::util::RationalTier slow_tier(gap::util::RATIONAL_TIER_BIG);
+#endif
+
+	// Fast tier
+	gap::util::ResetRationalStatistics();
+	assert(IsRational(Rational<long long>(1, 2) + Rational<long long>(1, 3), 5, 6));
+	assert(IsRational(Rational<long long>(4, 9) / Rational<long long>(-2, 3), -2, 3));
+	assert(gap::util::GetRationalStatistics().hits[gap::util::RATIONAL_TIER_FAST] == 2);
+	assert(gap::util::GetRationalStatistics().hits[slow_tier] == 0);
+
+	// Intermediate values overflow, reduced results fit
+	Rational<long long> a((1LL << 62) + 1, 2LL), b(-(1LL << 62) + 1, 2LL);
+	assert(IsRational(a + b, 1, 1));
+	assert(IsRational(a - a, 0, 1));
+	assert(IsRational(Rational<long long>(1LL << 62, 3LL) * Rational<long long>(3LL, 1LL << 61), 2, 1));
+	assert(IsRational(Rational<long long>(3LL, 1LL << 61) / Rational<long long>(3LL, 1LL << 62), 2, 1));
+	assert(gap::util::GetRationalStatistics().hits[slow_tier] == 4);
+
+	// Reduced result doesn't fit
+	try
+	{
+		Rational<long long>(std::numeric_limits<long long>::max()) + 1LL;
+		assert(false);
+	}
+	catch (const std::overflow_error&)
+	{
+		assert(gap::util::GetRationalStatistics().hits[gap::util::RATIONAL_TIER_OVERFLOW] == 1);
+	}
+
+	// BigInteger
+	long long value;
+	BigInteger big(1LL << 62);
+	BigInteger product(big * big * BigInteger(-3)), quotient, remainder;
+	assert(!product.ToLongLong(value) && product.IsNegative());
+	BigInteger::DivMod(product, big * big, quotient, remainder);
+	assert(quotient.ToLongLong(value) && value == -3 && remainder.IsZero());
+	BigInteger::DivMod(product + BigInteger(1), big, quotient, remainder);
+	assert(quotient == BigInteger(-3) * big + BigInteger(1) && remainder == BigInteger(1) - big);
+	BigInteger::DivMod(BigInteger(-7), BigInteger(2), quotient, remainder);
+	assert(quotient == BigInteger(-3) && remainder == BigInteger(-1));
+	assert(BigInteger::Gcd(product, BigInteger(-6) * big) == BigInteger(6) * big);
+	assert(BigInteger::Gcd(BigInteger(-12), BigInteger(18)) == BigInteger(6));
+	assert(BigInteger(std::numeric_limits<long long>::min()).ToLongLong(value) && value == std::numeric_limits<long long>::min());
+	assert((BigInteger(5) - BigInteger(5)).IsZero() && !(BigInteger(5) - BigInteger(5)).IsNegative());
+}
+
+void TestExactComparisons()
+{
+	using gap::util::Rational;
+
+	// Values closer than the epsilon used for floating point comparisons
+	Rational<long long> a(1LL, 10000000LL), b(1LL, 9999999LL);
+	assert(a < b && a <= b && b > a && b >= a && a != b && !(a == b));
+	assert(!(b < a) && !(a > b) && !(a >= b) && !(b <= a));
+
+	// Equal denominators, integral operands, zero and signs
+	assert(Rational<long long>(3LL, 7LL) < Rational<long long>(4LL, 7LL));
+	assert(Rational<long long>(-1LL, 3LL) < 0LL && 0LL < Rational<long long>(1LL, 3LL) && Rational<long long>() == 0LL);
+	assert(Rational<long long>(14LL, 7LL) == 2LL && 2LL >= Rational<long long>(13LL, 7LL) && 2LL != Rational<long long>(13LL, 7LL));
+	assert(gap::util::Sign(Rational<long long>(-5LL, 2LL)) == -1 && gap::util::Sign(Rational<long long>()) == 0);
+
+	// Cross products overflow 64 bits (values differ by less than the precision of double)
+	Rational<long long> c((1LL << 62) + 1, 2LL), d(std::numeric_limits<long long>::max(), 4LL), e((1LL << 62) + 1, 3LL);
+	assert(c > d && d < c && c != d && -1LL * c < -1LL * d);
+	assert(e < c && c > e && e <= c && !(e == c));
+}
+
+void TestNormalization()
+{
+	using gap::util::Rational;
+	using gap::util::BinaryGcd;
+	const long long max_value(std::numeric_limits<long long>::max()), min_value(std::numeric_limits<long long>::min());
+
+	// Binary GCD
+	assert(BinaryGcd(0LL, 0LL) == 0ULL && BinaryGcd(0LL, -5LL) == 5ULL && BinaryGcd(12LL, 0LL) == 12ULL);
+	assert(BinaryGcd(-12LL, 18LL) == 6ULL && BinaryGcd(48LL, 180LL) == 12ULL && BinaryGcd(17LL, 5LL) == 1ULL);
+	assert(BinaryGcd(max_value, max_value - 1) == 1ULL && BinaryGcd(min_value, 1LL << 40) == (1ULL << 40));
+	assert(BinaryGcd(min_value, min_value) == (1ULL << 63));
+
+	// Eager normalization (default)
+	assert(IsRational(Rational<long long>(max_value, max_value - 1), max_value, max_value - 1));
+	assert(IsRational(Rational<long long>(-(1LL << 62), 1LL << 40), -(1LL << 22), 1));
+	assert(IsRational(Rational<long long>(6LL, -4LL), -3, 2) && IsRational(Rational<long long>(0LL, -4LL), 0, 1));
+
+	// Lazy normalization reduces only fractions whose numerator or denominator exceeds the threshold
+	gap::util::SetRationalNormalizationThreshold(gap::util::RATIONAL_LAZY_NORMALIZATION_THRESHOLD);
+	Rational<long long> a(2LL, 4LL), b(1LL, 2LL), c(1LL << 40, 1LL << 41), d(8LL, 4LL);
+	assert(IsRational(a, 2, 4) && IsRational(c, 1, 2) && IsRational(Rational<long long>(0LL, -4LL), 0, 1));
+	assert(a == b && !(a < b) && a + b == 1LL && a * d == 1LL && static_cast<long long>(d) == 2LL);
+	try
+	{
+		static_cast<long long>(Rational<long long>(6LL, 4LL));
+		assert(false);
+	}
+	catch (const std::runtime_error&)
+	{
+	}
+	gap::util::SetRationalNormalizationThreshold(0);
+	assert(IsRational(Rational<long long>(2LL, 4LL), 1, 2));
+}
+
+namespace
+{
+	/** Sums first n_terms fractions (-1)^k / (k % 8 + 1), which keeps numerators and denominators small. */
+	long double SumFractions(int n_terms)
+	{
+		gap::util::Rational<long long> sum;
+		for (int k = 0; k < n_terms; ++k)
+			sum += gap::util::Rational<long long>(k % 2 ? -1LL : 1LL, k % 8 + 1LL);
+		return sum;
+	}
+}
+
+void BenchmarkRationalNormalization()
+{
+	const int n_ops(1000000);
+	std::vector<long long> values(n_ops);
+	for (int i = 0; i < n_ops; ++i)
+		values[i] = 1 + (i * 2654435761LL) % 1000003;
+
+	long long checksum(0);
+	double echelon_gcd = MeasureNanoseconds(n_ops, [&]() {
+		for (int i = 1; i < n_ops; ++i)
+			checksum += gap::util::gcd(gap::util::ColVector<long long>({ values[i - 1], values[i] }));
+	});
+	double binary_gcd = MeasureNanoseconds(n_ops, [&]() {
+		for (int i = 1; i < n_ops; ++i)
+			checksum += static_cast<long long>(gap::util::BinaryGcd(values[i - 1], values[i]));
+	});
+
+	long double sum(0);
+	double eager = MeasureNanoseconds(n_ops, [&]() { sum += SumFractions(n_ops); });
+	gap::util::SetRationalNormalizationThreshold(gap::util::RATIONAL_LAZY_NORMALIZATION_THRESHOLD);
+	double lazy = MeasureNanoseconds(n_ops, [&]() { sum += SumFractions(n_ops); });
+	gap::util::SetRationalNormalizationThreshold(0);
+
+	std::cout << "gcd of a pair: ReduceToEchelon " << echelon_gcd << " ns, binary " << binary_gcd << " ns\n";
+	std::cout << "Rational addition: eager normalization " << eager << " ns, lazy normalization " << lazy << " ns\n";
+	std::cout << "(checksums " << checksum << ", " << sum << ")\n";
+}
@@ -38,10 +38,19 @@
 void TestConstruction();
 void TestArithmeticLogicOps();
 void TestOutput();
+void TestCheckedArithmetic();
+void TestExactComparisons();
+void TestNormalization();
+
+/** Prints the per-operation cost of eager and lazy Rational normalization. */
+void BenchmarkRationalNormalization();
 
 #define RUN_RATIONAL_NUMBER_TESTS()		\
 	TestConstruction();					\
 	TestArithmeticLogicOps();			\
-	TestOutput();
+	TestOutput();						\
+	TestCheckedArithmetic();			\
+	TestExactComparisons();				\
+	TestNormalization();
 
 #endif /// GAP_TESTAPP_RATIONAL_NUMBER_TEST_H
@@ -37,6 +37,7 @@
 #include <gap_util/row_vector.h>
 #include <gap_util/column_vector.h>
 #include <cassert>
+#include <stdexcept>
 
 using namespace arma;
 using namespace gap::util;
@@ -221,3 +222,41 @@ void TestColVectorDiagonalization()
     e.ReduceToDiagonal(U, V, D);
     assert(CompareMatrices(U*e*V, D));
 }
+
+void TestVectorExpressions()
+{
+    RowVector<long long> a{ 1, 2, 3, 4 };
+    MatrixExt<long long> A{ { 1, 0, 2 }, { 0, 1, 0 }, { 1, 1, 1 }, { 5, 5, 5 } };
+    ColVector<long long> c{ 1, -1, 2, 0 };
+
+    /** Armadillo expressions are evaluated directly into row and column vectors. */
+    RowVector<long long> r(a(0, span(0, 2)) * A(span(0, 2), span::all));
+    assert(CompareMatrices(r, { { 4, 5, 5 } }));
+    r = a(0, span(1, 3)) * A(span(1, 3), span::all);
+    assert(CompareMatrices(r, { { 23, 25, 23 } }));
+    ColVector<long long> col(A(span::all, 0) + A(span::all, 2));
+    assert(CompareMatrices(col, { { 3 }, { 0 }, { 2 }, { 10 } }));
+    assert(a * c == 5);
+
+    bool thrown(false);
+    try
+    {
+        RowVector<long long> not_row(A(span(0, 1), span::all) * 2LL);
+    }
+    catch (const std::logic_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    /** Vectors larger than armadillo's preallocated storage are moved, not copied, which must not break the dimension checks. */
+    MatrixExt<long long> X(1, 40, fill::ones), Y(40, 1, fill::ones);
+    RowVector<long long> x(std::move(X));
+    ColVector<long long> y(std::move(Y));
+    RowVector<long long> x_moved(std::move(x));
+    assert(x_moved.n_cols == 40 && y.n_rows == 40 && x_moved * y == 40);
+
+    /** Copying a matrix into a column vector keeps its elements. */
+    const MatrixExt<long long> Z{ { 7 }, { -3 } };
+    assert(CompareMatrices(ColVector<long long>(Z), Z));
+}
@@ -44,6 +44,8 @@ void TestColVectorEchelonReduction();
 void TestColVectorEchelonReduction2();
 void TestColVectorDiagonalization();
 
+void TestVectorExpressions();
+
 #define RUN_ROW_COL_VECTOR_TESTS() \
     TestRowVectorArithmeticOps(); \
     TestGetLevel(); \
@@ -51,6 +53,7 @@ void TestColVectorDiagonalization();
     TestColVectorArithmeticOps(); \
     TestColVectorEchelonReduction(); \
     TestColVectorEchelonReduction2(); \
-    TestColVectorDiagonalization()
+    TestColVectorDiagonalization(); \
+    TestVectorExpressions()
 
 #endif /// GAP_TESTAPP_ROW_COL_VECTOR_TEST
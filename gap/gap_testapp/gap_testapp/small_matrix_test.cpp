@@ -0,0 +1,187 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "small_matrix_test.h"
+#include <gap_util/small_matrix.h>
+#include <gap_util/diophantine.h>
+#include <cassert>
+#include <stdexcept>
+#include "test_utils.h"
+
+using namespace arma;
+using namespace gap::util;
+
+namespace
+{
+	/** Checks that S is echelon matrix of the given rank and that UA = S. */
+	bool IsEchelonReduction(const MatrixExt<long long>& A, const SmallMatrix<long long>& U, const SmallMatrix<long long>& S, uword rank)
+	{
+		if (!S.IsEchelon() || !CompareMatrices(U.ToMatrixExt() * A, S.ToMatrixExt()))
+			return false;
+
+		for (auto i = 0U; i < S.n_rows; ++i)
+		{
+			if ((S.GetRowLevel(i) < S.n_cols) != (i < rank))
+				return false;
+		}
+		return true;
+	}
+}
+
+void TestSmallMatrixConstruction()
+{
+	SmallMatrix<long long> A(3, 4);
+	assert(A.n_rows == 3 && A.n_cols == 4 && A(2, 3) == 0);
+
+	MatrixExt<long long> B = { { 1, 2, 3 }, { -4, 5, 6 } };
+	SmallMatrix<long long> C(B);
+	assert(C.n_rows == 2 && C.n_cols == 3 && C(1, 0) == -4);
+	assert(CompareMatrices(C.ToMatrixExt(), B));
+
+	SmallRowVector<long long> t(5);
+	t(4) = 7;
+	assert(t.n_rows == 1 && t.n_cols == 5 && t(0, 4) == 7);
+	assert(CompareMatrices<long long>(t.ToRowVector(3, 2), RowVector<long long>({ 0, 7 })));
+
+	assert(SmallMatrix<long long>::Fits(SMALL_MATRIX_CAPACITY, SMALL_MATRIX_CAPACITY));
+	assert(!SmallMatrix<long long>::Fits(SMALL_MATRIX_CAPACITY + 1, 1));
+	try
+	{
+		SmallMatrix<long long, 4, 4> D(4, 5);
+		assert(false);
+	}
+	catch (const std::range_error&)
+	{
+	}
+}
+
+void TestSmallMatrixOperations()
+{
+	MatrixExt<long long> A = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 10 } };
+	SmallMatrix<long long> B(A);
+
+	B.DoReversalOperation(1, true).DoInterchangeOperation(0, 2, false).DoSkewingOperation(0, 2, 3, true);
+	MatrixExt<long long> C(A);
+	C.DoReversalOperation(1, true).DoInterchangeOperation(0, 2, false).DoSkewingOperation(0, 2, 3, true);
+	assert(CompareMatrices(B.ToMatrixExt(), C));
+
+	B.DoSkewingOperation(1, 0, -2, false);
+	C.DoSkewingOperation(1, 0, -2, false);
+	assert(CompareMatrices(B.ToMatrixExt(), C));
+
+	try
+	{
+		B.DoSkewingOperation(1, 1, 2, true);
+		assert(false);
+	}
+	catch (const std::logic_error&)
+	{
+	}
+
+	MatrixExt<long long> D = { { 1, -1 }, { 0, 2 }, { 3, 1 } };
+	assert(CompareMatrices((SmallMatrix<long long>(A) * SmallMatrix<long long>(D)).ToMatrixExt(), MatrixExt<long long>(A * D)));
+
+	assert(SmallMatrix<long long>(A).ComputeRank() == 3);
+	assert(SmallMatrix<long long>(MatrixExt<long long>({ { 1, 2 }, { 2, 4 }, { 0, 0 } })).ComputeRank() == 1);
+}
+
+void TestSmallMatrixEchelonReduction()
+{
+	std::vector<MatrixExt<long long>> matrices = {
+		{ { 4, 4, 1 }, { 6, 0, 1 }, { 4, 3, 2 } },
+		{ { 3, 1, -2, 4 }, { 1, 0, 2, 3 }, { 2, 1, -1, 1 } },
+		{ { 1, -4 }, { -5, 0 }, { 1, -6 }, { 0, 0 }, { 8, -1 }, { -3, 3 } },
+		{ { -1, 3, 0 }, { 0, -4, 1 }, { 0, 0, 9 }, { 0, 0, 0 } },
+		{ { 0, 1, 2 }, { 0, 1, 5 }, { 0, 2, 4 } },		/** Zero leading column. */
+		{ { 0, 0 }, { 0, 0 } }
+	};
+	const uword ranks[] = { 3, 3, 2, 3, 2, 0 };
+
+	for (auto i = 0U; i < matrices.size(); ++i)
+	{
+		SmallMatrix<long long> A(matrices[i]), U, S, V;
+		uword rank = A.ReduceToEchelon(U, S);
+		assert(rank == ranks[i] && IsEchelonReduction(matrices[i], U, S, rank));
+
+		/** Matrices U and S are the same as the ones calculated by MatrixExt. */
+		MatrixExt<long long> U_ext(A.n_rows, A.n_rows), S_ext(A.n_rows, A.n_cols);
+		matrices[i].ReduceToEchelon(U_ext, S_ext);
+		assert(CompareMatrices(S.ToMatrixExt(), S_ext) && CompareMatrices(U.ToMatrixExt(), U_ext));
+
+		rank = A.ReduceToEchelon2(V, S);
+		assert(rank == ranks[i] && S.IsEchelon() && CompareMatrices((V * S).ToMatrixExt(), matrices[i]));
+
+		/** None of the matrices is unimodular, unlike U whose inverse is the same as the one calculated by MatrixExt. */
+		SmallMatrix<long long> A_inv, U_inv;
+		assert(!A.InvertUnimodular(A_inv));
+		assert(U.InvertUnimodular(U_inv));
+		MatrixExt<long long> U_inv_ext(0, 0);
+		assert(U_ext.InvertUnimodular(U_inv_ext) && CompareMatrices(U_inv.ToMatrixExt(), U_inv_ext));
+		assert(CompareMatrices((U * U_inv).ToMatrixExt(), MatrixExt<long long>(U.n_rows, U.n_rows, arma::fill::eye)));
+	}
+}
+
+void TestSmallMatrixDiophantineSystem()
+{
+	MatrixExt<long long> A = { { 2, 1 }, { -4, 3 }, { 6, 0 }, { 1, -1 } };
+	RowVector<long long> c = { 5, 3 };
+
+	MatrixExt<long long> U(A.n_rows, A.n_rows);
+	RowVector<long long> t(A.n_rows);
+	uword rank_s;
+	assert(SolveDiophantineSystem(A, c, U, t, rank_s));
+
+	SmallMatrix<long long> small_U;
+	SmallRowVector<long long> small_c(c.n_cols), small_t;
+	small_c(0) = c(0);
+	small_c(1) = c(1);
+	uword small_rank_s;
+	assert(SolveDiophantineSystem(SmallMatrix<long long>(A), small_c, small_U, small_t, small_rank_s));
+	assert(small_rank_s == rank_s && CompareMatrices(small_U.ToMatrixExt(), U));
+	assert(CompareMatrices<long long>(small_t.ToRowVector(0, t.n_cols), t));
+
+	/** Every x = tU with the determined components of t is a solution of xA = c. */
+	small_t(2) = 5;
+	small_t(3) = -3;
+	RowVector<long long> x((small_t * small_U).ToRowVector(0, A.n_rows));
+	assert(CompareMatrices<long long>(RowVector<long long>(x * A), c));
+
+	/** 2x1 + 4x2 = 3 has no integer solution. */
+	SmallMatrix<long long> B(2, 1);
+	B(0, 0) = 2;
+	B(1, 0) = 4;
+	SmallRowVector<long long> d(1);
+	d(0) = 3;
+	assert(!SolveDiophantineSystem(B, d, small_U, small_t, small_rank_s));
+}
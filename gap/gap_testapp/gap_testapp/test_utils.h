@@ -37,6 +37,7 @@
 
 #include <gap_util/matrix_ext.h>
 #include <cmath>
+#include <chrono>
 
 template<typename T>
 inline bool IsApproximatelyEqual(T v1, T v2)
@@ -83,4 +84,14 @@ gap::util::MatrixExt<T> signum(const gap::util::MatrixExt<T>& in)
 	return out;
 }
 
+/** Returns average duration of a single operation in nanoseconds, when f performs n_ops operations. Used by the benchmarks. */
+template<typename F>
+double MeasureNanoseconds(int n_ops, F f)
+{
+	auto start = std::chrono::steady_clock::now();
+	f();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / n_ops;
+}
+
 #endif /// GAP_TESTAPP_UTILS_H
\ No newline at end of file
@@ -0,0 +1,87 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "thread_pool_test.h"
+#include <gap_util/thread_pool.h>
+#include <stdexcept>
+#include <vector>
+#include <cassert>
+
+using namespace gap::util;
+
+static void TestThreadPoolInternal(unsigned thread_cnt, std::size_t task_cnt)
+{
+	ThreadPool pool(thread_cnt);
+	assert(pool.GetThreadCnt() == thread_cnt);
+
+	/// Each task writes only to its own slot, worker index must be in range
+	std::vector<std::size_t> results(task_cnt, 0);
+	std::vector<unsigned> workers(task_cnt, thread_cnt);
+	for (std::size_t i = 0; i < task_cnt; ++i)
+		pool.Submit([&, i](unsigned worker_idx) { results[i] = i * i; workers[i] = worker_idx; });
+	pool.Wait();
+
+	for (std::size_t i = 0; i < task_cnt; ++i)
+	{
+		assert(results[i] == i * i && "Task wasn't executed");
+		assert(workers[i] < thread_cnt && "Invalid worker index passed to the task");
+	}
+
+	/// Exception thrown by a task has to be propagated by Wait() and the pool must remain usable
+	bool caught(false);
+	pool.Submit([](unsigned) { throw std::runtime_error("task failure"); });
+	try
+	{
+		pool.Wait();
+	}
+	catch (const std::runtime_error&)
+	{
+		caught = true;
+	}
+	assert(caught && "Task exception wasn't propagated by Wait()");
+
+	bool executed(false);
+	pool.Submit([&](unsigned) { executed = true; });
+	pool.Wait();
+	assert(executed && "Pool is not usable after task has failed");
+}
+
+void TestThreadPool()
+{
+	TestThreadPoolInternal(1, 0);
+	TestThreadPoolInternal(1, 10);
+	TestThreadPoolInternal(4, 3);
+	TestThreadPoolInternal(4, 1000);
+	TestThreadPoolInternal(16, 100);
+}
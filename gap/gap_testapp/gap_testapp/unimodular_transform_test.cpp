@@ -79,16 +79,20 @@ namespace
 			}
 			else
 			{
-				unsigned int n = FindOuterLoopTransformMatrix(distance_vectors, U);
-				assert(n == m - rank_d);
-				assert((transform_exists && n > 0) || (!transform_exists && n == 0));
-				MatrixExt<long long> DU(n > 0 ? std::move(D * U) : D);
-				// Verify that each row has level = n + 1 where n = m - rank_d (first n columns of DU are zero columns)
-				if (dependence_exists && n > 0)
-					for (auto i = 0U; i < DU.n_rows; ++i)
-						assert(DU.GetRowLevel(i) == n);
-				else if (!dependence_exists)
-					assert(CompareMatrices(D, D * U));
+				// Both echelon reductions must produce a valid transformation (not necessarily the same one)
+				for (auto algorithm : { ECHELON_EUCLID, ECHELON_HERMITE })
+				{
+					unsigned int n = FindOuterLoopTransformMatrix(distance_vectors, U, algorithm);
+					assert(n == m - rank_d);
+					assert((transform_exists && n > 0) || (!transform_exists && n == 0));
+					MatrixExt<long long> DU(n > 0 ? std::move(D * U) : D);
+					// Verify that each row has level = n + 1 where n = m - rank_d (first n columns of DU are zero columns)
+					if (dependence_exists && n > 0)
+						for (auto i = 0U; i < DU.n_rows; ++i)
+							assert(DU.GetRowLevel(i) == n);
+					else if (!dependence_exists)
+						assert(CompareMatrices(D, D * U));
+				}
 			}
 
 			assert(!should_throw);
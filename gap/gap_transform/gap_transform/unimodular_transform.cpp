@@ -33,6 +33,7 @@
 /// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "unimodular_transform.h"
+#include <gap_util/small_matrix.h>
 #include <functional>
 #include <algorithm>
 #include <stdexcept>
@@ -110,6 +111,68 @@ namespace
 		return idx_first_nonzero_el;
 	}
 
+	/**
+	 * @brief Calculates exact inverse of unimodular matrix U (see MatrixExt::InvertUnimodular()). Nest-sized matrices are inverted on
+	 * SmallMatrix, so that only the result is allocated.
+	 *
+	 * @throw std::logic_error if U is not a unimodular matrix
+	 */
+	gap::util::MatrixExt<long long> InvertUnimodular(const gap::util::MatrixExt<long long>& U)
+	{
+		gap::util::MatrixExt<long long> U_inv(U.n_rows, U.n_rows);
+		bool is_unimodular(false);
+		if (gap::util::SmallMatrix<long long>::Fits(U.n_rows, U.n_cols))
+		{
+			gap::util::SmallMatrix<long long> small_U_inv;
+			is_unimodular = gap::util::SmallMatrix<long long>(U).InvertUnimodular(small_U_inv);
+			if (is_unimodular)
+				U_inv = small_U_inv.ToMatrixExt();
+		}
+		else
+			is_unimodular = U.InvertUnimodular(U_inv);
+
+		if (!is_unimodular)
+			throw std::logic_error("InvertUnimodular(): Matrix U is not unimodular");
+
+		return U_inv;
+	}
+
+	/**
+	 * @brief Reduces matrix A to echelon matrix S and calculates unimodular matrix U such that UA = S, or A = US when modified is TRUE (see
+	 * MatrixExt::ReduceToEchelon() and MatrixExt::ReduceToEchelon2()). Nest-sized matrices are reduced on SmallMatrix, so that elementary
+	 * operations don't allocate memory. ECHELON_HERMITE computes Hermite Normal Form WA = S instead, and U = W^-1 when modified is TRUE.
+	 *
+	 * @retval Rank of matrix S
+	 */
+	unsigned int ReduceToEchelon(
+		const gap::util::MatrixExt<long long>& A
+		, gap::util::MatrixExt<long long>& U
+		, gap::util::MatrixExt<long long>& S
+		, bool modified
+		, gap::util::EchelonAlgorithm algorithm)
+	{
+		if (algorithm == gap::util::ECHELON_HERMITE)
+		{
+			if (!modified)
+				return gap::util::ComputeHermiteNormalForm(A, U, S);
+
+			gap::util::MatrixExt<long long> W(A.n_rows, A.n_rows);
+			unsigned int rank(gap::util::ComputeHermiteNormalForm(A, W, S));
+			U = InvertUnimodular(W);
+			return rank;
+		}
+
+		if (!gap::util::SmallMatrix<long long>::Fits(A.n_rows, A.n_cols))
+			return modified ? A.ReduceToEchelon2(U, S) : A.ReduceToEchelon(U, S);
+
+		const gap::util::SmallMatrix<long long> small_A(A);
+		gap::util::SmallMatrix<long long> small_U, small_S;
+		unsigned int rank(modified ? small_A.ReduceToEchelon2(small_U, small_S) : small_A.ReduceToEchelon(small_U, small_S));
+		U = small_U.ToMatrixExt();
+		S = small_S.ToMatrixExt();
+		return rank;
+	}
+
 } // unnamed namespace
 
 	unsigned int FindInnerLoopTransformMatrix(
@@ -143,7 +206,8 @@ namespace
 
 	unsigned int FindOuterLoopTransformMatrix(
 		const std::vector<gap::util::RowVector<long long>>& distance_vectors
-		, gap::util::MatrixExt<long long>& U)
+		, gap::util::MatrixExt<long long>& U
+		, gap::util::EchelonAlgorithm algorithm)
 	{
 		if (distance_vectors.empty())
 			throw std::logic_error("FindOuterLoopTransformMatrix(): Set of distance vectors cannot be empty.");
@@ -160,7 +224,7 @@ namespace
 		/** 2. Find mxm matrix V and mxN matrix S such that: V*D' = S where V is unimodular and S is echelon matrix.					*/
 		gap::util::MatrixExt<long long> V(m, m);
 		gap::util::MatrixExt<long long> S(m, D_transpose.n_cols);
-		unsigned int rank_d = D_transpose.ReduceToEchelon(V, S);
+		unsigned int rank_d = ReduceToEchelon(D_transpose, V, S, false, algorithm);
 
 		if (rank_d == m)
 		{
@@ -195,7 +259,7 @@ namespace
 		/**																																*/
 		U = std::move(gap::util::MatrixExt<long long>(m, m));
 		gap::util::MatrixExt<long long> T(m, n + 1);
-		A.ReduceToEchelon2(U, T);
+		ReduceToEchelon(A, U, T, true, algorithm);
 	
 		if (T(n, n) < 0)
 		{
@@ -220,13 +284,11 @@ namespace
 
 		unsigned int m(U.n_rows);
 
-		/** 1. Calculate matrices V = U^-1 * P and W = U^-1 * Q.																		*/
-		gap::util::MatrixExt<long long> U_inv(
-			std::move(gap::util::MatrixExt<double>(
-				arma::inv(std::move(gap::util::MatrixExt<double>(U))).eval())));
+		/** 1. Calculate matrices V = U^-1 * P and W = U^-1 * Q. U^-1 is integer matrix and it is calculated exactly.				*/
+		const gap::util::MatrixExt<long long> U_inv(InvertUnimodular(U));
 
-		gap::util::MatrixExt<long long> V(std::move(U_inv * P));
-		gap::util::MatrixExt<long long> W(std::move(U_inv * Q));
+		gap::util::MatrixExt<long long> V(U_inv * P);
+		gap::util::MatrixExt<long long> W(U_inv * Q);
 
 		/** 2. Form system xA <= c from system p0 <= V*P and W*Q <= q0.																	*/
 		gap::util::MatrixExt<long long> A(m, 2 * m);
@@ -237,8 +299,11 @@ namespace
 		c(0, arma::span(0, m - 1)) = -1 * p0(0, arma::span(0, m - 1));
 		c(0, arma::span(m, 2 * m - 1)) = q0(0, arma::span(0, m - 1));
 
-		/** 3. Use PerformFourierElimination() to find lower and upper limits for K1,K2,...,Km.											*/
-		if (!gap::util::PerformFourierElimination(A, c, b, B))
+		/** 3. Use PerformFourierElimination() to find lower and upper limits for K1,K2,...,Km. The system is integer, so it is		*/
+		/**    solved by the fraction-free elimination.																				*/
+		gap::util::FourierEliminationOptions options;
+		options.arithmetic = gap::util::FOURIER_INTEGER;
+		if (!gap::util::PerformFourierElimination(A, c, b, B, options))
 		{
 			/** This should never happen as long as limits of nest L are correctly specified (even if L -> LU is invalid).				*/
 			throw std::runtime_error("CalculateTransformedNestLimits(): Failed to calculate limits for LU (should never happen)");
@@ -37,6 +37,7 @@
 
 #include <gap_util/row_vector.h>
 #include <gap_util/fourier_elimination.h>
+#include <gap_util/normal_form.h>
 
 namespace gap
 {
@@ -87,6 +88,8 @@ namespace tran
 	 * @param
 	 *        -> const std::vector<RowVector<int>>& - vector of dependence distance vectors of given loop nest
 	 *        -> MatrixExt<int>& - unimodular matrix U that will transform L -> LU
+	 *        -> EchelonAlgorithm - algorithm used for both echelon reductions (ECHELON_HERMITE keeps the entries of U small on
+	 *           deep nests, see normal_form.h)
 	 *
 	 * @reval Number of outer loops in LU that has no data dependencies and therefore can run in parallel (0 if there are
 	 *        no such loops, for example when rank(D) = m).
@@ -96,7 +99,8 @@ namespace tran
 	 */
 	unsigned int FindOuterLoopTransformMatrix(
 		const std::vector<gap::util::RowVector<long long>>& distance_vectors
-		, util::MatrixExt<long long>& U);
+		, util::MatrixExt<long long>& U
+		, util::EchelonAlgorithm algorithm = util::ECHELON_EUCLID);
 
 
 	/**
@@ -133,6 +137,8 @@ namespace tran
 	 * this: (I1,I2,I3) = (K3,K1,K2) * U^-1. If we continue to use previous definition of mapping I -> K, then it'll be like applying
 	 * additional transformation to loop LU that will yield loop LU' - and this mustn't happen!
 	 *
+	 * @throw std::logic_error if dimensions are not consistent or U is not unimodular
+	 *
 	 * @see Loop Transformations for Restructuring Compilers, Loop Parallelization (section 3.6) and fourier_elimination.h
 	 */
 	void CalculateTransformedNestLimits(
@@ -0,0 +1,260 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "bound_set.h"
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+
+namespace gap
+{
+namespace util
+{
+
+	namespace
+	{
+
+		const unsigned long long MAX_MAGNITUDE(static_cast<unsigned long long>(std::numeric_limits<long long>::max()));
+
+		unsigned long long Magnitude(long long value)
+		{
+			return value < 0 ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+		}
+
+		/** Returns a * b. @throw std::overflow_error if the result doesn't fit into long long. */
+		long long CheckedMultiply(long long a, long long b)
+		{
+			long long result;
+			if (MulOverflow(a, b, result))
+				throw std::overflow_error("c2cuda::BoundSet::BoundSet(): bound function can't be represented with long long numerators");
+			return result;
+		}
+
+		/** Rounds x / y towards -oo, y must be positive. */
+		long long FloorDiv(long long x, long long y)
+		{
+			long long q(x / y);
+			return (x % y != 0 && x < 0) ? q - 1 : q;
+		}
+
+		/** Rounds x / y towards +oo, y must be positive. */
+		long long CeilDiv(long long x, long long y)
+		{
+			long long q(x / y);
+			return (x % y != 0 && x > 0) ? q + 1 : q;
+		}
+
+		/** Checks if bound of some variable is the infinite initial bound of PerformFourierElimination(). */
+		bool IsInfiniteBound(const Bound& bound)
+		{
+			return bound.second.n_cols == 1 && (bound.second(0) == std::numeric_limits<long long>::min() ||
+				bound.second(0) == std::numeric_limits<long long>::max());
+		}
+
+	} // unnamed namespace
+
+	BoundSet::BoundSet() : m_offsets(1, 0)
+	{
+	}
+
+	BoundSet::BoundSet(const std::vector<Bound>& bounds) : m_offsets(1, 0)
+	{
+		uword arena_size(0);
+		for (auto r = 0U; r < bounds.size(); ++r)
+		{
+			if (bounds[r].first.n_rows != r + 1 || bounds[r].second.n_rows != 1 || bounds[r].first.n_cols != bounds[r].second.n_cols)
+				throw std::logic_error("c2cuda::BoundSet::BoundSet(): form of the bounds is not valid");
+			if (!IsInfiniteBound(bounds[r]))
+				arena_size += bounds[r].second.n_cols * (r + 2);
+		}
+
+		m_arena.reserve(arena_size);
+		m_offsets.reserve(bounds.size() + 1);
+		m_max_constant.reserve(bounds.size());
+		m_max_coefficient.reserve(bounds.size());
+
+		for (auto r = 0U; r < bounds.size(); ++r)
+		{
+			unsigned long long max_constant(0), max_coefficient(0);
+			if (!IsInfiniteBound(bounds[r]))
+			{
+				const MatrixExt<Rational<long long>>& coeffs(bounds[r].first);
+				const RowVector<Rational<long long>>& constants(bounds[r].second);
+				for (auto k = 0U; k < constants.n_cols; ++k)
+				{
+					/** Common denominator d of the row is the LCM of the denominators of its elements. */
+					long long d(constants(k).denominator());
+					for (auto i = 0U; i < r; ++i)
+					{
+						const long long den(coeffs(i, k).denominator());
+						d = CheckedMultiply(d / static_cast<long long>(BinaryGcd(d, den)), den);
+					}
+
+					const uword row(m_arena.size());
+					m_arena.push_back(d);
+					m_arena.push_back(CheckedMultiply(constants(k).numerator(), d / constants(k).denominator()));
+					for (auto i = 0U; i < r; ++i)
+						m_arena.push_back(CheckedMultiply(coeffs(i, k).numerator(), d / coeffs(i, k).denominator()));
+
+					/** Elements of Rational numbers are not necessarily reduced (@see GetRationalNormalizationThreshold()), so the row is. */
+					unsigned long long gcd_val(0);
+					for (auto it = m_arena.begin() + row; it != m_arena.end() && gcd_val != 1; ++it)
+						gcd_val = BinaryGcd(static_cast<long long>(gcd_val), *it);
+					if (gcd_val > 1)
+					{
+						for (auto it = m_arena.begin() + row; it != m_arena.end(); ++it)
+							*it /= static_cast<long long>(gcd_val);
+					}
+
+					max_constant = std::max(max_constant, Magnitude(m_arena[row + 1]));
+					for (auto it = m_arena.begin() + row + 2; it != m_arena.end(); ++it)
+						max_coefficient = std::max(max_coefficient, Magnitude(*it));
+				}
+			}
+
+			m_offsets.push_back(m_arena.size());
+			m_max_constant.push_back(max_constant);
+			m_max_coefficient.push_back(max_coefficient);
+		}
+	}
+
+	uword BoundSet::NumVariables() const
+	{
+		return m_offsets.size() - 1;
+	}
+
+	uword BoundSet::NumBounds(uword variable) const
+	{
+		return (m_offsets[variable + 1] - m_offsets[variable]) / (variable + 2);
+	}
+
+	bool BoundSet::IsBounded(uword variable) const
+	{
+		return m_offsets[variable + 1] != m_offsets[variable];
+	}
+
+	long long BoundSet::Denominator(uword variable, uword k) const
+	{
+		return Row(variable, k)[0];
+	}
+
+	Rational<long long> BoundSet::Constant(uword variable, uword k) const
+	{
+		const long long* row(Row(variable, k));
+		return Rational<long long>(row[1], row[0]);
+	}
+
+	Rational<long long> BoundSet::Coefficient(uword variable, uword k, uword i) const
+	{
+		const long long* row(Row(variable, k));
+		return Rational<long long>(row[i + 2], row[0]);
+	}
+
+	const long long* BoundSet::Row(uword variable, uword k) const
+	{
+		return &m_arena[m_offsets[variable] + k * (variable + 2)];
+	}
+
+	long long BoundSet::CeilMax(uword variable, const RowVector<long long>& solution) const
+	{
+		return Evaluate(variable, solution, true);
+	}
+
+	long long BoundSet::FloorMin(uword variable, const RowVector<long long>& solution) const
+	{
+		return Evaluate(variable, solution, false);
+	}
+
+	long long BoundSet::Evaluate(uword variable, const RowVector<long long>& solution, bool find_max) const
+	{
+		if (!IsBounded(variable))
+			throw std::logic_error("c2cuda::BoundSet::Evaluate(): variable is not bounded");
+		if (solution.n_cols < variable)
+			throw std::logic_error("c2cuda::BoundSet::Evaluate(): solution doesn't hold values of all outer variables");
+
+		const long long* x(solution.memptr());
+		const uword width(variable + 2);
+		const long long* first(&m_arena[m_offsets[variable]]);
+		const long long* last(&m_arena[0] + m_offsets[variable + 1]);
+
+		/**
+		 * |n0 + n1 * x1 + ... + n(r-1) * x(r-1)| <= max_constant + (r - 1) * max_coefficient * max_x. If this fits into long long, none of
+		 * the rows can overflow.
+		 */
+		unsigned long long max_x(0);
+		for (auto i = 0U; i < variable; ++i)
+			max_x = std::max(max_x, Magnitude(x[i]));
+
+		const unsigned long long headroom(MAX_MAGNITUDE - m_max_constant[variable]);
+		const bool unchecked(max_x == 0 || m_max_coefficient[variable] == 0 ||
+			m_max_coefficient[variable] <= headroom / variable / max_x);
+
+		long long result(0);
+		for (const long long* row = first; row != last; row += width)
+		{
+			long long value;
+			if (unchecked)
+			{
+				long long numerator(row[1]);
+				for (auto i = 0U; i < variable; ++i)
+					numerator += row[i + 2] * x[i];
+				value = find_max ? CeilDiv(numerator, row[0]) : FloorDiv(numerator, row[0]);
+			}
+			else
+			{
+				long long numerator(row[1]), product;
+				bool overflow(false);
+				for (auto i = 0U; i < variable && !overflow; ++i)
+					overflow = MulOverflow(row[i + 2], x[i], product) || AddOverflow(numerator, product, numerator);
+
+				if (!overflow)
+					value = find_max ? CeilDiv(numerator, row[0]) : FloorDiv(numerator, row[0]);
+				else
+				{
+					Rational<long long> exact(row[1], row[0]);
+					for (auto i = 0U; i < variable; ++i)
+						exact += Rational<long long>(row[i + 2], row[0]) * x[i];
+					value = find_max ? CeilDiv(exact.numerator(), exact.denominator()) : FloorDiv(exact.numerator(), exact.denominator());
+				}
+			}
+
+			if (row == first || (find_max ? value > result : value < result))
+				result = value;
+		}
+		return result;
+	}
+
+} /// namespace util
+} /// namespace gap
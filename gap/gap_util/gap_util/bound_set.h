@@ -0,0 +1,126 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef GAP_UTIL_BOUND_SET_H
+#define GAP_UTIL_BOUND_SET_H
+
+#include <vector>
+#include <utility>
+#include "row_vector.h"
+#include "rational_number.hpp"
+
+namespace gap
+{
+namespace util
+{
+
+	/**
+		* Simple type alias that is used to represent bound of single variable xi. Fourier elimination produces set of these bounds for every variable in
+		* system.
+		*/
+	typedef std::pair<MatrixExt<Rational<long long>>, RowVector<Rational<long long>>> Bound;
+
+	/**
+	 * @brief Compact form of the lower (or the upper) bounds of all variables x1,...,xm produced by PerformFourierElimination(). Bound function k
+	 * of variable xr is stored as a row of r integers that share a single positive denominator d:
+	 *
+	 *     (n0 + n1 * x1 + ... + n(r-1) * x(r-1)) / d
+	 *
+	 * Rows of all variables are stored one after another in a single arena and the offset of the first row of each variable is precomputed. Each
+	 * row is reduced by the GCD of its elements. Compared to std::vector<Bound>, which holds 2m matrices of Rational numbers for an m-deep loop
+	 * nest, bounds of the whole nest take one allocation and bound functions are evaluated at a partial solution using integer multiply-adds only.
+	 * When the magnitudes of the numerators and of the solution guarantee that no intermediate value overflows, all rows of a variable are
+	 * evaluated without overflow checks in a loop the compiler can vectorize. Otherwise, every row is evaluated with checked arithmetic and rows
+	 * that still overflow are evaluated exactly using Rational numbers.
+	 *
+	 * Variable whose Bound holds the infinite initial bound of PerformFourierElimination() (it is not bounded from below or from above) has no
+	 * rows at all (@see IsBounded()).
+	 */
+	class BoundSet
+	{
+	public:
+		BoundSet();
+
+		/**
+		 * Converts the lower or the upper bounds returned by PerformFourierElimination(). Element r of bounds must consist of (r + 1 x k) matrix
+		 * whose last row is zero and (1 x k) vector.
+		 *
+		 * @throw std::logic_error if some of the bounds doesn't have this form. std::overflow_error is thrown if the common denominator of the
+		 * elements of some bound function or its numerators don't fit into long long.
+		 */
+		explicit BoundSet(const std::vector<Bound>& bounds);
+
+		uword NumVariables() const;
+
+		/** Returns the number of bound functions of the variable (counting starts from 0), which is zero if the variable is not bounded. */
+		uword NumBounds(uword variable) const;
+		bool IsBounded(uword variable) const;
+
+		/** Denominator d, constant part n0 / d and coefficient ni / d of variable xi (i < variable) of bound function k of the variable. */
+		long long Denominator(uword variable, uword k) const;
+		Rational<long long> Constant(uword variable, uword k) const;
+		Rational<long long> Coefficient(uword variable, uword k, uword i) const;
+
+		/** Returns bound function k of the variable as stored in the arena: denominator d followed by numerators n0,...,n(r-1). */
+		const long long* Row(uword variable, uword k) const;
+
+		/**
+		 * Evaluates every bound function of the variable (counting starts from 0) for the values of variables x1,...,xr-1 stored in the first
+		 * variable elements of solution. CeilMax() returns the maximum of the evaluated bounds rounded up to the nearest integer (the lowest
+		 * integer value the variable can have when these are lower bounds), FloorMin() the minimum rounded down to the nearest integer.
+		 *
+		 * @throw std::logic_error if the variable is not bounded or solution has less than variable elements.
+		 */
+		long long CeilMax(uword variable, const RowVector<long long>& solution) const;
+		long long FloorMin(uword variable, const RowVector<long long>& solution) const;
+
+	private:
+		long long Evaluate(uword variable, const RowVector<long long>& solution, bool find_max) const;
+
+		/** Rows of variable r (counting starts from 0) have r + 2 elements: denominator d followed by numerators n0,...,n(r-1). */
+		std::vector<long long> m_arena;
+
+		/** Element r is the index of the first row of variable r in the arena, the last element is the size of the arena. */
+		std::vector<uword> m_offsets;
+
+		/** Largest magnitude of n0 and largest magnitude of n1,...,n(r-1) over all rows of variable r. */
+		std::vector<unsigned long long> m_max_constant;
+		std::vector<unsigned long long> m_max_coefficient;
+	};
+
+} /// namespace util
+} /// namespace gap
+
+#endif /// GAP_UTIL_BOUND_SET_H
@@ -0,0 +1,323 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "checked_arithmetic.h"
+#include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace gap
+{
+namespace util
+{
+
+	std::atomic<unsigned long long> rational_normalization_threshold(0);
+
+	BigInteger::BigInteger()
+		: m_negative(false)
+	{
+	}
+
+	BigInteger::BigInteger(long long value)
+		: m_negative(value < 0)
+	{
+		/** Magnitude is calculated in unsigned arithmetic so that the most negative value is handled as well. */
+		unsigned long long magnitude(m_negative ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value));
+		while (magnitude != 0)
+		{
+			m_limbs.push_back(static_cast<std::uint32_t>(magnitude));
+			magnitude >>= 32;
+		}
+	}
+
+	bool BigInteger::ToLongLong(long long& value) const
+	{
+		if (m_limbs.size() > 2)
+			return false;
+
+		unsigned long long magnitude(0);
+		for (auto i = m_limbs.size(); i-- > 0;)
+			magnitude = (magnitude << 32) | m_limbs[i];
+
+		const unsigned long long max_magnitude(static_cast<unsigned long long>(std::numeric_limits<long long>::max()));
+		if (magnitude > max_magnitude + (m_negative ? 1ULL : 0ULL))
+			return false;
+
+		value = m_negative ? static_cast<long long>(0ULL - magnitude) : static_cast<long long>(magnitude);
+		return true;
+	}
+
+	BigInteger BigInteger::operator-() const
+	{
+		BigInteger result(*this);
+		result.m_negative = !result.IsZero() && !m_negative;
+		return result;
+	}
+
+	BigInteger operator+(const BigInteger& a, const BigInteger& b)
+	{
+		BigInteger result;
+		if (a.m_negative == b.m_negative)
+		{
+			result.m_limbs = BigInteger::AddMagnitudes(a.m_limbs, b.m_limbs);
+			result.m_negative = a.m_negative;
+		}
+		else if (BigInteger::CompareMagnitudes(a.m_limbs, b.m_limbs) >= 0)
+		{
+			result.m_limbs = BigInteger::SubMagnitudes(a.m_limbs, b.m_limbs);
+			result.m_negative = a.m_negative;
+		}
+		else
+		{
+			result.m_limbs = BigInteger::SubMagnitudes(b.m_limbs, a.m_limbs);
+			result.m_negative = b.m_negative;
+		}
+
+		if (result.IsZero())
+			result.m_negative = false;
+		return result;
+	}
+
+	BigInteger operator-(const BigInteger& a, const BigInteger& b)
+	{
+		return a + (-b);
+	}
+
+	BigInteger operator*(const BigInteger& a, const BigInteger& b)
+	{
+		BigInteger result;
+		if (a.IsZero() || b.IsZero())
+			return result;
+
+		result.m_limbs.assign(a.m_limbs.size() + b.m_limbs.size(), 0);
+		for (auto i = 0U; i < a.m_limbs.size(); ++i)
+		{
+			unsigned long long carry(0);
+			for (auto j = 0U; j < b.m_limbs.size(); ++j)
+			{
+				unsigned long long value(static_cast<unsigned long long>(a.m_limbs[i]) * b.m_limbs[j] + result.m_limbs[i + j] + carry);
+				result.m_limbs[i + j] = static_cast<std::uint32_t>(value);
+				carry = value >> 32;
+			}
+			result.m_limbs[i + b.m_limbs.size()] = static_cast<std::uint32_t>(carry);
+		}
+
+		BigInteger::Trim(result.m_limbs);
+		result.m_negative = a.m_negative != b.m_negative;
+		return result;
+	}
+
+	void BigInteger::DivMod(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder)
+	{
+		if (b.IsZero())
+			throw std::domain_error("BigInteger::DivMod(): division by zero");
+
+		/** Schoolbook binary long division of magnitudes, one bit of a at a time. */
+		Limbs q(a.m_limbs.size(), 0), r;
+		for (auto bit = a.m_limbs.size() * 32; bit-- > 0;)
+		{
+			/** r = 2 * r + (current bit of a). */
+			std::uint32_t carry((a.m_limbs[bit / 32] >> (bit % 32)) & 1U);
+			for (auto & limb : r)
+			{
+				std::uint32_t next_carry(limb >> 31);
+				limb = (limb << 1) | carry;
+				carry = next_carry;
+			}
+			if (carry != 0)
+				r.push_back(carry);
+
+			if (CompareMagnitudes(r, b.m_limbs) >= 0)
+			{
+				r = SubMagnitudes(r, b.m_limbs);
+				q[bit / 32] |= 1U << (bit % 32);
+			}
+		}
+
+		Trim(q);
+		quotient.m_limbs = std::move(q);
+		quotient.m_negative = !quotient.IsZero() && a.m_negative != b.m_negative;
+		remainder.m_limbs = std::move(r);
+		remainder.m_negative = !remainder.IsZero() && a.m_negative;
+	}
+
+	BigInteger BigInteger::Gcd(BigInteger a, BigInteger b)
+	{
+		a.m_negative = false;
+		b.m_negative = false;
+		while (!b.IsZero())
+		{
+			BigInteger quotient, remainder;
+			DivMod(a, b, quotient, remainder);
+			a = std::move(b);
+			b = std::move(remainder);
+		}
+		return a;
+	}
+
+	bool operator==(const BigInteger& a, const BigInteger& b)
+	{
+		return a.m_negative == b.m_negative && a.m_limbs == b.m_limbs;
+	}
+
+	int BigInteger::CompareMagnitudes(const Limbs& a, const Limbs& b)
+	{
+		if (a.size() != b.size())
+			return a.size() < b.size() ? -1 : 1;
+
+		for (auto i = a.size(); i-- > 0;)
+		{
+			if (a[i] != b[i])
+				return a[i] < b[i] ? -1 : 1;
+		}
+		return 0;
+	}
+
+	BigInteger::Limbs BigInteger::AddMagnitudes(const Limbs& a, const Limbs& b)
+	{
+		Limbs result(std::max(a.size(), b.size()) + 1, 0);
+		unsigned long long carry(0);
+		for (auto i = 0U; i < result.size(); ++i)
+		{
+			unsigned long long value(carry);
+			if (i < a.size())
+				value += a[i];
+			if (i < b.size())
+				value += b[i];
+			result[i] = static_cast<std::uint32_t>(value);
+			carry = value >> 32;
+		}
+
+		Trim(result);
+		return result;
+	}
+
+	BigInteger::Limbs BigInteger::SubMagnitudes(const Limbs& a, const Limbs& b)
+	{
+		Limbs result(a.size(), 0);
+		long long borrow(0);
+		for (auto i = 0U; i < a.size(); ++i)
+		{
+			long long value(static_cast<long long>(a[i]) - borrow - (i < b.size() ? static_cast<long long>(b[i]) : 0LL));
+			borrow = value < 0 ? 1 : 0;
+			result[i] = static_cast<std::uint32_t>(value + (borrow << 32));
+		}
+
+		Trim(result);
+		return result;
+	}
+
+	void BigInteger::Trim(Limbs& limbs)
+	{
+		while (!limbs.empty() && limbs.back() == 0)
+			limbs.pop_back();
+	}
+
+	namespace
+	{
+
+		/**
+		 * Tier counters of a single thread. Only the owning thread increments them, so relaxed load/store pairs are enough and the hot
+		 * path never contends with other threads. Counters of every live thread are registered so that they can be summed up, while
+		 * counters of finished threads are added to retired_hits.
+		 */
+		struct ThreadRationalCounters;
+
+		std::mutex counters_mutex;
+		std::vector<ThreadRationalCounters*> live_counters;
+		unsigned long long retired_hits[RATIONAL_TIER_CNT] = {};
+
+		struct ThreadRationalCounters
+		{
+			std::atomic<unsigned long long> hits[RATIONAL_TIER_CNT];
+
+			ThreadRationalCounters()
+			{
+				for (auto & hit : hits)
+					hit.store(0, std::memory_order_relaxed);
+
+				std::lock_guard<std::mutex> lock(counters_mutex);
+				live_counters.push_back(this);
+			}
+
+			~ThreadRationalCounters()
+			{
+				std::lock_guard<std::mutex> lock(counters_mutex);
+				for (auto i = 0U; i < RATIONAL_TIER_CNT; ++i)
+					retired_hits[i] += hits[i].load(std::memory_order_relaxed);
+				live_counters.erase(std::find(live_counters.begin(), live_counters.end(), this));
+			}
+		};
+
+		ThreadRationalCounters& GetThreadCounters()
+		{
+			thread_local ThreadRationalCounters counters;
+			return counters;
+		}
+
+	} // unnamed namespace
+
+	void RecordRationalTier(RationalTier tier)
+	{
+		auto & hit = GetThreadCounters().hits[tier];
+		hit.store(hit.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	RationalStatistics GetRationalStatistics()
+	{
+		RationalStatistics stats;
+		std::lock_guard<std::mutex> lock(counters_mutex);
+		for (auto i = 0U; i < RATIONAL_TIER_CNT; ++i)
+		{
+			stats.hits[i] = retired_hits[i];
+			for (auto counters : live_counters)
+				stats.hits[i] += counters->hits[i].load(std::memory_order_relaxed);
+		}
+		return stats;
+	}
+
+	void ResetRationalStatistics()
+	{
+		std::lock_guard<std::mutex> lock(counters_mutex);
+		for (auto i = 0U; i < RATIONAL_TIER_CNT; ++i)
+		{
+			retired_hits[i] = 0;
+			for (auto counters : live_counters)
+				counters->hits[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+} /// namespace util
+} /// namespace gap
@@ -0,0 +1,244 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef GAP_UTIL_CHECKED_ARITHMETIC_H
+#define GAP_UTIL_CHECKED_ARITHMETIC_H
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <atomic>
+
+/** 128-bit integers are provided by GCC and Clang on 64-bit targets. Define GAP_UTIL_NO_INT128 to force BigInteger instead. */
+#if defined(__SIZEOF_INT128__) && !defined(GAP_UTIL_NO_INT128)
+#define GAP_UTIL_HAS_INT128
+#endif
+
+namespace gap
+{
+namespace util
+{
+
+	/**
+	 * Overflow-checked addition, subtraction and multiplication of integral values. Each function stores a op b in result and returns
+	 * TRUE if the operation overflowed (result is unspecified in that case). Compiler intrinsics are used where available.
+	 */
+	template<typename T>
+	inline bool AddOverflow(T a, T b, T& result)
+	{
+		static_assert(std::is_integral<T>::value, "AddOverflow() can be instantiated with integral types only!");
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_add_overflow(a, b, &result);
+#else
+		if ((b > 0 && a > std::numeric_limits<T>::max() - b) || (b < 0 && a < std::numeric_limits<T>::min() - b))
+			return true;
+		result = a + b;
+		return false;
+#endif
+	}
+
+	template<typename T>
+	inline bool SubOverflow(T a, T b, T& result)
+	{
+		static_assert(std::is_integral<T>::value, "SubOverflow() can be instantiated with integral types only!");
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_sub_overflow(a, b, &result);
+#else
+		if ((b < 0 && a > std::numeric_limits<T>::max() + b) || (b > 0 && a < std::numeric_limits<T>::min() + b))
+			return true;
+		result = a - b;
+		return false;
+#endif
+	}
+
+	template<typename T>
+	inline bool MulOverflow(T a, T b, T& result)
+	{
+		static_assert(std::is_integral<T>::value, "MulOverflow() can be instantiated with integral types only!");
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_mul_overflow(a, b, &result);
+#else
+		if (a > 0 ? (b > 0 ? a > std::numeric_limits<T>::max() / b : b < std::numeric_limits<T>::min() / a)
+			: (b > 0 ? a < std::numeric_limits<T>::min() / b : (a != 0 && b < std::numeric_limits<T>::max() / a)))
+			return true;
+		result = a * b;
+		return false;
+#endif
+	}
+
+	/** Returns the number of trailing zero bits of a non-zero value. */
+	inline unsigned CountTrailingZeros(unsigned long long value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<unsigned>(__builtin_ctzll(value));
+#else
+		unsigned count(0);
+		for (; (value & 1ULL) == 0; value >>= 1)
+			++count;
+		return count;
+#endif
+	}
+
+	/**
+	 * Returns GCD of |a| and |b| calculated by the binary (Stein's) algorithm, which needs only shifts and subtractions. The result
+	 * is unsigned so that the magnitude of the most negative value is representable as well. GCD(0, 0) is 0.
+	 */
+	template<typename T>
+	inline typename std::make_unsigned<T>::type BinaryGcd(T a, T b)
+	{
+		static_assert(std::is_integral<T>::value, "BinaryGcd() can be instantiated with integral types only!");
+		typedef typename std::make_unsigned<T>::type U;
+
+		U u(a < 0 ? U(0) - static_cast<U>(a) : static_cast<U>(a));
+		U v(b < 0 ? U(0) - static_cast<U>(b) : static_cast<U>(b));
+		if (u == 0)
+			return v;
+		if (v == 0)
+			return u;
+
+		const unsigned shift(CountTrailingZeros(u | v));
+		u >>= CountTrailingZeros(u);
+		do
+		{
+			v >>= CountTrailingZeros(v);
+			if (u > v)
+				std::swap(u, v);
+			v -= u;
+		} while (v != 0);
+
+		return u << shift;
+	}
+
+	/**
+	 * Rational numbers (@see rational_number.hpp) are reduced by GCD of numerator and denominator only once the magnitude of either
+	 * of them exceeds this threshold. Zero (the default) reduces every Rational as soon as it is constructed. Larger values skip the
+	 * reduction of small fractions, which can't overflow anyway: with RATIONAL_LAZY_NORMALIZATION_THRESHOLD no intermediate value of
+	 * an operation on two such fractions overflows 64 bits. Only numerator() and denominator() are affected, all operators are exact
+	 * either way. Set it through SetRationalNormalizationThreshold() before any analysis is started.
+	 */
+	extern std::atomic<unsigned long long> rational_normalization_threshold;
+
+	const unsigned long long RATIONAL_LAZY_NORMALIZATION_THRESHOLD = (1ULL << 31) - 1;
+
+	inline void SetRationalNormalizationThreshold(unsigned long long threshold)
+	{
+		rational_normalization_threshold.store(threshold, std::memory_order_relaxed);
+	}
+
+	inline unsigned long long GetRationalNormalizationThreshold()
+	{
+		return rational_normalization_threshold.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Arbitrary-precision signed integer with just enough operations to carry out and reduce a single Rational operation exactly. The
+	 * magnitude is stored as little-endian 32-bit limbs without leading zero limbs (zero has no limbs and is never negative). Operations
+	 * are written for clarity rather than speed, as BigInteger is used only when cheaper representations overflow.
+	 */
+	class BigInteger
+	{
+	public:
+		BigInteger();
+		BigInteger(long long value);
+
+		bool IsZero() const { return m_limbs.empty(); }
+		bool IsNegative() const { return m_negative; }
+
+		/** Returns TRUE if the value fits in long long and stores it in value. */
+		bool ToLongLong(long long& value) const;
+
+		BigInteger operator-() const;
+		friend BigInteger operator+(const BigInteger& a, const BigInteger& b);
+		friend BigInteger operator-(const BigInteger& a, const BigInteger& b);
+		friend BigInteger operator*(const BigInteger& a, const BigInteger& b);
+
+		/** Truncated division (quotient rounded towards zero, remainder has the sign of a). @throw std::domain_error if b is zero. */
+		static void DivMod(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder);
+
+		/** Returns non-negative GCD of a and b (Euclid's algorithm). */
+		static BigInteger Gcd(BigInteger a, BigInteger b);
+
+		friend bool operator==(const BigInteger& a, const BigInteger& b);
+
+	private:
+		typedef std::vector<std::uint32_t> Limbs;
+
+		static int CompareMagnitudes(const Limbs& a, const Limbs& b);
+		static Limbs AddMagnitudes(const Limbs& a, const Limbs& b);
+		static Limbs SubMagnitudes(const Limbs& a, const Limbs& b);		/** Requires |a| >= |b|. */
+		static void Trim(Limbs& limbs);
+
+		bool m_negative;
+		Limbs m_limbs;
+	};
+
+	/**
+	 * Tiers of Rational arithmetic (@see rational_number.hpp), ordered from the cheapest one. Every operation is first carried out in
+	 * the integral type of the Rational with overflow checks (RATIONAL_TIER_FAST). If some intermediate value overflows, it is repeated
+	 * in 128-bit integers (RATIONAL_TIER_WIDE) where the compiler provides them, or in BigInteger otherwise (RATIONAL_TIER_BIG).
+	 * RATIONAL_TIER_OVERFLOW counts operations whose reduced result couldn't be represented, which results in std::overflow_error.
+	 */
+	enum RationalTier
+	{
+		RATIONAL_TIER_FAST = 0
+		, RATIONAL_TIER_WIDE
+		, RATIONAL_TIER_BIG
+		, RATIONAL_TIER_OVERFLOW
+		, RATIONAL_TIER_CNT
+	};
+
+	/** Number of Rational operations carried out by each tier since the last ResetRationalStatistics() call. */
+	struct RationalStatistics
+	{
+		unsigned long long hits[RATIONAL_TIER_CNT];
+	};
+
+	/**
+	 * Increments the counter of the given tier. Counters are kept per thread (without any synchronization on the hot path) and are
+	 * summed up by GetRationalStatistics().
+	 */
+	void RecordRationalTier(RationalTier tier);
+
+	/** Returns the snapshot of the Rational tier counters of all threads. */
+	RationalStatistics GetRationalStatistics();
+
+	/** Sets the Rational tier counters of all threads to zero. */
+	void ResetRationalStatistics();
+
+} /// namespace util
+} /// namespace gap
+
+#endif /// GAP_UTIL_CHECKED_ARITHMETIC_H
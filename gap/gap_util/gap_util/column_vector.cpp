@@ -63,21 +63,30 @@ namespace util
 	}
 
 	template<typename T>
-	ColVector<T>::ColVector(const MatrixExt<T>& X) : MatrixExt<T>(X.n_rows, 1)
+	ColVector<T>::ColVector(const MatrixExt<T>& X) : MatrixExt<T>(X)
 	{
 		if (X.n_cols != 1)
 			throw std::logic_error("ColVector(const MatrixExt<T>& X): X.n_cols must be equal to 1");
-
-		uhword bla = this->vec_state;
 	}
 
 	template<typename T>
 	ColVector<T>::ColVector(MatrixExt<T>&& X) : MatrixExt<T>(std::move(X))
 	{
-		if (X.n_cols != 1)
+		/** Moved-from X may be empty already, so dimensions of this instance are checked. */
+		if (this->n_cols != 1)
 			throw std::logic_error("ColVector(const MatrixExt<T>& X): X.n_cols must be equal to 1");
 	}
 
+	template<typename T>
+	ColVector<T>::ColVector(const ColVector& x) : MatrixExt<T>(x)
+	{
+	}
+
+	template<typename T>
+	ColVector<T>::ColVector(ColVector&& x) : MatrixExt<T>(std::move(x))
+	{
+	}
+
 	template<typename T>
 	const ColVector<T>& ColVector<T>::operator=(const MatrixExt<T>& X)
 	{
@@ -113,52 +122,66 @@ namespace util
 		return *this;
 	}
 
+	template<typename T>
+	const ColVector<T>& ColVector<T>::operator=(const ColVector& x)
+	{
+		MatrixExt<T>::operator=(x);
+		return *this;
+	}
+
+	template<typename T>
+	const ColVector<T>& ColVector<T>::operator=(ColVector&& x)
+	{
+		MatrixExt<T>::operator=(std::move(x));
+		return *this;
+	}
+
 	template<typename T>
 	ColVector<T> operator+(const ColVector<T>& x, const ColVector<T>& y)
 	{
-		return ColVector<T>(dynamic_cast<const MatrixExt<T>&>(x) + dynamic_cast<const MatrixExt<T>&>(y));
+		return ColVector<T>(static_cast<const Mat<T>&>(x) + static_cast<const Mat<T>&>(y));
 	}
 
 	template<typename T>
 	ColVector<T> operator-(const ColVector<T>& x, const ColVector<T>& y)
 	{
-		return ColVector<T>(dynamic_cast<const MatrixExt<T>&>(x) - dynamic_cast<const MatrixExt<T>&>(y));
+		return ColVector<T>(static_cast<const Mat<T>&>(x) - static_cast<const Mat<T>&>(y));
 	}
 
 	template<typename T>
 	ColVector<T> operator*(const MatrixExt<T>& X, const ColVector<T>& y)
 	{
-		return ColVector<T>(X * dynamic_cast<const MatrixExt<T>&>(y));
+		return ColVector<T>(static_cast<const Mat<T>&>(X) * static_cast<const Mat<T>&>(y));
 	}
 
 	template<typename T>
 	ColVector<T> operator*(const ColVector<T>& x, const T& scalar)
 	{
-		return ColVector<T>(dynamic_cast<const MatrixExt<T>&>(x) * scalar);
+		return ColVector<T>(static_cast<const Mat<T>&>(x) * scalar);
 	}
 
 	template<typename T>
 	ColVector<T> operator*(const T& scalar, const ColVector<T>& x)
 	{
-		return ColVector<T>(scalar * dynamic_cast<const MatrixExt<T>&>(x));
+		return ColVector<T>(scalar * static_cast<const Mat<T>&>(x));
 	}
 
 	template<typename T>
 	ColVector<T> operator/(const ColVector<T>& x, const ColVector<T>& y)
 	{
-		return ColVector<T>(dynamic_cast<const MatrixExt<T>&>(x) / dynamic_cast<const MatrixExt<T>&>(y));
+		return ColVector<T>(static_cast<const Mat<T>&>(x) / static_cast<const Mat<T>&>(y));
 	}
 
 	template<typename T>
 	ColVector<T> operator/(const ColVector<T>& x, const T& scalar)
 	{
-		return ColVector<T>(dynamic_cast<const MatrixExt<T>&>(x) / scalar);
+		return ColVector<T>(static_cast<const Mat<T>&>(x) / scalar);
 	}
 
 	template<typename T>
 	ColVector<T> operator/(const T& scalar, const ColVector<T>& x)
 	{
-		return ColVector<T>(scalar / dynamic_cast<const MatrixExt<T>&>(x));
+		return ColVector<T>(scalar / static_cast<const Mat<T>&>(x));
 	}
 
 
@@ -36,6 +36,7 @@
 #define GAP_UTIL_COLUMN_VECTOR_H
 
 #include "matrix_ext.h"
+#include <stdexcept>
 
 namespace gap
 {
@@ -78,9 +79,22 @@ namespace util
         ColVector(const std::initializer_list<T>& x);
         ColVector(const MatrixExt<T>& X);
         ColVector(MatrixExt<T>&& X);
+        ColVector(const ColVector& x);
+        ColVector(ColVector&& x);
+
+		/** @brief Evaluates delayed armadillo expression X directly into this instance. @throw std::logic_error if X has more than one column */
+		template<typename T1>
+		ColVector(const Base<T, T1>& X) : MatrixExt<T>(X)
+		{
+			if (this->n_cols != 1)
+				throw std::logic_error("ColVector(const Base<T, T1>& X): X.n_cols must be equal to 1");
+		}
+
         const ColVector& operator=(const MatrixExt<T>& X);
         const ColVector& operator=(const std::vector<T>& x);
         const ColVector& operator=(const std::initializer_list<T>& x);
+        const ColVector& operator=(const ColVector& x);
+        const ColVector& operator=(ColVector&& x);
         virtual ~ColVector()
         {
         }
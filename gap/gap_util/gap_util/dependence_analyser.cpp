@@ -35,8 +35,15 @@
 #include "dependence_analyser.h"
 #include "diophantine.h"
 #include "fourier_elimination.h"
+#include "omega_elimination.h"
+#include "distance_query.h"
+#include "checked_arithmetic.h"
 #include <vector>
 #include <list>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 
 namespace gap
 {
@@ -68,9 +75,209 @@ namespace
 			throw std::logic_error("c2cuda::ValidateArguments(): matrices P,Q must have the same number of rows as matrices A, B");
 	}
 
-} /// unnamed namespace
+	/**
+	 * Forms the system of inequalities t_unknown * Z <= v that is shared by both uniform dependence analysers. Returns FALSE if the system
+	 * of diophantine equations kA = a0 - b0 has no integer solution, TRUE otherwise. See UniformLinearDependenceTest() for details.
+	 * Matrix U and rank_s of the solution k = tU are the ones of the factorization.
+	 */
+	bool FormUniformDependenceSystem(
+		const util::DiophantineFactorization<util::MatrixExt<long long>>& factorization,
+		const util::RowVector<long long>& a0,
+		const util::RowVector<long long>& b0,
+		const util::MatrixExt<long long>& P,
+		const util::RowVector<long long>& p0,
+		const util::RowVector<long long>& q0,
+		util::RowVector<long long>& t,
+		util::MatrixExt<long long>& Z,
+		util::RowVector<long long>& v)
+	{
+		/** STEP 1: solve system of diophantine equations kA = a0 - b0 where k = j - i, using echelon reduction UA = S of matrix A. */
+		const util::MatrixExt<long long>& U(factorization.U);
+		const arma::uword rank_s(factorization.rank_s);
 
-	bool GeneralLinearDependenceTest(
+		if (!util::SolveFactoredDiophantineSystem(factorization, a0 - b0, t))
+		{
+			/** Variables X(iA + a0) and X(jA + b0) don't cause dependence between S and T. */
+			return false;
+		}
+
+		/**
+		 * STEP 2: verify if system of inequalities p0 - q0 <= tUP <= q0 - p0. We must transform this into t_unknown * Z <= v system
+		 * where Z is (2m - rank_s x 2m) coefficient matrix and v is (1 x 2m) vector representing right-hand side of the system.
+		 *
+		 * NOTE: when m == rank_s every component of vector t is determined. In this case we only need to check if the system of form
+		 * 0 <= v - t_unknown * Z is trivially satisfied. In this case matrix Z is (1 * 2m) zero matrix.
+		 */
+		Z.zeros(U.n_rows == rank_s ? 1 : U.n_rows - rank_s, 2 * U.n_rows);
+		v.zeros(1, 2 * U.n_rows);
+		util::MatrixExt<long long> UP(U * P);
+
+		if (U.n_rows > rank_s)
+		{
+			/**
+			 * Fill matrix Z using bottom 2m - rank_s rows of matrix U*P from system: -tUP <= q0 - p0 and tUP <= q0 - p0. First m columns
+			 * come from tUP <= q0 - p0 taking bottom wm - rank_s rows of matrix U*P. Last m colums come from -tUP <= q0 - p0 so they are
+			 * inverted copy of first m columns.
+			 */
+			Z(arma::span::all, arma::span(0, UP.n_rows - 1)) = UP(arma::span(rank_s, UP.n_rows - 1), arma::span::all);
+			Z(arma::span::all, arma::span(UP.n_rows, 2 * UP.n_rows - 1)) = -1 * Z(arma::span::all, arma::span(0, UP.n_rows - 1));
+		}
+
+		{
+			/**
+			 * Fill vector v by combining determined part of vector t*U*P with vectors p0 and q0. First m columns are obtained from tUP <= q0 - p0
+			 * inequality. Last m columns are obtained from -tUP <= q0 - p0 inequality.
+			 */
+			util::RowVector<long long> q0_minus_p0(q0 - p0);
+			util::RowVector<long long> tmp(t(0, arma::span(0, rank_s - 1)) * UP(arma::span(0, rank_s - 1), arma::span::all));
+			v(0, arma::span(0, UP.n_rows - 1)) = q0_minus_p0 - tmp;
+			v(0, arma::span(UP.n_rows, 2 * UP.n_rows - 1)) = tmp + q0_minus_p0;
+		}
+
+		return true;
+	}
+
+	/** Systems formed by the dependence analysers are integer, so they are solved without leaving the integers (@see FourierArithmetic). */
+	util::FourierEliminationOptions IntegerFourierOptions()
+	{
+		util::FourierEliminationOptions options;
+		options.arithmetic = util::FOURIER_INTEGER;
+		return options;
+	}
+
+	/**
+	 * Finds the range [lower, upper] of integer values that linear form constant + t * coeffs^T can have over the REAL solutions of system
+	 * t * Z <= v. The form is added to the system as a new variable y placed in front of t (y = constant + t * coeffs^T) so that Fourier
+	 * elimination leaves y for the last and produces constant bounds for it. Returns FALSE if the range doesn't contain any integer value.
+	 */
+	bool FindIntegerRange(
+		const util::MatrixExt<long long>& Z,
+		const util::RowVector<long long>& v,
+		const util::RowVector<long long>& coeffs,
+		long long constant,
+		long long& lower,
+		long long& upper)
+	{
+		util::MatrixExt<long long> Zy(Z.n_rows + 1, Z.n_cols + 2);
+		util::RowVector<long long> vy(Z.n_cols + 2);
+		Zy(arma::span(1, Z.n_rows), arma::span(0, Z.n_cols - 1)) = Z;
+		vy(0, arma::span(0, Z.n_cols - 1)) = v;
+
+		/** y - t * coeffs^T <= constant and t * coeffs^T - y <= -constant. */
+		Zy(0, Z.n_cols) = 1;
+		Zy(0, Z.n_cols + 1) = -1;
+		for (auto i = 0U; i < coeffs.n_cols; ++i)
+		{
+			Zy(i + 1, Z.n_cols) = -coeffs(i);
+			Zy(i + 1, Z.n_cols + 1) = coeffs(i);
+		}
+		vy(Z.n_cols) = constant;
+		vy(Z.n_cols + 1) = -constant;
+
+		util::BoundSet lower_bound, upper_bound;
+		if (!util::PerformFourierElimination(Zy, vy, lower_bound, upper_bound, IntegerFourierOptions()))
+			return false;
+
+		if (!lower_bound.IsBounded(0) || !upper_bound.IsBounded(0))
+			throw std::logic_error("c2cuda::UniformLinearDependenceLattice(): distance set is infinite");
+
+		/** y is the first variable, so its bounds are constants. */
+		const util::RowVector<long long> no_variables(0);
+		lower = lower_bound.CeilMax(0, no_variables);
+		upper = upper_bound.FloorMin(0, no_variables);
+		return lower <= upper;
+	}
+
+	/**
+	 * Solves the system t_unknown * Z <= v formed by the dependence analysers using the engine selected in options. When every component of t is
+	 * determined (has_unknowns is FALSE and Z is zero matrix), the system is only checked to be trivially satisfied. Otherwise, every integer
+	 * solution is handed to the visitor, in lexicographic order, also when they are enumerated on the enumeration pool. Returns FALSE if the
+	 * system has no (integer) solution.
+	 */
+	bool SolveDependenceSystem(
+		const util::MatrixExt<long long>& Z,
+		const util::RowVector<long long>& v,
+		bool has_unknowns,
+		const DependenceTestOptions& options,
+		const util::IntegerSolutionVisitor& visitor)
+	{
+		if (options.engine == ENGINE_OMEGA)
+			return has_unknowns ? util::OmegaEnumerateIntegerSolutions(Z, v, visitor) : util::OmegaTest(Z, v);
+
+		util::BoundSet lower_bound, upper_bound;
+		if (!util::PerformFourierElimination(Z, v, lower_bound, upper_bound, options.fourier_options))
+			return false;
+
+		if (!has_unknowns)
+			return true;
+
+		if (options.enumeration_pool == nullptr)
+			return util::EnumerateIntegerSolutions(lower_bound, upper_bound, visitor);
+
+		return util::EnumerateIntegerSolutionsInOrder(lower_bound, upper_bound, *options.enumeration_pool, visitor);
+	}
+
+	/** Hit counters of every pre-filter tier. */
+	std::atomic<unsigned long long> prefilter_hits[PREFILTER_TIER_CNT];
+
+	/** Returns |value|, which is representable for the most negative value as well. */
+	unsigned long long Magnitude(long long value)
+	{
+		return value < 0 ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+	}
+
+	unsigned long long Gcd(unsigned long long a, unsigned long long b)
+	{
+		while (b != 0)
+		{
+			unsigned long long r(a % b);
+			a = b;
+			b = r;
+		}
+		return a;
+	}
+
+	/**
+	 * Calculates constant range [lower, upper] of every loop index from loop bounds p0 <= IP, IQ <= q0, going from the outermost loop
+	 * inwards. Returns FALSE if the bounds of some loop depend on the index of an inner loop (or on its own index with coefficient other
+	 * than 1), in which case the ranges cannot be calculated this way, or if a range doesn't fit into long long.
+	 */
+	bool FindLoopIndexRanges(
+		const util::MatrixExt<long long>& P,
+		const util::RowVector<long long>& p0,
+		const util::MatrixExt<long long>& Q,
+		const util::RowVector<long long>& q0,
+		std::vector<std::pair<long long, long long>>& ranges)
+	{
+		ranges.resize(P.n_cols);
+		for (auto col = 0U; col < P.n_cols; ++col)
+		{
+			if (P(col, col) != 1 || Q(col, col) != 1)
+				return false;
+
+			/** Ik >= p0(k) - sum(P(r,k)*Ir) and Ik <= q0(k) - sum(Q(r,k)*Ir) where r goes over the outer loops. */
+			long long lower(p0(col)), upper(q0(col));
+			for (auto row = 0U; row < P.n_rows; ++row)
+			{
+				if (row == col)
+					continue;
+
+				if (row > col && (P(row, col) != 0 || Q(row, col) != 0))
+					return false;
+
+				long long lower_term, upper_term;
+				if (util::MulOverflow(P(row, col), P(row, col) > 0 ? ranges[row].second : ranges[row].first, lower_term)
+					|| util::MulOverflow(Q(row, col), Q(row, col) > 0 ? ranges[row].first : ranges[row].second, upper_term)
+					|| util::SubOverflow(lower, lower_term, lower)
+					|| util::SubOverflow(upper, upper_term, upper))
+					return false;
+			}
+			ranges[col] = std::make_pair(lower, upper);
+		}
+		return true;
+	}
+
+	PrefilterTier RunPrefilter(
 		const util::MatrixExt<long long>& A,
 		const util::RowVector<long long>& a0,
 		const util::MatrixExt<long long>& B,
@@ -78,25 +285,324 @@ namespace
 		const util::MatrixExt<long long>& P,
 		const util::RowVector<long long>& p0,
 		const util::MatrixExt<long long>& Q,
-		const util::RowVector<long long>& q0,
-		std::vector<DependenceInfo>& T_on_S,
-		std::vector<DependenceInfo>& S_on_T,
-		bool are_distinct)
+		const util::RowVector<long long>& q0)
 	{
+		/**
+		 * Every tier works on long long values derived from the subscripts and the loop bounds. Whenever one of them overflows, the tier
+		 * cannot decide and the exact test has to be run.
+		 */
 
-		/** Validate arguments. */
-		ValidateArguments(A, a0, B, b0, P, p0, Q, q0);
+		/** TIERS 1 and 2: ZIV and GCD tests don't depend on the loop bounds. */
+		for (auto col = 0U; col < A.n_cols; ++col)
+		{
+			unsigned long long gcd_val(0);
+			for (auto row = 0U; row < A.n_rows; ++row)
+				gcd_val = Gcd(Gcd(gcd_val, Magnitude(A(row, col))), Magnitude(B(row, col)));
+
+			long long c;
+			if (gcd_val == 0)
+			{
+				if (a0(col) != b0(col))
+					return PREFILTER_ZIV;
+			}
+			else if (util::SubOverflow(b0(col), a0(col), c))
+			{
+				return PREFILTER_UNDECIDED;
+			}
+			else if (Magnitude(c) % gcd_val != 0)
+			{
+				return PREFILTER_GCD;
+			}
+		}
 
-		/** STEP 1: form a system of diophantine equations suitable for diophantine solver. W is formed by appending rows of -B to matrix A. */
-		util::MatrixExt<long long> W(arma::resize(A, 2 * A.n_rows, A.n_cols));
-		W(arma::span(A.n_rows, W.n_rows - 1), arma::span(0, W.n_cols - 1)) = -1LL * B;
+		std::vector<std::pair<long long, long long>> ranges;
+		if (!FindLoopIndexRanges(P, p0, Q, q0, ranges))
+			return PREFILTER_UNDECIDED;
+
+		/** Loop nest without any iteration cannot have dependences. */
+		for (auto & range : ranges)
+		{
+			if (range.first > range.second)
+				return PREFILTER_EMPTY_NEST;
+		}
+
+		/** TIER 3: SIV test. */
+		for (auto col = 0U; col < A.n_cols; ++col)
+		{
+			arma::uword num_indices(0), k(0);
+			for (auto row = 0U; row < A.n_rows; ++row)
+			{
+				if (A(row, col) != 0 || B(row, col) != 0)
+				{
+					++num_indices;
+					k = row;
+				}
+			}
+
+			if (num_indices != 1)
+				continue;
+
+			const long long a(A(k, col)), b(B(k, col));
+			long long c;
+			if (util::SubOverflow(b0(col), a0(col), c))
+				return PREFILTER_UNDECIDED;
+
+			if (a == b)
+			{
+				/**
+				 * Strong SIV: a*ik - a*jk = c => jk - ik = -c / a (divisibility already verified by the GCD test). Both |c / a| and the width
+				 * of the range (upper >= lower, as the nest is not empty) are calculated on unsigned values, where they can't overflow.
+				 */
+				if (Magnitude(c) / Magnitude(a) > static_cast<unsigned long long>(ranges[k].second) - static_cast<unsigned long long>(ranges[k].first))
+					return PREFILTER_SIV;
+			}
+			else if (a == 0 || b == 0)
+			{
+				/** Weak zero SIV: a*ik = c or -b*jk = c. */
+				long long numerator(c), index_val;
+				const long long divisor(a == 0 ? b : a);
+				if ((a == 0 && util::SubOverflow(0LL, c, numerator)) || (divisor == -1 && util::SubOverflow(0LL, numerator, index_val)))
+					return PREFILTER_UNDECIDED;
+
+				index_val = numerator / divisor;
+				if (index_val < ranges[k].first || index_val > ranges[k].second)
+					return PREFILTER_SIV;
+			}
+		}
+
+		/** TIER 4: Banerjee bounds test for h(i,j) = iA(:,n) - jB(:,n) + a0(n) - b0(n). */
+		for (auto col = 0U; col < A.n_cols; ++col)
+		{
+			long long h_min, h_max, minus_b;
+			if (util::SubOverflow(a0(col), b0(col), h_min))
+				return PREFILTER_UNDECIDED;
+
+			h_max = h_min;
+			for (auto row = 0U; row < A.n_rows; ++row)
+			{
+				if (util::SubOverflow(0LL, B(row, col), minus_b))
+					return PREFILTER_UNDECIDED;
+
+				for (long long coeff : { A(row, col), minus_b })
+				{
+					long long min_term, max_term;
+					if (util::MulOverflow(coeff, coeff > 0 ? ranges[row].first : ranges[row].second, min_term)
+						|| util::MulOverflow(coeff, coeff > 0 ? ranges[row].second : ranges[row].first, max_term)
+						|| util::AddOverflow(h_min, min_term, h_min)
+						|| util::AddOverflow(h_max, max_term, h_max))
+						return PREFILTER_UNDECIDED;
+				}
+			}
+
+			if (h_min > 0 || h_max < 0)
+				return PREFILTER_BANERJEE;
+		}
+
+		return PREFILTER_UNDECIDED;
+	}
+
+	/** Throws if factorization of given kind was not created from subscript matrices of the dimensions of A. */
+	void ValidateFactorization(const DependenceSystemFactorization& factorization, const util::MatrixExt<long long>& A, DependenceSystemKind kind)
+	{
+		if (factorization.GetKind() != kind)
+			throw std::logic_error("ValidateFactorization(): factorization was created for a different kind of dependence test");
+
+		if (factorization.GetNumSubscriptRows() != A.n_rows || factorization.GetNumSubscriptCols() != A.n_cols)
+			throw std::logic_error("ValidateFactorization(): factorization was created for subscript matrices of different dimensions");
+	}
+
+	/** Forms (2m x n) coefficient matrix W of the general system iA - jB = b0 - a0 by appending rows of -B to matrix A. */
+	template<typename Matrix>
+	Matrix FormGeneralCoefficientMatrix(const util::MatrixExt<long long>& A, const util::MatrixExt<long long>& B)
+	{
+		const arma::uword m(A.n_rows);
+		Matrix W(2 * m, A.n_cols);
+		for (auto col = 0U; col < A.n_cols; ++col)
+		{
+			for (auto row = 0U; row < m; ++row)
+			{
+				W(row, col) = A(row, col);
+				W(m + row, col) = -B(row, col);
+			}
+		}
+		return W;
+	}
+
+	/** Returns the (rows x m) product of columns [first_col, first_col + m) of matrix U and (m x m) matrix P. */
+	template<typename Matrix>
+	Matrix MultiplyColumnBlock(const Matrix& U, arma::uword first_col, const util::MatrixExt<long long>& P)
+	{
+		Matrix out(U.n_rows, P.n_cols);
+		for (auto i = 0U; i < U.n_rows; ++i)
+			for (auto k = 0U; k < P.n_rows; ++k)
+				for (auto j = 0U; j < P.n_cols; ++j)
+					out(i, j) += U(i, first_col + k) * P(k, j);
+		return out;
+	}
+
+	/** Returns the (1 x m) product of row vector t and columns [first_col, first_col + m) of matrix U. */
+	template<typename Matrix, typename Vector>
+	util::RowVector<long long> MultiplyByColumnBlock(const Vector& t, const Matrix& U, arma::uword first_col, arma::uword m)
+	{
+		util::RowVector<long long> out(m);
+		for (auto j = 0U; j < m; ++j)
+			for (auto k = 0U; k < U.n_rows; ++k)
+				out(j) += t(k) * U(k, first_col + j);
+		return out;
+	}
+
+	/**
+	 * Receives every dependence found by the dependence analysers together with loop index instances i and j (0x0 vectors in case of the
+	 * uniform test) and level of dependence lev. Returning FALSE stops the enumeration of the dependences.
+	 */
+	typedef std::function<bool(
+		const util::RowVector<long long>& i,
+		const util::RowVector<long long>& j,
+		const util::RowVector<long long>& d,
+		arma::uword lev,
+		DependenceDirection direction)> DependenceRecorder;
+
+	/** Returns recorder that hands distance vectors to options.query when it is set, otherwise the given recorder is returned. */
+	DependenceRecorder QueryOrRecorder(const DependenceTestOptions& options, DependenceRecorder recorder)
+	{
+		if (options.query == nullptr)
+			return recorder;
+
+		DistanceQuery* query(options.query);
+		return [query](const util::RowVector<long long>&, const util::RowVector<long long>&, const util::RowVector<long long>& d, arma::uword,
+			DependenceDirection) { return query->Add(d); };
+	}
+
+	/** Returns recorder that stores dependences in T_on_S and S_on_T. */
+	DependenceRecorder StoringRecorder(std::vector<DependenceInfo>& T_on_S, std::vector<DependenceInfo>& S_on_T)
+	{
+		return [&T_on_S, &S_on_T](const util::RowVector<long long>& i, const util::RowVector<long long>& j, const util::RowVector<long long>& d,
+			arma::uword lev, DependenceDirection direction)
+		{
+			std::vector<DependenceInfo>& dependences(direction == DEPENDENCE_T_ON_S ? T_on_S : S_on_T);
+			if (i.n_cols == 0)
+				dependences.push_back(DependenceInfo(d, lev));
+			else
+				dependences.push_back(DependenceInfo(i, j, d, lev));
+			return true;
+		};
+	}
+
+	/** Returns recorder that hands distance vector and set of every dependence to the sink. */
+	DependenceRecorder SinkRecorder(const DependenceSink& sink)
+	{
+		return [&sink](const util::RowVector<long long>&, const util::RowVector<long long>&, const util::RowVector<long long>& d, arma::uword,
+			DependenceDirection direction) { return sink(d, direction); };
+	}
+
+	/** Outcome of recording a single solution of the dependence system. */
+	enum RecordResult
+	{
+		RECORD_NONE = 0		/** Solution doesn't represent a dependence (i == j and S == T). */
+		, RECORD_CONTINUE	/** Dependence has been recorded. */
+		, RECORD_STOP		/** Dependence has been recorded and the recorder has stopped the enumeration. */
+	};
+
+	/**
+	 * Decides whether T depends on S or the other way around, for loop index instances i and j, and records the dependence:
+	 *
+	 * -> i < j (lexicographically): T depends on S with distance vector d = j - i
+	 * -> i > j: S depends on T with distance vector d = i - j
+	 * -> i == j leads to dependence (of T on S, d = 0) only when S < T (S and T are distinct statements)
+	 */
+	RecordResult RecordGeneralDependence(
+		const util::RowVector<long long>& i,
+		const util::RowVector<long long>& j,
+		bool are_distinct,
+		const DependenceRecorder& record)
+	{
+		arma::uword lev(0);
+		bool keep_going(true);
+		switch (util::RowVector<long long>::CompareLexicographically(i, j, lev))
+		{
+		case util::RowVector<long long>::RightGreater:
+			keep_going = record(i, j, j - i, lev, DEPENDENCE_T_ON_S);
+			break;
+
+		case util::RowVector<long long>::LeftGreater:
+			keep_going = record(i, j, i - j, lev, DEPENDENCE_S_ON_T);
+			break;
+
+		default:
+			if (!are_distinct)
+				return RECORD_NONE;
+			keep_going = record(i, j, util::RowVector<long long>(i.n_cols), lev, DEPENDENCE_T_ON_S);
+			break;
+		}
+		return keep_going ? RECORD_CONTINUE : RECORD_STOP;
+	}
+
+	/**
+	 * Records dependence for uniform distance k = j - i, in the same way as RecordGeneralDependence(): T depends on S with distance vector
+	 * d = k if k > 0, S depends on T with d = -1 * k if k < 0, and k == 0 leads to dependence only when S and T are distinct statements.
+	 */
+	RecordResult RecordUniformDependence(
+		const util::RowVector<long long>& k,
+		bool are_distinct,
+		const DependenceRecorder& record)
+	{
+		static const util::RowVector<long long> no_instance(0);
+		arma::uword lev(0);
+		bool keep_going(true);
+		switch (util::RowVector<long long>::CompareLexicographically(k, util::RowVector<long long>(k.n_cols), lev))
+		{
+		case util::RowVector<long long>::LeftGreater:
+			keep_going = record(no_instance, no_instance, k, lev, DEPENDENCE_T_ON_S);
+			break;
+
+		case util::RowVector<long long>::RightGreater:
+			keep_going = record(no_instance, no_instance, -1LL * k, lev, DEPENDENCE_S_ON_T);
+			break;
+
+		default:
+			if (!are_distinct)
+				return RECORD_NONE;
+			keep_going = record(no_instance, no_instance, k, lev, DEPENDENCE_T_ON_S);
+			break;
+		}
+		return keep_going ? RECORD_CONTINUE : RECORD_STOP;
+	}
+
+	/**
+	 * Carries out GeneralLinearDependenceTest() on validated arguments and factorization of W = [A; -B]. Matrix and Vector are used for the
+	 * diophantine system and the unimodular matrix, and are either MatrixExt and RowVector or SmallMatrix and SmallRowVector (which don't
+	 * allocate).
+	 */
+	template<typename Matrix, typename Vector>
+	bool GeneralLinearDependenceTestImpl(
+		const util::DiophantineFactorization<Matrix>& factorization,
+		const util::MatrixExt<long long>& A,
+		const util::RowVector<long long>& a0,
+		const util::RowVector<long long>& b0,
+		const util::MatrixExt<long long>& P,
+		const util::RowVector<long long>& p0,
+		const util::MatrixExt<long long>& Q,
+		const util::RowVector<long long>& q0,
+		const DependenceRecorder& record,
+		bool are_distinct,
+		const DependenceTestOptions& options)
+	{
+		const arma::uword m(A.n_rows);
+
+		/**
+		 * STEP 1: form a system of diophantine equations suitable for diophantine solver. Coefficient matrix W is formed by appending rows of
+		 * -B to matrix A, and it has already been reduced to echelon form UW = S by the factorization. Only right-hand side is formed here.
+		 */
+		Vector c(A.n_cols);
+		for (auto col = 0U; col < A.n_cols; ++col)
+			c(col) = b0(col) - a0(col);
 
 		/** STEP 2: solve this system of diophantine equations. */
-		util::MatrixExt<long long> U(W.n_rows, W.n_rows);
-		util::RowVector<long long> t(W.n_rows);
-		arma::uword rank_s;
+		const Matrix& U(factorization.U);
+		const arma::uword rank_s(factorization.rank_s);
+		Vector t(U.n_rows);
 
-		if (!SolveDiophantineSystem(W, b0 - a0, U, t, rank_s))
+		if (!util::SolveFactoredDiophantineSystem(factorization, c, t))
 		{
 			/** System has no integer solution. These variables cannot cause dependence between S and T. */
 			return false;
@@ -106,14 +612,11 @@ namespace
 		 * STEP 3, 4 and 5.1 and 5.2(part 1): calculate matrices U1*P, U1*Q, U2*P and U2*Q part of system of inequalities formed by loop
 		 * nest bounds. Matrix U is composed of two (equaly sized) matrices [U1 | U2] that correspond to vectors i and j respectively.
 		 */
-		util::MatrixExt<long long> U1(U(arma::span(0, U.n_rows - 1), arma::span(0, A.n_rows - 1)));
-		util::MatrixExt<long long> U2(U(arma::span(0, U.n_rows - 1), arma::span(A.n_rows, U.n_rows - 1)));
-
-		util::MatrixExt<long long>
-			IP(U1 * P),
-			IQ(U1 * Q),
-			JP(U2 * P),
-			JQ(U2 * Q);
+		const Matrix
+			IP(MultiplyColumnBlock(U, 0, P)),
+			IQ(MultiplyColumnBlock(U, 0, Q)),
+			JP(MultiplyColumnBlock(U, m, P)),
+			JQ(MultiplyColumnBlock(U, m, Q));
 
 		/**
 		 * Form a system of 4m inequalities (m is number of loops) with (4m - rank_s) variables -> number of undetermined components of vector t.
@@ -122,277 +625,482 @@ namespace
 		 * NOTE: in case where every component of t is determined, we only have to verify that solution vectors i (t*U1) and j (t*U2) trivially
 		 * satisfies the system of inequalities imposed by loop nest boundaries. In this case Z is set to (1 x 4m) zero matrix.
 		 */
-		util::MatrixExt<long long> Z(U.n_rows == rank_s ? 1 : U.n_rows - rank_s, 4 * A.n_rows);
-		util::RowVector<long long> v(4 * A.n_rows);
+		util::MatrixExt<long long> Z(U.n_rows == rank_s ? 1 : U.n_rows - rank_s, 4 * m);
+		util::RowVector<long long> v(4 * m);
 
-		if (U.n_rows > rank_s)
+		arma::uword start_col(0);
+		for (auto i : { &IP, &JP, &IQ, &JQ })
 		{
 			/**
-			 * There are 4m - rank_s undetermined components of t. We have to fill in the matrix Z so that it will contain proper coefficients for
-			 * these components in the system t_unknown*Z <= v.
+			 * The lower 4m - rank_s rows of every matrix are the coefficients of undetermined components of vector t. In case of matrices U1*P
+			 * and U2*P, they have to be moved to the left side of the system, which is why these are multiplied by -1. The upper rank_s rows
+			 * multiplied with the known components of t are moved to the right side together with p0 or q0 (depending on the matrix), so
+			 * in case of matrices U1*Q and U2*Q these are multiplied by -1.
 			 */
-			arma::uword start_col(0);
-			for (auto i : { &IP, &JP, &IQ, &JQ })
-			{
-				/**
-				 * In case of matrices U1*P and U2*P, the lower 4m - rank_s rows (that are actually the coefficients for undetermined components
-				 * of vector t) has to be moved to left side of the system. This is why these are multiplied by -1.
-				 */
-				int sign(1);
-				if (i == &IP || i == &JP)
-					sign = -1;
-
-				Z(arma::span(0, Z.n_rows - 1), arma::span(start_col, start_col + P.n_cols - 1)) =
-					sign * (*i)(arma::span(rank_s, U.n_rows - 1), arma::span(0, P.n_cols - 1));
-				start_col += P.n_cols;
-			}
-		}
+			const bool lower_bound(i == &IP || i == &JP);
+			const long long sign(lower_bound ? -1 : 1);
+			const util::RowVector<long long>& p0_or_q0(lower_bound ? p0 : q0);
 
-		/** Similarly, we have to fill in the vector v that will represent the right-hand side of the system of inequalities t_unknown*Z <= v. */
-		{
-			arma::uword start_col(0);
-			for (auto i : { &IP, &JP, &IQ, &JQ })
+			for (auto col = 0U; col < m; ++col)
 			{
-				/**
-				 * In case of matrices U1*Q and U2*Q, the upper rank_s rows (that corresponds to part of the right-hand side of the system of inequalites)
-				 * need to be moved to the right side. This is why these are multiplied by -1 after multiplication with the known component of t.
-				 */
-				int sign(1);
-				if (i == &IQ || i == &JQ)
-					sign = -1;
-
-				/** We must chose either p0 or q0 depending on the matrix we currently work with. */
-				const util::RowVector<long long>& p0_or_q0(i == &IP || i == &JP ? p0 : q0);
+				for (auto row = rank_s; row < U.n_rows; ++row)
+					Z(row - rank_s, start_col + col) = sign * (*i)(row, col);
 
-				v(0, arma::span(start_col, start_col + P.n_cols - 1)) =
-					sign * t(0, arma::span(0, rank_s - 1)) * (*i)(arma::span(0, rank_s - 1), arma::span(0, P.n_cols - 1)) +
-					-sign * p0_or_q0(0, arma::span(0, p0_or_q0.n_cols - 1));
-				start_col += P.n_cols;
+				long long known(0);
+				for (auto row = 0U; row < rank_s; ++row)
+					known += t(row) * (*i)(row, col);
+				v(start_col + col) = -sign * (known - p0_or_q0(col));
 			}
-		}
-
-		std::vector<util::Bound> low_bound, upper_bound;
-		if (!util::PerformFourierElimination(Z, v, low_bound, upper_bound))
-		{
-			/**
-			 * System of inequalities has no REAL solution. There are two possibilites:
-			 * 1) All components of t are determined, however corresponding vectors i and j are outside the loop nest boundary
-			 * 2) It is impossible to find values for undetermined components of t such that corresponding solution vectors i
-			 *    and j will fall within loop nest boundary.
-			 *
-			 * Variables cannot cause dependence between S and T.
-			 */
-			return false;
+			start_col += m;
 		}
 
 		/**
 		 * STEPS 5.2 (part 2), 6 and 7: form set that represents dependence of T on S, and S on T. For every dependence, calculate
 		 * dependence distance and direction vectors, as well as level of dependence.
+		 *
+		 * If the system of inequalities has no solution, there are two possibilites:
+		 * 1) All components of t are determined, however corresponding vectors i and j are outside the loop nest boundary
+		 * 2) It is impossible to find values for undetermined components of t such that corresponding solution vectors i
+		 *    and j will fall within loop nest boundary.
+		 *
+		 * Variables cannot cause dependence between S and T.
 		 */
 		if (U.n_rows == rank_s)
 		{
+			if (!SolveDependenceSystem(Z, v, false, options, nullptr))
+				return false;
+
 			/**
 			 * Vectors i = tU1 and j=tU2 trivially satisfy the loop nest bounds. As all components of t are determined, there is only
 			 * one solution and we have to decide if T depend on S or the other way around.
 			 */
-			util::RowVector<long long> i(t*U1);
-			util::RowVector<long long> j(t*U2);
-			switch (util::RowVector<long long>::CompareLexicographically(i, j))
-			{
-			case util::RowVector<long long>::RightGreater:	/** i < j (lexicographically). */
-				T_on_S.push_back(DependenceInfo(i, j));
-				break;
-
-			case util::RowVector<long long>::LeftGreater:	/** i > j (lexicographically). */
-				S_on_T.push_back(DependenceInfo(i, j));
-				break;
-
-			default:							/** i == j leads to dependence only when S < T (S and T are distinct statements). */
-				if (are_distinct)
-					T_on_S.push_back(DependenceInfo(i, j));
-				break;
-			}
+			util::RowVector<long long> i(MultiplyByColumnBlock(t, U, 0, m));
+			util::RowVector<long long> j(MultiplyByColumnBlock(t, U, m, m));
+			return RecordGeneralDependence(i, j, are_distinct, record) != RECORD_NONE;
 		}
 		else
 		{
 			/**
-			 * Invoke EnumerateIntegerSolutions() to find all integer values of undetermined components of vector t, for which solution
-			 * vectors i and j fall within loop limits. If there are no integer solutions, these variable cannot cause dependence between
-			 * statements S and T.
+			 * Enumerate all integer values of undetermined components of vector t, for which solution vectors i and j fall within loop
+			 * limits. If there are no integer solutions, these variable cannot cause dependence between statements S and T. Solutions
+			 * are streamed one at a time, so the solution set is never materialized in memory.
+			 *
+			 * Vectors i = tU1 and j = tU2 are kept between the solutions, starting from the undetermined components of t set to zero.
+			 * Consecutive solutions usually differ only in the last component (by +1), so only the rows of U of the components that
+			 * have changed are added to i and j, multiplied by the change.
 			 */
-			//std::vector<RowVector<long long>> all_t_undetermined;
-			std::vector<std::vector<util::RowVector<long long>>> all_t_undetermined_sets;
-			if (!EnumerateIntegerSolutions(low_bound, upper_bound, all_t_undetermined_sets))
-				return false;
+			for (auto row = rank_s; row < U.n_rows; ++row)
+				t(row) = 0;
 
-			/** Reserve some memory to minimize the number of reallocations when pushing new elements to vectors. */
-			//T_on_S.reserve(static_cast<size_t>(all_t_undetermined.size() * 0.7));
-			//S_on_T.reserve(static_cast<size_t>(all_t_undetermined.size() * 0.7));
-			T_on_S.reserve(static_cast<size_t>(all_t_undetermined_sets[0].size() * 0.7));
-			S_on_T.reserve(static_cast<size_t>(all_t_undetermined_sets[0].size() * 0.7));
+			util::RowVector<long long> i(MultiplyByColumnBlock(t, U, 0, m));
+			util::RowVector<long long> j(MultiplyByColumnBlock(t, U, m, m));
+			util::RowVector<long long> previous_t(U.n_rows - rank_s);
+			bool has_dependence(false);
 
-			/** We're taking into consideration that all integers solutions might not be able to fit into single std::vector. */
-			for (auto & all_t_undetermined : all_t_undetermined_sets)
+			if (!SolveDependenceSystem(Z, v, true, options, [&](const util::RowVector<long long>& single_t)
 			{
-				for (const auto & single_t : all_t_undetermined)
+				for (auto k = 0U; k < single_t.n_cols; ++k)
 				{
-					t(0, arma::span(rank_s, t.n_cols - 1)) = single_t;
-					util::RowVector<long long> i(t*U1);
-					util::RowVector<long long> j(t*U2);
-					arma::uword lev;
+					const long long delta(single_t(k) - previous_t(k));
+					if (delta == 0)
+						continue;
 
-					switch (util::RowVector<long long>::CompareLexicographically(i, j, lev))
+					for (auto col = 0U; col < m; ++col)
 					{
-					case util::RowVector<long long>::RightGreater:	/** i < j (lexicographically). */
-						T_on_S.push_back(DependenceInfo(i, j, j - i, lev));
-						break;
-
-					case util::RowVector<long long>::LeftGreater:	/** i > j (lexicographically). */
-						S_on_T.push_back(DependenceInfo(i, j, i - j, lev));
-						break;
-
-					default:							/** i == j leads to dependence only when S < T (S and T are distinct statements). */
-						if (are_distinct)
-							T_on_S.push_back(DependenceInfo(i, j, util::RowVector<long long>(i.n_cols), lev));
-						break;
+						i(col) += delta * U(rank_s + k, col);
+						j(col) += delta * U(rank_s + k, m + col);
 					}
+					previous_t(k) = single_t(k);
 				}
-			}
+
+				const RecordResult result(RecordGeneralDependence(i, j, are_distinct, record));
+				has_dependence = has_dependence || result != RECORD_NONE;
+				return result != RECORD_STOP;
+			}))
+				return false;
+
+			return has_dependence;
 		}
+	}
 
-		return !(T_on_S.empty() && S_on_T.empty());
+	/**
+	 * Systems of nest-sized loops are solved on matrices with inline storage, larger ones fall back to MatrixExt. The method calls small()
+	 * if the coefficient matrix of the general system with (num_rows x num_cols) subscript matrices fits into SmallMatrix, large()
+	 * otherwise, and returns its result.
+	 */
+	template<typename Small, typename Large>
+	auto DispatchOnGeneralSystemSize(arma::uword num_rows, arma::uword num_cols, const Small& small, const Large& large) -> decltype(large())
+	{
+		if (util::SmallMatrix<long long>::Fits(2 * num_rows, std::max(num_cols, 2 * num_rows)))
+			return small();
+
+		return large();
 	}
 
-	bool UniformLinearDependenceTest(
+	/** Validates arguments of GeneralLinearDependenceTest() and carries it out, handing every dependence to the recorder. */
+	bool RunGeneralLinearDependenceTest(
 		const util::MatrixExt<long long>& A,
 		const util::RowVector<long long>& a0,
+		const util::MatrixExt<long long>& B,
 		const util::RowVector<long long>& b0,
 		const util::MatrixExt<long long>& P,
 		const util::RowVector<long long>& p0,
+		const util::MatrixExt<long long>& Q,
 		const util::RowVector<long long>& q0,
-		std::vector<DependenceInfo>& T_on_S,
-		std::vector<DependenceInfo>& S_on_T,
-		bool are_distinct)
+		const DependenceRecorder& record,
+		bool are_distinct,
+		const DependenceTestOptions& options,
+		const DependenceSystemFactorization* factorization)
+	{
+
+		/** Validate arguments. */
+		ValidateArguments(A, a0, B, b0, P, p0, Q, q0);
+
+		if (factorization == nullptr)
+		{
+			const DependenceSystemFactorization own_factorization(A, B, SYSTEM_GENERAL);
+			return RunGeneralLinearDependenceTest(A, a0, B, b0, P, p0, Q, q0, record, are_distinct, options, &own_factorization);
+		}
+		ValidateFactorization(*factorization, A, SYSTEM_GENERAL);
+
+		return DispatchOnGeneralSystemSize(factorization->GetNumSubscriptRows(), factorization->GetNumSubscriptCols(),
+			[&]()
+			{
+				return GeneralLinearDependenceTestImpl<util::SmallMatrix<long long>, util::SmallRowVector<long long>>(
+					factorization->GetSmallFactorization(), A, a0, b0, P, p0, Q, q0, record, are_distinct, options);
+			},
+			[&]()
+			{
+				return GeneralLinearDependenceTestImpl<util::MatrixExt<long long>, util::RowVector<long long>>(
+					factorization->GetFactorization(), A, a0, b0, P, p0, Q, q0, record, are_distinct, options);
+			});
+	}
+
+	/** Validates arguments of UniformLinearDependenceTest() and carries it out, handing every dependence to the recorder. */
+	bool RunUniformLinearDependenceTest(
+		const util::MatrixExt<long long>& A,
+		const util::RowVector<long long>& a0,
+		const util::RowVector<long long>& b0,
+		const util::MatrixExt<long long>& P,
+		const util::RowVector<long long>& p0,
+		const util::RowVector<long long>& q0,
+		const DependenceRecorder& record,
+		bool are_distinct,
+		const DependenceTestOptions& options,
+		const DependenceSystemFactorization* factorization)
 	{
 		/** Validate arguments. */
 		ValidateArguments(A, a0, A, b0, P, p0, P, q0);
 
-		/** STEP 1: solve system of diophantine equations kA = a0 - b0 where k = j - i. */
-		util::MatrixExt<long long> U(A.n_rows, A.n_rows);
-		util::RowVector<long long> t(A.n_rows);
-		arma::uword rank_s;
+		if (factorization == nullptr)
+		{
+			const DependenceSystemFactorization own_factorization(A, A, SYSTEM_UNIFORM);
+			return RunUniformLinearDependenceTest(A, a0, b0, P, p0, q0, record, are_distinct, options, &own_factorization);
+		}
+		ValidateFactorization(*factorization, A, SYSTEM_UNIFORM);
 
-		if (!SolveDiophantineSystem(A, a0 - b0, U, t, rank_s))
+		/** STEPS 1 and 2: solve system of diophantine equations kA = a0 - b0 and form system of inequalities t_unknown * Z <= v. */
+		const util::MatrixExt<long long>& U(factorization->GetFactorization().U);
+		const arma::uword rank_s(factorization->GetFactorization().rank_s);
+		util::MatrixExt<long long> Z(0, 0);
+		util::RowVector<long long> t(0), v(0);
+
+		if (!FormUniformDependenceSystem(factorization->GetFactorization(), a0, b0, P, p0, q0, t, Z, v))
 		{
 			/** Variables X(iA + a0) and X(jA + b0) don't cause dependence between S and T. */
 			return false;
 		}
 
 		/**
-		 * STEP 2: verify if system of inequalities p0 - q0 <= tUP <= q0 - p0. We must transform this into t_unknown * Z <= v system
-		 * where Z is (2m - rank_s x 2m) coefficient matrix and v is (1 x 2m) vector representing right-hand side of the system.
-		 *
-		 * NOTE: when m == rank_s every component of vector t is determined. In this case we only need to check if the system of form
-		 * 0 <= v - t_unknown * Z is trivially satisfied. In this case matrix Z is (1 * 2m) zero matrix.
+		 * STEP 3: extract dependence info. If the system is either not trivially satisfied or it is impossible to find such undetermined
+		 * components of t so that system of inequalities p0 - q0 <= tUP <= q0 - p0 will be satisfied, variable X(iA + a0) and X(jA + b0)
+		 * cannot cause dependence between S and T.
 		 */
-		util::MatrixExt<long long> Z(U.n_rows == rank_s ? 1 : U.n_rows - rank_s, 2 * U.n_rows);
-		util::RowVector<long long> v(2 * U.n_rows);
-		util::MatrixExt<long long> UP(std::move(U * P));
+		if (U.n_rows == rank_s)
+		{
+			if (!SolveDependenceSystem(Z, v, false, options, nullptr))
+				return false;
 
-		if (U.n_rows > rank_s)
+			/** STEP 3.1: There is single solution vector t based on which dependence info can be calculated. */
+			return RecordUniformDependence(util::RowVector<long long>(t * U), are_distinct, record) != RECORD_NONE;
+		}
+		else
 		{
-			/**
-			 * Fill matrix Z using bottom 2m - rank_s rows of matrix U*P from system: -tUP <= q0 - p0 and tUP <= q0 - p0. First m columns
-			 * come from tUP <= q0 - p0 taking bottom wm - rank_s rows of matrix U*P. Last m colums come from -tUP <= q0 - p0 so they are
-			 * inverted copy of first m columns.
-			 */
-			Z(arma::span::all, arma::span(0, UP.n_rows - 1)) = UP(arma::span(rank_s, UP.n_rows - 1), arma::span::all);
-			Z(arma::span::all, arma::span(UP.n_rows, 2 * UP.n_rows - 1)) = -1 * Z(arma::span::all, arma::span(0, UP.n_rows - 1));
+			/** STEPs 2.2 and 3.2: enumerate all integer solutions for unknown components of t and extract dependence info. */
+			bool has_dependence(false);
+			if (!SolveDependenceSystem(Z, v, true, options, [&](const util::RowVector<long long>& single_t)
+			{
+				t(0, arma::span(rank_s, t.n_cols - 1)) = single_t;
+				const RecordResult result(RecordUniformDependence(util::RowVector<long long>(t * U), are_distinct, record));
+				has_dependence = has_dependence || result != RECORD_NONE;
+				return result != RECORD_STOP;
+			}))
+				return false;
+
+			return has_dependence;
 		}
+	}
 
+} /// unnamed namespace
+
+	DependenceSystemFactorization::DependenceSystemFactorization(
+		const util::MatrixExt<long long>& A,
+		const util::MatrixExt<long long>& B,
+		DependenceSystemKind kind)
+		: m_kind(kind)
+		, m_num_rows(A.n_rows)
+		, m_num_cols(A.n_cols)
+		, m_is_small(false)
+	{
+		if (A.is_empty())
+			throw std::logic_error("DependenceSystemFactorization(): subscript matrix A must be non-empty");
+
+		if (kind == SYSTEM_UNIFORM)
 		{
-			/**
-			 * Fill vector v by combining determined part of vector t*U*P with vectors p0 and q0. First m columns are obtained from tUP <= q0 - p0
-			 * inequality. Last m columns are obtained from -tUP <= q0 - p0 inequality.
-			 */
-			util::RowVector<long long> q0_minus_p0(std::move(q0 - p0));
-			util::RowVector<long long> tmp(std::move((t(0, arma::span(0, rank_s - 1)) * UP(arma::span(0, rank_s - 1), arma::span::all)).eval()));
-			v(0, arma::span(0, UP.n_rows - 1)) = std::move(-1LL * tmp + q0_minus_p0);
-			v(0, arma::span(UP.n_rows, 2 * UP.n_rows - 1)) = std::move(tmp + q0_minus_p0);
+			util::FactorDiophantineSystem(A, m_large);
+			return;
 		}
 
-		std::vector<util::Bound> lower_bound, upper_bound;
-		if (!util::PerformFourierElimination(Z, v, lower_bound, upper_bound))
+		if (A.n_rows != B.n_rows || A.n_cols != B.n_cols)
+			throw std::logic_error("DependenceSystemFactorization(): subscript matrices A and B are not compatible");
+
+		m_is_small = DispatchOnGeneralSystemSize(A.n_rows, A.n_cols,
+			[&]()
+			{
+				util::FactorDiophantineSystem(FormGeneralCoefficientMatrix<util::SmallMatrix<long long>>(A, B), m_small);
+				return true;
+			},
+			[&]()
+			{
+				util::FactorDiophantineSystem(FormGeneralCoefficientMatrix<util::MatrixExt<long long>>(A, B), m_large);
+				return false;
+			});
+	}
+
+	bool GeneralLinearDependenceTest(
+		const util::MatrixExt<long long>& A,
+		const util::RowVector<long long>& a0,
+		const util::MatrixExt<long long>& B,
+		const util::RowVector<long long>& b0,
+		const util::MatrixExt<long long>& P,
+		const util::RowVector<long long>& p0,
+		const util::MatrixExt<long long>& Q,
+		const util::RowVector<long long>& q0,
+		std::vector<DependenceInfo>& T_on_S,
+		std::vector<DependenceInfo>& S_on_T,
+		bool are_distinct,
+		const DependenceTestOptions& options,
+		const DependenceSystemFactorization* factorization)
+	{
+		return RunGeneralLinearDependenceTest(A, a0, B, b0, P, p0, Q, q0, QueryOrRecorder(options, StoringRecorder(T_on_S, S_on_T)),
+			are_distinct, options, factorization);
+	}
+
+	bool GeneralLinearDependenceTest(
+		const util::MatrixExt<long long>& A,
+		const util::RowVector<long long>& a0,
+		const util::MatrixExt<long long>& B,
+		const util::RowVector<long long>& b0,
+		const util::MatrixExt<long long>& P,
+		const util::RowVector<long long>& p0,
+		const util::MatrixExt<long long>& Q,
+		const util::RowVector<long long>& q0,
+		const DependenceSink& sink,
+		bool are_distinct,
+		const DependenceTestOptions& options,
+		const DependenceSystemFactorization* factorization)
+	{
+		return RunGeneralLinearDependenceTest(A, a0, B, b0, P, p0, Q, q0, QueryOrRecorder(options, SinkRecorder(sink)), are_distinct, options,
+			factorization);
+	}
+
+	bool UniformLinearDependenceTest(
+		const util::MatrixExt<long long>& A,
+		const util::RowVector<long long>& a0,
+		const util::RowVector<long long>& b0,
+		const util::MatrixExt<long long>& P,
+		const util::RowVector<long long>& p0,
+		const util::RowVector<long long>& q0,
+		std::vector<DependenceInfo>& T_on_S,
+		std::vector<DependenceInfo>& S_on_T,
+		bool are_distinct,
+		const DependenceTestOptions& options,
+		const DependenceSystemFactorization* factorization)
+	{
+		return RunUniformLinearDependenceTest(A, a0, b0, P, p0, q0, QueryOrRecorder(options, StoringRecorder(T_on_S, S_on_T)), are_distinct,
+			options, factorization);
+	}
+
+	bool UniformLinearDependenceTest(
+		const util::MatrixExt<long long>& A,
+		const util::RowVector<long long>& a0,
+		const util::RowVector<long long>& b0,
+		const util::MatrixExt<long long>& P,
+		const util::RowVector<long long>& p0,
+		const util::RowVector<long long>& q0,
+		const DependenceSink& sink,
+		bool are_distinct,
+		const DependenceTestOptions& options,
+		const DependenceSystemFactorization* factorization)
+	{
+		return RunUniformLinearDependenceTest(A, a0, b0, P, p0, q0, QueryOrRecorder(options, SinkRecorder(sink)), are_distinct, options,
+			factorization);
+	}
+
+	bool UniformLinearDependenceLattice(
+		const util::MatrixExt<long long>& A,
+		const util::RowVector<long long>& a0,
+		const util::RowVector<long long>& b0,
+		const util::MatrixExt<long long>& P,
+		const util::RowVector<long long>& p0,
+		const util::RowVector<long long>& q0,
+		DistanceLattice& lattice,
+		bool are_distinct,
+		const DependenceSystemFactorization* factorization)
+	{
+		/** Validate arguments. */
+		ValidateArguments(A, a0, A, b0, P, p0, P, q0);
+
+		if (factorization == nullptr)
 		{
-			/**
-			 * System is either not trivially satisfied or it is impossible to find such undetermined components of t so that system of inequalities
-			 * p0 - q0 <= tUP <= q0 - p0 will be satisfied. Variable X(iA + a0) and X(jA + b0) cannot cause dependence between S and T.
-			 */
-			return false;
+			const DependenceSystemFactorization own_factorization(A, A, SYSTEM_UNIFORM);
+			return UniformLinearDependenceLattice(A, a0, b0, P, p0, q0, lattice, are_distinct, &own_factorization);
 		}
+		ValidateFactorization(*factorization, A, SYSTEM_UNIFORM);
 
-		/** STEP 3: extract dependence info. */
-		if (U.n_rows == rank_s)
+		/** STEPS 1 and 2: exactly the same as in UniformLinearDependenceTest(). */
+		const util::MatrixExt<long long>& U(factorization->GetFactorization().U);
+		const arma::uword rank_s(factorization->GetFactorization().rank_s);
+		util::MatrixExt<long long> Z(0, 0);
+		util::RowVector<long long> t(0), v(0);
+
+		if (!FormUniformDependenceSystem(factorization->GetFactorization(), a0, b0, P, p0, q0, t, Z, v))
+			return false;
+
+		std::vector<util::Bound> lower_bound, upper_bound;
+		if (!util::PerformFourierElimination(Z, v, lower_bound, upper_bound, IntegerFourierOptions()))
+			return false;
+
+		/**
+		 * STEP 3: k = tU = t_determined * U_top + t_unknown * U_bottom where U_top are the first rank_s rows of U. Determined part of k is the
+		 * base vector of the lattice, while rows of U_bottom (linearly independent as U is unimodular) are its generators. Undetermined
+		 * components of t are the parameters of the lattice and they are constrained by the system t_unknown * Z <= v.
+		 */
+		lattice.base.zeros(1, U.n_cols);
+		if (rank_s > 0)
+			lattice.base = t(0, arma::span(0, rank_s - 1)) * U(arma::span(0, rank_s - 1), arma::span::all);
+
+		const arma::uword num_params(U.n_rows - rank_s);
+		lattice.param_lower.zeros(1, num_params);
+		lattice.param_upper.zeros(1, num_params);
+		if (num_params > 0)
 		{
-			/** STEP 3.1: There is single solution vector t based on which dependence info can be calculated. */
-			util::RowVector<long long> k(std::move(t * U));
-			arma::uword lev(0);
-			switch (util::RowVector<long long>::CompareLexicographically(k, util::RowVector<long long>(k.n_cols), lev))
+			lattice.generators = U(arma::span(rank_s, U.n_rows - 1), arma::span::all);
+			lattice.constraints = Z;
+			lattice.constraints_rhs = v;
+
+			/** STEP 4: find the range of every parameter. */
+			for (auto l = 0U; l < num_params; ++l)
 			{
-			case util::RowVector<long long>::LeftGreater:		/** k > 0 (means i < j lexicographically) */
-				T_on_S.push_back(DependenceInfo(k, lev));
-				break;
-
-			case util::RowVector<long long>::RightGreater:		/** k < 0 ( means i > j) */
-				S_on_T.push_back(DependenceInfo(-1LL * k, lev));
-				break;
-
-			default:								/** k == 0 (means i == j) leads to dependence only when S and T are distinct statements */
-				if (are_distinct)
-					T_on_S.push_back(DependenceInfo(k, lev));
-				break;
+				util::RowVector<long long> coeffs(num_params);
+				coeffs(l) = 1;
+				if (!FindIntegerRange(Z, v, coeffs, 0, lattice.param_lower(l), lattice.param_upper(l)))
+					return false;
 			}
 		}
 		else
 		{
-			/** STEPs 2.2 and 3.2: enumerate all integer solutions for unknown components of t and extract dependence info. */
-			//std::vector<RowVector<long long>> all_t_undetermined;
-			std::vector<std::vector<util::RowVector<long long>>> all_t_undetermined_sets;
-			if (!EnumerateIntegerSolutions(lower_bound, upper_bound, all_t_undetermined_sets))
-				return false;
-
-			/** Reserve some memory to minimize the number of reallocations when pushing new elements to vectors. */
-			T_on_S.reserve(static_cast<size_t>(all_t_undetermined_sets[0].size() * 0.7));
-			S_on_T.reserve(static_cast<size_t>(all_t_undetermined_sets[0].size() * 0.7));
+			lattice.generators.zeros(0, U.n_cols);
+			lattice.constraints.zeros(0, Z.n_cols);
+			lattice.constraints_rhs.zeros(1, Z.n_cols);
+		}
 
-			for (auto & all_t_undetermined : all_t_undetermined_sets)
+		/** STEP 5: find the range of every component (level) of distance vector k. The cost depends only on the depth of the loop nest. */
+		lattice.dist_lower = lattice.base;
+		lattice.dist_upper = lattice.base;
+		if (num_params > 0)
+		{
+			for (auto l = 0U; l < U.n_cols; ++l)
 			{
-				for (const auto & single_t : all_t_undetermined)
-				{
-					t(0, arma::span(rank_s, t.n_cols - 1)) = single_t;
-					util::RowVector<long long> k(std::move(t * U));
-					arma::uword lev;
+				util::RowVector<long long> coeffs(util::MatrixExt<long long>(lattice.generators.col(l).t()));
+				if (!FindIntegerRange(Z, v, coeffs, lattice.base(l), lattice.dist_lower(l), lattice.dist_upper(l)))
+					return false;
+			}
+		}
 
-					switch (util::RowVector<long long>::CompareLexicographically(k, util::RowVector<long long>(k.n_cols), lev))
-					{
-					case util::RowVector<long long>::LeftGreater:		/** k > 0 (means i < j lexicographically) */
-						T_on_S.push_back(DependenceInfo(k, lev));
-						break;
-
-					case util::RowVector<long long>::RightGreater:		/** k < 0 ( means i > j) */
-						S_on_T.push_back(DependenceInfo(-1LL * k, lev));
-						break;
-
-					default:								/** k == 0 (means i == j) leads to dependence only when S and T are distinct statements */
-						if (are_distinct)
-							T_on_S.push_back(DependenceInfo(k, lev));
-						break;
-					}
-				}
+		/** When k = 0 is the only distance vector, there is dependence only if S and T are distinct statements. */
+		auto is_zero = [](long long value) { return value == 0; };
+		if (!are_distinct && std::all_of(lattice.dist_lower.begin(), lattice.dist_lower.end(), is_zero) &&
+			std::all_of(lattice.dist_upper.begin(), lattice.dist_upper.end(), is_zero))
+			return false;
+
+		return true;
+	}
+
+	std::size_t InsertLatticeDistances(const DistanceLattice& lattice, util::DistanceSet& distances)
+	{
+		if (lattice.base.n_cols != distances.NestDepth())
+			throw std::logic_error("c2cuda::InsertLatticeDistances(): Lattice and distance set have different nest depths.");
+
+		std::size_t inserted(0);
+		const util::RowVector<long long> zero(lattice.base.n_cols);
+		auto insert_positive = [&](const util::RowVector<long long>& k)
+		{
+			if (util::RowVector<long long>::CompareLexicographically(k, zero) == util::RowVector<long long>::LeftGreater)
+			{
+				distances.Insert(k);
+				++inserted;
 			}
+			return true;
+		};
+
+		if (lattice.generators.n_rows == 0)
+		{
+			insert_positive(lattice.base);
+			return inserted;
 		}
 
-		return !(T_on_S.empty() && S_on_T.empty());
+		std::vector<util::Bound> lower_bound, upper_bound;
+		if (!util::PerformFourierElimination(lattice.constraints, lattice.constraints_rhs, lower_bound, upper_bound, IntegerFourierOptions()))
+			return inserted;
+
+		util::EnumerateIntegerSolutions(lower_bound, upper_bound, [&](const util::RowVector<long long>& t)
+		{
+			return insert_positive(util::RowVector<long long>(lattice.base + t * lattice.generators));
+		});
+		return inserted;
+	}
+
+	PrefilterTier PrefilterDependenceTest(
+		const util::MatrixExt<long long>& A,
+		const util::RowVector<long long>& a0,
+		const util::MatrixExt<long long>& B,
+		const util::RowVector<long long>& b0,
+		const util::MatrixExt<long long>& P,
+		const util::RowVector<long long>& p0,
+		const util::MatrixExt<long long>& Q,
+		const util::RowVector<long long>& q0)
+	{
+		/** Validate arguments. */
+		ValidateArguments(A, a0, B, b0, P, p0, Q, q0);
+
+		PrefilterTier tier(RunPrefilter(A, a0, B, b0, P, p0, Q, q0));
+		++prefilter_hits[tier];
+		return tier;
+	}
+
+	PrefilterStatistics GetPrefilterStatistics()
+	{
+		PrefilterStatistics stats;
+		for (auto i = 0U; i < PREFILTER_TIER_CNT; ++i)
+			stats.hits[i] = prefilter_hits[i].load();
+		return stats;
+	}
+
+	void ResetPrefilterStatistics()
+	{
+		for (auto & hits : prefilter_hits)
+			hits = 0;
 	}
 
 } /// namespace dep
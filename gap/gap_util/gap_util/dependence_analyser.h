@@ -36,13 +36,112 @@
 #define GAP_DEPENDENCE_ANALYSER_H
 
 #include <vector>
+#include <functional>
 #include "dependence_info.h"
+#include "distance_set.h"
+#include "fourier_elimination.h"
+#include "diophantine.h"
 
 namespace gap
 {
 namespace dep
 {
 
+/** Engines that can be used by the dependence analysers to find integer solutions of the system of inequalities formed from loop bounds. */
+enum IntegerEngine
+{
+	ENGINE_FOURIER = 0		/** PerformFourierElimination() followed by EnumerateIntegerSolutions() (fourier_elimination.h). */
+	, ENGINE_OMEGA			/** OmegaEnumerateIntegerSolutions() (omega_elimination.h). */
+};
+
+class DistanceQuery;
+
+/** Options shared by the exact dependence analysers. */
+struct DependenceTestOptions
+{
+	IntegerEngine engine;
+	util::FourierEliminationOptions fourier_options;	/** Used by ENGINE_FOURIER only. */
+
+	/**
+	 * When set, GeneralLinearDependenceTest() and UniformLinearDependenceTest() hand the distance vector of every dependence to the query
+	 * (@see distance_query.h) instead of storing it in T_on_S or S_on_T, and stop enumerating the dependences as soon as the query is
+	 * answered. The tests still return TRUE if they have found a dependence.
+	 */
+	DistanceQuery* query;
+
+	/**
+	 * When set, ENGINE_FOURIER enumerates the integer solutions of the dependence systems on this pool (@see
+	 * util::EnumerateIntegerSolutionsInOrder()). Dependences are handed over while they are enumerated, in the same order as without the
+	 * pool, and the enumeration stops as soon as the sink or the query does. The tests must not be run from tasks of this pool, use a pool
+	 * that is not shared with the callers.
+	 */
+	util::ThreadPool* enumeration_pool;
+
+	DependenceTestOptions()
+		: engine(ENGINE_FOURIER)
+		, query(nullptr)
+		, enumeration_pool(nullptr)
+	{
+		fourier_options.arithmetic = util::FOURIER_INTEGER;
+	}
+};
+
+/** Kind of the diophantine system factored by DependenceSystemFactorization. */
+enum DependenceSystemKind
+{
+	SYSTEM_GENERAL = 0		/** iA - jB = b0 - a0 solved by GeneralLinearDependenceTest(). */
+	, SYSTEM_UNIFORM		/** kA = a0 - b0 solved by UniformLinearDependenceTest(). */
+};
+
+/**
+ * Echelon reduction of the coefficient matrix of the diophantine system solved by the dependence tests (@see DiophantineFactorization). It
+ * depends only on subscript matrices A and B, so pairs of variables that differ only in constant offsets a0 and b0 (e.g. a[i][j] vs a[i+1][j-1]
+ * and a[i][j] vs a[i][j+2]) can share it, and the reduction is calculated once per distinct subscript shape instead of once per pair.
+ *
+ * The factorization is immutable once constructed, so it can be shared by multiple threads.
+ */
+class DependenceSystemFactorization
+{
+public:
+	/**
+	 * Factors the coefficient matrix W = [A; -B] when kind is SYSTEM_GENERAL or A when kind is SYSTEM_UNIFORM (B is ignored in that case).
+	 *
+	 * @throw std::logic_error if A is empty or A and B have different dimensions (SYSTEM_GENERAL only).
+	 */
+	DependenceSystemFactorization(const util::MatrixExt<long long>& A, const util::MatrixExt<long long>& B, DependenceSystemKind kind);
+
+	DependenceSystemKind GetKind() const { return m_kind; }
+	arma::uword GetNumSubscriptRows() const { return m_num_rows; }
+	arma::uword GetNumSubscriptCols() const { return m_num_cols; }
+
+	/** TRUE if the system is small enough to be solved on matrices with inline storage (@see SmallMatrix::Fits()). */
+	bool IsSmall() const { return m_is_small; }
+	const util::DiophantineFactorization<util::SmallMatrix<long long>>& GetSmallFactorization() const { return m_small; }
+	const util::DiophantineFactorization<util::MatrixExt<long long>>& GetFactorization() const { return m_large; }
+
+private:
+	DependenceSystemKind m_kind;
+	arma::uword m_num_rows;
+	arma::uword m_num_cols;
+	bool m_is_small;
+	util::DiophantineFactorization<util::SmallMatrix<long long>> m_small;
+	util::DiophantineFactorization<util::MatrixExt<long long>> m_large;
+};
+
+/** Dependence sets of the dependence analysers. */
+enum DependenceDirection
+{
+	DEPENDENCE_T_ON_S = 0	/** T depends on S, distance vector is d = j - i. */
+	, DEPENDENCE_S_ON_T		/** S depends on T, distance vector is d = i - j. */
+};
+
+/**
+ * Receives every dependence found by GeneralLinearDependenceTest() or UniformLinearDependenceTest() as soon as it is found, instead of
+ * having it stored in T_on_S or S_on_T. Distance vector d is lexicographically non-negative and it is valid only during the call.
+ * Returning FALSE stops the enumeration of the dependences.
+ */
+typedef std::function<bool(const util::RowVector<long long>& d, DependenceDirection direction)> DependenceSink;
+
 /**
  * The following method performs the general linear dependence analysis on the pair of variables of two assignment statements in
  * the perfect loop nest that has the following form:
@@ -221,11 +320,17 @@ namespace dep
  *
  * @retval TRUE to indicate that variables X(iA + a0) and X(jB + b0) cause dependence between S and T, FALSE otherwise.
  *
+ * Steps that use PerformFourierElimination() and EnumerateIntegerSolutions() are carried out by the engine selected in options. Both engines
+ * produce the same dependences in the same order, Omega engine doesn't descend into parts of the REAL solution set without integer points.
+ *
  * @note This method performs so-called general linear dependence testing. It doesn't discover certain special cases that can simplify the
  * dependence analysis such as regular and rectangular loop nests, or uniform dependence distances when A = B. This makes this method much
  * slower than the other available dependence analysis procedures and it should be used as last resort when none of the special-purpose
  * methods can be applied.
  *
+ * @note When factorization is given, step 2 reuses its echelon reduction instead of reducing W again. It must be a SYSTEM_GENERAL factorization
+ * created from the same matrices A and B.
+ *
  * @see Loop Transformations for Restructuring Compilers, The Foundations (Algorithm 5.1)
  */
 
@@ -240,7 +345,28 @@ bool GeneralLinearDependenceTest(
 	const util::RowVector<long long>& q0,
 	std::vector<DependenceInfo>& T_on_S,
 	std::vector<DependenceInfo>& S_on_T,
-	bool are_distinct = true);
+	bool are_distinct = true,
+	const DependenceTestOptions& options = DependenceTestOptions(),
+	const DependenceSystemFactorization* factorization = nullptr);
+
+/**
+ * Variant of GeneralLinearDependenceTest() that hands distance vector and set of every dependence to the sink instead of storing them,
+ * so that memory consumption doesn't depend on the number of dependences. Dependences are handed over in the same order in which they
+ * are stored by the variant above. When options.query is set, distance vectors are handed to the query and the sink is not used.
+ */
+bool GeneralLinearDependenceTest(
+	const util::MatrixExt<long long>& A,
+	const util::RowVector<long long>& a0,
+	const util::MatrixExt<long long>& B,
+	const util::RowVector<long long>& b0,
+	const util::MatrixExt<long long>& P,
+	const util::RowVector<long long>& p0,
+	const util::MatrixExt<long long>& Q,
+	const util::RowVector<long long>& q0,
+	const DependenceSink& sink,
+	bool are_distinct = true,
+	const DependenceTestOptions& options = DependenceTestOptions(),
+	const DependenceSystemFactorization* factorization = nullptr);
 
 
 /**
@@ -355,6 +481,9 @@ bool GeneralLinearDependenceTest(
  *        S_on_T - object containing vector d, sig = signum(d), l = lev(d) (both i and j are 0x0 vectors)
  *
  * @retval TRUE to indicate that variables X(iA + a0) and X(jA + b0) cause dependence between S and T, FALSE otherwise.
+ *
+ * @note Like in GeneralLinearDependenceTest(), options select the engine used in step 2 and factorization (SYSTEM_UNIFORM, created from
+ * the same matrix A) saves the echelon reduction of step 1.
  */
 bool UniformLinearDependenceTest(
 	const util::MatrixExt<long long>& A,
@@ -365,7 +494,142 @@ bool UniformLinearDependenceTest(
 	const util::RowVector<long long>& q0,
 	std::vector<DependenceInfo>& T_on_S,
 	std::vector<DependenceInfo>& S_on_T,
-	bool are_distinct = true);
+	bool are_distinct = true,
+	const DependenceTestOptions& options = DependenceTestOptions(),
+	const DependenceSystemFactorization* factorization = nullptr);
+
+/** Variant of UniformLinearDependenceTest() that hands every dependence to the sink (@see GeneralLinearDependenceTest()). */
+bool UniformLinearDependenceTest(
+	const util::MatrixExt<long long>& A,
+	const util::RowVector<long long>& a0,
+	const util::RowVector<long long>& b0,
+	const util::MatrixExt<long long>& P,
+	const util::RowVector<long long>& p0,
+	const util::RowVector<long long>& q0,
+	const DependenceSink& sink,
+	bool are_distinct = true,
+	const DependenceTestOptions& options = DependenceTestOptions(),
+	const DependenceSystemFactorization* factorization = nullptr);
+
+
+/**
+ * Symbolic variant of UniformLinearDependenceTest(). Steps 1 and 2 of the algorithm are exactly the same, however instead of enumerating
+ * every integer solution of undetermined components of vector t (step 2.2), the set of uniform distance vectors k = tU is returned in
+ * closed form, as a parametric lattice (@see DistanceLattice):
+ *
+ * 1) Vector k is split into determined and undetermined part k = t_determined * U_top + t_unknown * U_bottom, where U_top are the first
+ *    rank_s rows of U and U_bottom are the remaining m - rank_s rows. Determined part is the base vector of the lattice, rows of U_bottom
+ *    are its generators and undetermined components of t are its parameters, constrained by the system t_unknown * Z <= v from step 2.
+ *
+ * 2) For every parameter tl and every component (level) kl of distance vector, the range of integer values is calculated by adding the
+ *    corresponding linear form to the system t_unknown * Z <= v as an additional variable and eliminating every other variable. Direction
+ *    summary of each level is derived from this range.
+ *
+ * The number of Fourier eliminations is linear in the depth of the loop nest and doesn't depend on the loop bounds, which makes this method
+ * suitable for loop nests with large trip counts.
+ *
+ * @param Input arguments are the same as in UniformLinearDependenceTest(). Output parameter lattice describes the set of distance vectors.
+ *
+ * @retval FALSE if variables X(iA + a0) and X(jA + b0) cannot cause dependence between S and T. TRUE if they MAY cause dependence. Unlike
+ * UniformLinearDependenceTest(), TRUE is returned as soon as the system t_unknown * Z <= v has a REAL solution and the ranges contain at least
+ * one integer, which doesn't guarantee that integer parameter vector satisfying the system exists.
+ *
+ * @note Factorization (SYSTEM_UNIFORM, created from the same matrix A) saves the echelon reduction of step 1.
+ */
+bool UniformLinearDependenceLattice(
+	const util::MatrixExt<long long>& A,
+	const util::RowVector<long long>& a0,
+	const util::RowVector<long long>& b0,
+	const util::MatrixExt<long long>& P,
+	const util::RowVector<long long>& p0,
+	const util::RowVector<long long>& q0,
+	DistanceLattice& lattice,
+	bool are_distinct = true,
+	const DependenceSystemFactorization* factorization = nullptr);
+
+/**
+ * Inserts every lexicographically positive vector of the lattice into the set of distances, so that the unimodular transformations
+ * (gap_transform) calculated from the set are the same as the ones calculated from the enumerated distance vectors. Integer parameter
+ * vectors t that satisfy the constraints are enumerated, one for each distinct distance vector rather than one for each pair of statement
+ * instances, and every vector base + t * generators is inserted as soon as it is found. With the set that drops dominated distances (@see
+ * util::DistanceSet), memory doesn't grow with the number of lattice vectors.
+ *
+ * @retval Number of vectors passed to the set (zero and negative vectors of the lattice are not counted).
+ *
+ * @throw std::logic_error if the set and the lattice don't have the same nest depth.
+ */
+std::size_t InsertLatticeDistances(const DistanceLattice& lattice, util::DistanceSet& distances);
+
+
+/**
+ * Tiers of the dependence pre-filter (@see PrefilterDependenceTest()), ordered from the cheapest one. PREFILTER_EMPTY_NEST is not a tier,
+ * it means that the loop nest has no iterations and thus no dependences. PREFILTER_UNDECIDED means that none of the tiers could prove
+ * independence and the exact dependence test has to be run.
+ */
+enum PrefilterTier
+{
+	PREFILTER_ZIV = 0
+	, PREFILTER_GCD
+	, PREFILTER_SIV
+	, PREFILTER_BANERJEE
+	, PREFILTER_EMPTY_NEST
+	, PREFILTER_UNDECIDED
+	, PREFILTER_TIER_CNT
+};
+
+/** Number of pairs of variables decided by each tier of the pre-filter since the last ResetPrefilterStatistics() call. */
+struct PrefilterStatistics
+{
+	unsigned long long hits[PREFILTER_TIER_CNT];
+};
+
+/**
+ * The following method runs a sequence of cheap, inexact dependence tests on variables X(iA + a0) of S and X(jB + b0) of T in the loop nest
+ * with bounds p0 <= IP, IQ <= q0 (the same arguments as in GeneralLinearDependenceTest()). Each subscript (column n of matrices A and B) is
+ * tested on its own. The tests can only prove that variables cannot represent the same memory location within the loop nest, and they are
+ * run in the following order:
+ *
+ * 1) ZIV (zero index variable) test: columns A(:,n) and B(:,n) are zero vectors, so subscript n is constant. If a0(n) != b0(n), there is
+ *    no dependence.
+ *
+ * 2) GCD test: equation sum(A(k,n)*ik) - sum(B(k,n)*jk) = b0(n) - a0(n) has integer solution IFF gcd of all coefficients divides the
+ *    right-hand side. This is the necessary condition checked by SolveDiophantineSystem() for the entire system.
+ *
+ * 3) SIV (single index variable) test: only loop index Ik appears in subscript n. If A(k,n) = B(k,n) = a (strong SIV) the dependence
+ *    distance jk - ik = (a0(n) - b0(n)) / a has to be an integer not greater than the range of Ik. If one of the coefficients is zero (weak
+ *    zero SIV), the only index value (b0(n) - a0(n)) / a has to be an integer within the range of Ik.
+ *
+ * 4) Banerjee bounds test: minimum and maximum of iA(:,n) - jB(:,n) + a0(n) - b0(n) are calculated over the range of every loop index. If
+ *    zero is not within [min, max], there is no dependence.
+ *
+ * Tests 3 and 4 require constant ranges of the loop indices. These are calculated from the loop bounds, from the outermost loop inwards, in
+ * case the bounds of every loop depend only on the indices of the loops that enclose it. Otherwise, these tests are skipped. If the range of
+ * some loop index is empty, PREFILTER_EMPTY_NEST is returned without running them.
+ *
+ * All tests are calculated with overflow-checked arithmetic. If a subscript difference, a range of a loop index or a Banerjee bound doesn't
+ * fit into long long, the pre-filter returns PREFILTER_UNDECIDED.
+ *
+ * Every invocation increments the hit counter of the tier (or outcome) that decided it (@see GetPrefilterStatistics()). The counters are atomic, so the
+ * method can be called from multiple threads.
+ *
+ * @retval Tier that proved there is no dependence between S and T, PREFILTER_EMPTY_NEST if the loop nest has no iterations, or
+ *         PREFILTER_UNDECIDED if the exact test has to be run.
+ */
+PrefilterTier PrefilterDependenceTest(
+	const util::MatrixExt<long long>& A,
+	const util::RowVector<long long>& a0,
+	const util::MatrixExt<long long>& B,
+	const util::RowVector<long long>& b0,
+	const util::MatrixExt<long long>& P,
+	const util::RowVector<long long>& p0,
+	const util::MatrixExt<long long>& Q,
+	const util::RowVector<long long>& q0);
+
+/** Returns the snapshot of the pre-filter hit counters. */
+PrefilterStatistics GetPrefilterStatistics();
+
+/** Sets all pre-filter hit counters to zero. */
+void ResetPrefilterStatistics();
 
 } /// namespace dep
 } /// namespace gap
@@ -0,0 +1,306 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "dependence_cache.h"
+#include "dependence_analyser.h"
+#include <unordered_set>
+#include <algorithm>
+#include <stdexcept>
+
+namespace gap
+{
+namespace dep
+{
+
+namespace
+{
+	enum TestKind
+	{
+		KIND_GENERAL = 0
+		, KIND_UNIFORM
+	};
+
+	/** Appends dimensions of matrix M followed by its elements (in column-major order) to the key. */
+	void AppendToKey(std::vector<long long>& key, const util::MatrixExt<long long>& M)
+	{
+		key.push_back(static_cast<long long>(M.n_rows));
+		key.push_back(static_cast<long long>(M.n_cols));
+		key.insert(key.end(), M.begin(), M.end());
+	}
+
+	/** Number of distance vectors the result occupies in the cache. */
+	std::size_t ResultSize(std::size_t distance_cnt)
+	{
+		return std::max<std::size_t>(distance_cnt, 1);
+	}
+
+} /// unnamed namespace
+
+	DependenceCache::DependenceCache(std::size_t capacity)
+		: m_capacity(capacity)
+		, m_size(0)
+		, m_hits(0)
+		, m_misses(0)
+		, m_evictions(0)
+	{
+		if (capacity == 0)
+			throw std::logic_error("c2cuda::DependenceCache(): capacity must be greater than zero");
+	}
+
+	bool DependenceCache::GeneralLinearDependenceTest(
+		const util::MatrixExt<long long>& A,
+		const util::RowVector<long long>& a0,
+		const util::MatrixExt<long long>& B,
+		const util::RowVector<long long>& b0,
+		const util::MatrixExt<long long>& P,
+		const util::RowVector<long long>& p0,
+		const util::MatrixExt<long long>& Q,
+		const util::RowVector<long long>& q0,
+		const DependenceSink& sink,
+		bool are_distinct,
+		const DependenceTestOptions& options,
+		const DependenceSystemFactorization* factorization)
+	{
+		/** Dependences of a query-driven test are incomplete, so they are neither looked up nor stored. */
+		if (options.query != nullptr)
+			return dep::GeneralLinearDependenceTest(A, a0, B, b0, P, p0, Q, q0, sink, are_distinct, options, factorization);
+
+		/** Arguments are validated by the test itself on a miss, incompatible a0 and b0 are kept as they are. */
+		Key key{ KIND_GENERAL, are_distinct ? 1LL : 0LL };
+		AppendToKey(key, A);
+		AppendToKey(key, B);
+		if (a0.n_cols == b0.n_cols && a0.n_cols != 0)
+			AppendToKey(key, util::MatrixExt<long long>(b0 - a0));
+		else
+		{
+			AppendToKey(key, a0);
+			AppendToKey(key, b0);
+		}
+		AppendToKey(key, P);
+		AppendToKey(key, p0);
+		AppendToKey(key, Q);
+		AppendToKey(key, q0);
+
+		bool has_dependence;
+		if (Replay(key, sink, has_dependence))
+			return has_dependence;
+
+		return RunAndStore(std::move(key), sink, [&](const DependenceSink& collecting_sink)
+		{
+			return dep::GeneralLinearDependenceTest(A, a0, B, b0, P, p0, Q, q0, collecting_sink, are_distinct, options, factorization);
+		});
+	}
+
+	bool DependenceCache::UniformLinearDependenceTest(
+		const util::MatrixExt<long long>& A,
+		const util::RowVector<long long>& a0,
+		const util::RowVector<long long>& b0,
+		const util::MatrixExt<long long>& P,
+		const util::RowVector<long long>& p0,
+		const util::RowVector<long long>& q0,
+		const DependenceSink& sink,
+		bool are_distinct,
+		const DependenceTestOptions& options,
+		const DependenceSystemFactorization* factorization)
+	{
+		if (options.query != nullptr)
+			return dep::UniformLinearDependenceTest(A, a0, b0, P, p0, q0, sink, are_distinct, options, factorization);
+
+		/**
+		 * ValidateArguments() requires that none of the vectors is empty, so p0 and q0 (and a0 and b0) can be safely replaced by their
+		 * difference only when they are non-empty and of equal size. Otherwise, the original vectors are used and the test will throw.
+		 */
+		Key key{ KIND_UNIFORM, are_distinct ? 1LL : 0LL };
+		AppendToKey(key, A);
+		if (a0.n_cols == b0.n_cols && a0.n_cols != 0)
+			AppendToKey(key, util::MatrixExt<long long>(a0 - b0));
+		else
+		{
+			AppendToKey(key, a0);
+			AppendToKey(key, b0);
+		}
+		AppendToKey(key, P);
+		if (p0.n_cols == q0.n_cols && p0.n_cols != 0)
+			AppendToKey(key, util::MatrixExt<long long>(q0 - p0));
+		else
+		{
+			AppendToKey(key, p0);
+			AppendToKey(key, q0);
+		}
+
+		bool has_dependence;
+		if (Replay(key, sink, has_dependence))
+			return has_dependence;
+
+		return RunAndStore(std::move(key), sink, [&](const DependenceSink& collecting_sink)
+		{
+			return dep::UniformLinearDependenceTest(A, a0, b0, P, p0, q0, collecting_sink, are_distinct, options, factorization);
+		});
+	}
+
+	DependenceCacheStatistics DependenceCache::GetStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		DependenceCacheStatistics stats;
+		stats.hits = m_hits;
+		stats.misses = m_misses;
+		stats.evictions = m_evictions;
+		stats.entries = m_entries.size();
+		stats.distances = m_size;
+		return stats;
+	}
+
+	void DependenceCache::Clear()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_entries.clear();
+		m_lru.clear();
+		m_size = 0;
+		m_hits = 0;
+		m_misses = 0;
+		m_evictions = 0;
+	}
+
+	std::size_t DependenceCache::KeyHash::operator()(const Key& key) const
+	{
+		/** FNV-1a over the 64-bit words of the key. */
+		unsigned long long hash(14695981039346656037ULL);
+		for (auto value : key)
+		{
+			hash ^= static_cast<unsigned long long>(value);
+			hash *= 1099511628211ULL;
+		}
+		return static_cast<std::size_t>(hash ^ (hash >> 32));
+	}
+
+	bool DependenceCache::Replay(const Key& key, const DependenceSink& sink, bool& has_dependence)
+	{
+		std::shared_ptr<const Result> result;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto entry = m_entries.find(key);
+			if (entry == m_entries.end())
+			{
+				++m_misses;
+				return false;
+			}
+
+			++m_hits;
+			m_lru.splice(m_lru.begin(), m_lru, entry->second.lru_pos);
+			result = entry->second.result;
+		}
+
+		/** Result is shared, so it stays valid even if the entry is evicted while the sink is running. */
+		util::RowVector<long long> d(result->depth);
+		for (std::size_t n = 0; n < result->directions.size(); ++n)
+		{
+			std::copy(result->distances.begin() + n * result->depth, result->distances.begin() + (n + 1) * result->depth, d.begin());
+			if (!sink(d, result->directions[n]))
+				break;
+		}
+
+		has_dependence = result->has_dependence;
+		return true;
+	}
+
+	template<typename RunTest>
+	bool DependenceCache::RunAndStore(Key&& key, const DependenceSink& sink, RunTest run_test)
+	{
+		std::shared_ptr<Result> result(std::make_shared<Result>());
+		result->depth = 0;
+
+		/** Distance vector prefixed by its dependence set identifies the distinct dependences. */
+		std::unordered_set<Key, KeyHash> seen;
+		Key dependence;
+		bool is_complete(true), fits(true);
+
+		result->has_dependence = run_test(DependenceSink([&](const util::RowVector<long long>& d, DependenceDirection direction)
+		{
+			if (fits)
+			{
+				dependence.assign(1, static_cast<long long>(direction));
+				dependence.insert(dependence.end(), d.begin(), d.end());
+				if (seen.insert(dependence).second)
+				{
+					result->depth = d.n_cols;
+					result->distances.insert(result->distances.end(), d.begin(), d.end());
+					result->directions.push_back(direction);
+
+					/** Results that can never be stored are not collected any further. */
+					fits = ResultSize(result->directions.size()) <= m_capacity;
+					if (!fits)
+					{
+						seen.clear();
+						result->distances.clear();
+						result->directions.clear();
+					}
+				}
+			}
+
+			is_complete = sink(d, direction);
+			return is_complete;
+		}));
+
+		const bool has_dependence(result->has_dependence);
+		if (is_complete && fits)
+			Store(std::move(key), std::move(result));
+		return has_dependence;
+	}
+
+	void DependenceCache::Store(Key&& key, std::shared_ptr<const Result>&& result)
+	{
+		const std::size_t size(ResultSize(result->directions.size()));
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto inserted = m_entries.emplace(std::move(key), Entry{ std::move(result), m_lru.end() });
+		if (!inserted.second)
+			return;
+
+		m_lru.push_front(&inserted.first->first);
+		inserted.first->second.lru_pos = m_lru.begin();
+		m_size += size;
+
+		/** The entry just stored is the most recently used one, so it is never evicted (size <= m_capacity). */
+		while (m_size > m_capacity)
+		{
+			auto victim = m_entries.find(*m_lru.back());
+			m_size -= ResultSize(victim->second.result->directions.size());
+			m_entries.erase(victim);
+			m_lru.pop_back();
+			++m_evictions;
+		}
+	}
+
+} /// namespace dep
+} /// namespace gap
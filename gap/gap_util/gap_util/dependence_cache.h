@@ -0,0 +1,176 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef GAP_DEPENDENCE_CACHE_H
+#define GAP_DEPENDENCE_CACHE_H
+
+#include "dependence_analyser.h"
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+
+namespace gap
+{
+namespace dep
+{
+
+/** Number of cache lookups that were answered from the cache (hits) or had to run the dependence test (misses). */
+struct DependenceCacheStatistics
+{
+	unsigned long long hits;
+	unsigned long long misses;
+	unsigned long long evictions;
+	std::size_t entries;
+	std::size_t distances;
+};
+
+/**
+ * Memoizing wrapper around GeneralLinearDependenceTest() and UniformLinearDependenceTest() declared in dependence_analyser.h (variants
+ * that hand the dependences to DependenceSink). Results are stored under the canonical key built from the inputs of the test, so that the
+ * same system of equations and inequalities reaching the analyser again (e.g. identical stencil subscripts in many loop nests) is answered
+ * without running the test.
+ *
+ * The key contains only the parts of the inputs the result actually depends on:
+ *
+ * 1) General test solves iA - jB = b0 - a0 subject to p0 <= IP, IQ <= q0. Vectors a0 and b0 are replaced by their difference b0 - a0, so
+ *    all pairs of variables translated by the same constant offset share one entry.
+ *
+ * 2) Uniform test solves kA = a0 - b0 subject to p0 - q0 <= kP <= q0 - p0. Besides a0 - b0, loop bounds p0 and q0 are replaced by their
+ *    difference q0 - p0, as the distance vectors don't depend on where the iteration space starts.
+ *
+ * Matrix dimensions, the kind of the test and are_distinct flag are part of the key as well. Keys are compared exactly, hash is only
+ * used to select the bucket. Options (the engine and removal of redundant inequalities) are not part of the key, as they don't change the
+ * result. Query-driven tests (DependenceTestOptions::query is set) stop before all dependences are found, so they bypass the cache.
+ *
+ * Only the reduced result is stored: distinct pairs of distance vector and dependence set, in the order in which they were first found.
+ * On a hit these are handed to the sink again, so the sink receives every distinct dependence of the test, but not the duplicates found by
+ * different loop index instances. The size of the cache is bounded by the capacity, the number of stored distance vectors (every entry
+ * counts as at least one). Once it is exceeded, least recently used entries are evicted. Results larger than the capacity are not stored,
+ * and neither are results of the tests whose sink has stopped the enumeration.
+ *
+ * The cache is guarded by a mutex and can be shared by multiple threads. The test itself and the sink are run outside of the lock, so two
+ * threads missing on the same key at the same time will both run it and the first result is kept.
+ */
+class DependenceCache
+{
+public:
+	/** Capacity used by the default constructor. */
+	static const std::size_t DEFAULT_CAPACITY = 1 << 16;
+
+	/** @throw std::logic_error if capacity is zero. */
+	explicit DependenceCache(std::size_t capacity = DEFAULT_CAPACITY);
+
+	DependenceCache(const DependenceCache&) = delete;
+	DependenceCache& operator=(const DependenceCache&) = delete;
+
+	/** Same as GeneralLinearDependenceTest(). */
+	bool GeneralLinearDependenceTest(
+		const util::MatrixExt<long long>& A,
+		const util::RowVector<long long>& a0,
+		const util::MatrixExt<long long>& B,
+		const util::RowVector<long long>& b0,
+		const util::MatrixExt<long long>& P,
+		const util::RowVector<long long>& p0,
+		const util::MatrixExt<long long>& Q,
+		const util::RowVector<long long>& q0,
+		const DependenceSink& sink,
+		bool are_distinct = true,
+		const DependenceTestOptions& options = DependenceTestOptions(),
+		const DependenceSystemFactorization* factorization = nullptr);
+
+	/** Same as UniformLinearDependenceTest(). */
+	bool UniformLinearDependenceTest(
+		const util::MatrixExt<long long>& A,
+		const util::RowVector<long long>& a0,
+		const util::RowVector<long long>& b0,
+		const util::MatrixExt<long long>& P,
+		const util::RowVector<long long>& p0,
+		const util::RowVector<long long>& q0,
+		const DependenceSink& sink,
+		bool are_distinct = true,
+		const DependenceTestOptions& options = DependenceTestOptions(),
+		const DependenceSystemFactorization* factorization = nullptr);
+
+	DependenceCacheStatistics GetStatistics() const;
+	void Clear();
+
+private:
+	typedef std::vector<long long> Key;
+
+	struct KeyHash
+	{
+		std::size_t operator()(const Key& key) const;
+	};
+
+	/** Distinct distance vectors (stored one after another) and their dependence sets, in the order in which they were found. */
+	struct Result
+	{
+		bool has_dependence;
+		arma::uword depth;
+		std::vector<long long> distances;
+		std::vector<DependenceDirection> directions;
+	};
+
+	struct Entry
+	{
+		std::shared_ptr<const Result> result;
+		std::list<const Key*>::iterator lru_pos;
+	};
+
+	/** Looks up the key and hands the stored dependences to the sink. Returns FALSE on a miss. */
+	bool Replay(const Key& key, const DependenceSink& sink, bool& has_dependence);
+
+	/** Runs the test (run_test is handed the sink) on a miss, forwarding the dependences to the sink and storing the reduced result. */
+	template<typename RunTest>
+	bool RunAndStore(Key&& key, const DependenceSink& sink, RunTest run_test);
+
+	void Store(Key&& key, std::shared_ptr<const Result>&& result);
+
+	std::size_t m_capacity;
+	std::size_t m_size;
+	std::unordered_map<Key, Entry, KeyHash> m_entries;
+	std::list<const Key*> m_lru;		/** Keys of m_entries, most recently used first. */
+	mutable std::mutex m_mutex;
+	unsigned long long m_hits;
+	unsigned long long m_misses;
+	unsigned long long m_evictions;
+};
+
+} /// namespace dep
+} /// namespace gap
+
+#endif /// GAP_DEPENDENCE_CACHE_H
@@ -79,9 +79,8 @@ namespace dep
 			if (i.n_cols != j.n_cols || i.n_cols == 0)
 				throw std::logic_error("c2cuda::DependenceInfo(): i.n_cols should be equal to j.n_cols and greater than 0");
 
-			d = std::move(util::RowVector<long long>::CompareLexicographically(i, j, lev) == util::RowVector<long long>::RightGreater ?
-				j - i : i - j);
-			sig = std::move(arma::sign(dynamic_cast<const arma::Mat<long long>&>(d)).eval());
+			d = util::RowVector<long long>::CompareLexicographically(i, j, lev) == util::RowVector<long long>::RightGreater ? j - i : i - j;
+			sig = arma::sign(static_cast<const arma::Mat<long long>&>(d));
 		}
 
 		DependenceInfo(
@@ -93,7 +92,7 @@ namespace dep
 			: i(_i)
 			, j(_j)
 			, lev(_lev)
-			, d(_d), sig(arma::sign(dynamic_cast<const arma::Mat<long long>&>(d)).eval())
+			, d(_d), sig(arma::sign(static_cast<const arma::Mat<long long>&>(d)))
 		{
 			if (i.n_cols != j.n_cols || i.n_cols == 0)
 				throw std::logic_error("c2cuda::DependenceInfo(): i.n_cols should be equal to j.n_cols and greater than 0");
@@ -108,11 +107,148 @@ namespace dep
 			, j(0)
 			, d(_d)
 			, lev(_lev)
-			, sig(arma::sign(dynamic_cast<const arma::Mat<long long>&>(d)).eval())
+			, sig(arma::sign(static_cast<const arma::Mat<long long>&>(d)))
 		{
 		}
 	};
 
+	/**
+	 * The DistanceLattice structure describes the set of uniform dependence distances k = j - i in closed form, so that the set can be
+	 * reasoned about without enumerating it. Every distance vector is of form:
+	 *
+	 * k = base + (t1, t2, ..., tr) * generators
+	 *
+	 * where base is (1 x m) vector, generators is (r x m) matrix whose rows are linearly independent and t = (t1, t2, ..., tr) is an
+	 * integer parameter vector that satisfies the system t * constraints <= constraints_rhs (the loop nest bounds expressed in terms of
+	 * the parameters). The struct has the following members:
+	 *
+	 * 1) RowVector base and MatrixExt generators as described above. When every component of k is determined, generators is (0 x m).
+	 * 2) MatrixExt constraints and RowVector constraints_rhs, the system of inequalities that the parameters have to satisfy.
+	 * 3) RowVectors param_lower and param_upper, the bounded integer range of each parameter tl.
+	 * 4) RowVectors dist_lower and dist_upper, the bounded integer range of each component (level) of the distance vector k.
+	 *
+	 * NOTE: the ranges in 3) and 4) are calculated from the REAL solution set of the parameter system and rounded inwards to the nearest
+	 * integers. They enclose every distance vector of the set, but not every vector within them has to be a distance vector. The set is
+	 * described exactly only by the base vector, generators and constraints. Both positive (T depends on S) and negative (S depends on T)
+	 * vectors k are part of the set - negative vector k corresponds to distance vector d = -1 * k of the dependence of S on T.
+	 */
+	struct DistanceLattice
+	{
+		/** Bit flags returned by Directions() method. */
+		enum Direction
+		{
+			Negative = 1,
+			Zero = 2,
+			Positive = 4
+		};
+
+		util::RowVector<long long> base;
+		util::MatrixExt<long long> generators;
+		util::MatrixExt<long long> constraints;
+		util::RowVector<long long> constraints_rhs;
+		util::RowVector<long long> param_lower;
+		util::RowVector<long long> param_upper;
+		util::RowVector<long long> dist_lower;
+		util::RowVector<long long> dist_upper;
+
+		DistanceLattice()
+
+			: base(0)
+			, generators(0, 0)
+			, constraints(0, 0)
+			, constraints_rhs(0)
+			, param_lower(0)
+			, param_upper(0)
+			, dist_lower(0)
+			, dist_upper(0)
+		{
+		}
+
+		/** Returns the combination of Direction flags that component lev (counting starts from 0) of distance vector k can have. */
+		unsigned Directions(arma::uword lev) const
+		{
+			unsigned directions(0);
+			if (dist_lower(lev) < 0)
+				directions |= Negative;
+			if (dist_lower(lev) <= 0 && dist_upper(lev) >= 0)
+				directions |= Zero;
+			if (dist_upper(lev) > 0)
+				directions |= Positive;
+			return directions;
+		}
+
+		/**
+		 * Returns TRUE if the set may contain lexicographically positive vector k whose first non-zero component is lev, or vector k = 0
+		 * when lev is equal to the number of components.
+		 */
+		bool MayHaveLevel(arma::uword lev) const
+		{
+			for (auto l = 0U; l < lev; ++l)
+				if (!(Directions(l) & Zero))
+					return false;
+			return lev == dist_lower.n_cols || (Directions(lev) & Positive) != 0;
+		}
+
+		/** Returns the lattice of vectors -k, which has the same parameters and constraints. */
+		DistanceLattice Negated() const
+		{
+			DistanceLattice negated(*this);
+			negated.base = -1LL * base;
+			negated.generators = -1LL * generators;
+			negated.dist_lower = -1LL * dist_upper;
+			negated.dist_upper = -1LL * dist_lower;
+			return negated;
+		}
+	};
+
+	/** Kind of the dependence, decided by which of the two statement instances writes the array element. */
+	enum DependenceKind
+	{
+		DEPENDENCE_FLOW = 0		/** Source writes, sink reads. */
+		, DEPENDENCE_ANTI		/** Source reads, sink writes. */
+		, DEPENDENCE_OUTPUT		/** Both source and sink write. */
+	};
+
+	/**
+	 * The DependenceClass structure describes a dependence between instances of statements First and Second found by the dependence
+	 * analysers. The struct has following members:
+	 *
+	 * 1) bool first_is_src, TRUE if instance of First executes before the instance of Second (First is the source of the dependence).
+	 * 2) DependenceKind kind of the dependence.
+	 * 3) uword level, the index of the outermost loop that carries the dependence (first non-zero component of the distance vector), or nest
+	 *    depth when the dependence is loop independent.
+	 */
+	struct DependenceClass
+	{
+		bool first_is_src;
+		DependenceKind kind;
+		arma::uword level;
+	};
+
+	/**
+	 * Classifies dependence with distance vector d (lexicographically non-negative). Loop carried dependence goes from the instance in the
+	 * earlier iteration, given by first_is_earlier_iter, while loop independent dependence (d = 0) goes from the statement that comes first
+	 * in the loop body, given by first_precedes_second. Kind of the dependence follows from whether the source and the sink write the element.
+	 */
+	inline DependenceClass ClassifyDependence(
+		const util::RowVector<long long>& d
+		, bool first_is_earlier_iter
+		, bool first_precedes_second
+		, bool first_writes
+		, bool second_writes)
+	{
+		DependenceClass dep_class;
+		dep_class.level = 0;
+		while (dep_class.level < d.n_cols && d(dep_class.level) == 0)
+			++dep_class.level;
+
+		dep_class.first_is_src = dep_class.level < d.n_cols ? first_is_earlier_iter : first_precedes_second;
+		const bool src_writes(dep_class.first_is_src ? first_writes : second_writes);
+		const bool sink_writes(dep_class.first_is_src ? second_writes : first_writes);
+		dep_class.kind = src_writes && sink_writes ? DEPENDENCE_OUTPUT : (src_writes ? DEPENDENCE_FLOW : DEPENDENCE_ANTI);
+		return dep_class;
+	}
+
 } /// namespace dep
 } /// namespace gap
 
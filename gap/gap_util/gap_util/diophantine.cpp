@@ -39,6 +39,54 @@ namespace gap
 namespace util
 {
 
+namespace
+{
+
+	/**
+	 * Solves the system tS = c where S is (m x n) echelon matrix of rank rank_s, storing the first rank_s (determined) components of t. The
+	 * remaining components are set to zero. Returns FALSE if the system has no integer solution. See SolveDiophantineSystem() for details.
+	 */
+	template<typename Matrix, typename Vector>
+	bool SolveEchelonSystem(const Matrix& S, const uword rank_s, const Vector& c, Vector& t)
+	{
+		/**
+		 * Check if solution exists by solving simplified system tS = c. First S.rank components of t are determined, while other can
+		 * be chosen arbitrarily (by the caller). As S is echelon matrix, it is easy to calculate t1 and then move to the right and
+		 * calculate other determined component using previously computed ones.
+		 */
+		t = Vector(S.n_rows);
+		uword t_component(0);
+
+		for (auto i = 0U; i < S.n_cols; ++i)
+		{
+			long long sum(0);
+			for (auto j = 0U; j < t_component; ++j)
+				sum += S(j,i) * t(j);
+
+			if (t_component >= rank_s || S(t_component,i) == 0)
+			{
+				/** One of the equations doesn't hold when components of t calculated previously are put into it. */
+				if (sum != c(i))
+					return false;
+
+				continue;
+			}
+
+			long long difference(c(i) - sum);
+			/** Current component of vector t has no integer solution. */
+			if (difference % S(t_component,i) != 0)
+				return false;
+
+			/** Current component of t has integer solution, compute it. */
+			t(t_component) = difference / S(t_component,i);
+			++t_component;
+		}
+
+		return true;
+	}
+
+} /// unnamed namespace
+
     bool SolveDiophantineEquation(const ColVector<long long>& A,
 		const long long c,
 		MatrixExt<long long>& U,
@@ -60,7 +108,8 @@ namespace util
         return true;
     }
 
-    bool SolveDiophantineSystem(const MatrixExt<long long>& A, const RowVector<long long>& c, MatrixExt<long long>& U, RowVector<long long>& t, uword& rank_s)
+    bool SolveDiophantineSystem(const MatrixExt<long long>& A, const RowVector<long long>& c, MatrixExt<long long>& U, RowVector<long long>& t, uword& rank_s,
+		EchelonAlgorithm algorithm)
     {
         if (A.n_rows == 0 || A.n_cols == 0)
             throw std::logic_error("SolveDiophantineSystem(): coefficient matrix A must have at least one row and one column");
@@ -70,43 +119,85 @@ namespace util
 
         /** Reduce coefficient matrix A to echelon form. */
         MatrixExt<long long> S(A.n_rows, A.n_cols);
-        rank_s = A.ReduceToEchelon(U, S);
-
-        /**
-         * Check if solution exists by solving simplified system tS = c. First S.rank components of t are determined, while other can
-         * be chosen arbitrarily (by the caller). As S is echelon matrix, it is easy to calculate t1 and then move to the right and
-         * calculate other determined component using previously computed ones.
-         */
-        t = RowVector<long long>(S.n_rows);
-        uword t_component(0);
-
-        for (auto i = 0U; i < S.n_cols; ++i)
-        {
-            long long sum(0);
-            for (auto j = 0U; j < t_component; ++j)
-                sum += S(j,i) * t(j);
-
-            if (t_component >= rank_s || S(t_component,i) == 0)
-            {
-                /** One of the equations doesn't hold when components of t calculated previously are put into it. */
-                if (sum != c(i))
-                    return false;
-
-                continue;
-            }
-
-            long long difference(c(i) - sum);
-            /** Current component of vector t has no integer solution. */
-            if (difference % S(t_component,i) != 0)
-                return false;
-
-            /** Current component of t has integer solution, compute it. */
-            t(t_component) = difference / S(t_component,i);
-            ++t_component;
-        }
+        rank_s = ReduceToEchelon(A, U, S, algorithm);
 
-        return true;
+        return SolveEchelonSystem(S, rank_s, c, t);
     }
 
+	bool SolveDiophantineSystem(const SmallMatrix<long long>& A, const SmallRowVector<long long>& c, SmallMatrix<long long>& U,
+		SmallRowVector<long long>& t, uword& rank_s)
+	{
+		if (A.n_rows == 0 || A.n_cols == 0)
+			throw std::logic_error("SolveDiophantineSystem(): coefficient matrix A must have at least one row and one column");
+
+		if (A.n_cols != c.n_cols)
+			throw std::logic_error("SolveDiophantineSystem(): number of cols of matrix A and vector c must be equal");
+
+		/** Reduce coefficient matrix A to echelon form. */
+		SmallMatrix<long long> S;
+		rank_s = A.ReduceToEchelon(U, S);
+
+		return SolveEchelonSystem(S, rank_s, c, t);
+	}
+
+	void FactorDiophantineSystem(const MatrixExt<long long>& A,
+		DiophantineFactorization<MatrixExt<long long>>& factorization,
+		EchelonAlgorithm algorithm)
+	{
+		if (A.n_rows == 0 || A.n_cols == 0)
+			throw std::logic_error("FactorDiophantineSystem(): coefficient matrix A must have at least one row and one column");
+
+		factorization.U.set_size(A.n_rows, A.n_rows);
+		factorization.S.set_size(A.n_rows, A.n_cols);
+		factorization.rank_s = ReduceToEchelon(A, factorization.U, factorization.S, algorithm);
+	}
+
+	void FactorDiophantineSystem(const SmallMatrix<long long>& A, DiophantineFactorization<SmallMatrix<long long>>& factorization)
+	{
+		if (A.n_rows == 0 || A.n_cols == 0)
+			throw std::logic_error("FactorDiophantineSystem(): coefficient matrix A must have at least one row and one column");
+
+		factorization.rank_s = A.ReduceToEchelon(factorization.U, factorization.S);
+	}
+
+	bool SolveFactoredDiophantineSystem(const DiophantineFactorization<MatrixExt<long long>>& factorization,
+		const RowVector<long long>& c,
+		RowVector<long long>& t)
+	{
+		if (factorization.S.n_cols != c.n_cols)
+			throw std::logic_error("SolveFactoredDiophantineSystem(): number of cols of matrix A and vector c must be equal");
+
+		return SolveEchelonSystem(factorization.S, factorization.rank_s, c, t);
+	}
+
+	bool SolveFactoredDiophantineSystem(const DiophantineFactorization<SmallMatrix<long long>>& factorization,
+		const SmallRowVector<long long>& c,
+		SmallRowVector<long long>& t)
+	{
+		if (factorization.S.n_cols != c.n_cols)
+			throw std::logic_error("SolveFactoredDiophantineSystem(): number of cols of matrix A and vector c must be equal");
+
+		return SolveEchelonSystem(factorization.S, factorization.rank_s, c, t);
+	}
+
+	std::size_t SolveFactoredDiophantineSystems(const DiophantineFactorization<MatrixExt<long long>>& factorization,
+		const std::vector<RowVector<long long>>& c,
+		std::vector<RowVector<long long>>& t,
+		std::vector<bool>& has_solution)
+	{
+		t.assign(c.size(), RowVector<long long>(factorization.S.n_rows));
+		has_solution.assign(c.size(), false);
+
+		std::size_t num_solved(0);
+		for (auto k = 0U; k < c.size(); ++k)
+		{
+			has_solution[k] = SolveFactoredDiophantineSystem(factorization, c[k], t[k]);
+			if (has_solution[k])
+				++num_solved;
+		}
+
+		return num_solved;
+	}
+
 } /// namespace util
 } /// namespace gap
@@ -36,6 +36,9 @@
 #define GAP_UTIL_DIOPHANTINE_H
 
 #include "row_vector.h"
+#include "small_matrix.h"
+#include "normal_form.h"
+#include <vector>
 
 namespace gap
 {
@@ -145,6 +148,9 @@ namespace util
 	 *
 	 * @retval Boolean value true for SUCCESS (solution was found), and false for FAILURE (there is no solution)
 	 *
+	 * Step 1 can be carried out by any echelon reduction (@see EchelonAlgorithm). ECHELON_HERMITE produces different, but equally valid,
+	 * U and t with smaller entries on larger systems.
+	 *
 	 * @throw std::logic_error if A.n_rows == 0 OR A.n_cols == 0 OR A.n_cols != c.n_cols
 	 * @see Loop Transformations for Restructuring Compilers, The Foundations (Theorem 3.6)
 	 */
@@ -152,8 +158,73 @@ namespace util
 		const RowVector<long long>& c,
 		MatrixExt<long long>& U,
 		RowVector<long long>& t,
+		uword& rank_s,
+		EchelonAlgorithm algorithm = ECHELON_EUCLID);
+
+	/**
+	 * Same as SolveDiophantineSystem() above, except that it works on matrices with inline storage, so that solving the system doesn't
+	 * allocate any memory. Caller has to make sure that the dimensions fit (@see SmallMatrix::Fits()).
+	 */
+	bool SolveDiophantineSystem(const SmallMatrix<long long>& A,
+		const SmallRowVector<long long>& c,
+		SmallMatrix<long long>& U,
+		SmallRowVector<long long>& t,
 		uword& rank_s);
 
+	/**
+	 * Echelon reduction UA = S of the coefficient matrix A of the system xA = c (step 1 of SolveDiophantineSystem()). It doesn't depend on
+	 * the right-hand side c, so it can be calculated once by FactorDiophantineSystem() and reused to solve the system for any number of
+	 * right-hand sides by SolveFactoredDiophantineSystem(). Matrix is either MatrixExt<long long> or SmallMatrix<long long>.
+	 */
+	template<typename Matrix>
+	struct DiophantineFactorization
+	{
+		DiophantineFactorization() : U(0, 0), S(0, 0), rank_s(0) {}
+
+		Matrix U;
+		Matrix S;
+		uword rank_s;
+	};
+
+	/**
+	 * Reduces coefficient matrix A to echelon form with the given algorithm and stores unimodular matrix U, echelon matrix S and its rank
+	 * into factorization.
+	 *
+	 * @throw std::logic_error if A.n_rows == 0 OR A.n_cols == 0
+	 */
+	void FactorDiophantineSystem(const MatrixExt<long long>& A,
+		DiophantineFactorization<MatrixExt<long long>>& factorization,
+		EchelonAlgorithm algorithm = ECHELON_EUCLID);
+
+	/** Same as above, for matrices with inline storage. Caller has to make sure that the dimensions fit (@see SmallMatrix::Fits()). */
+	void FactorDiophantineSystem(const SmallMatrix<long long>& A, DiophantineFactorization<SmallMatrix<long long>>& factorization);
+
+	/**
+	 * Same as SolveDiophantineSystem(), except that steps 2 and 3 are performed on the already calculated factorization of A. Matrix U and
+	 * rank_s are taken from the factorization, so vector t is the only output argument.
+	 *
+	 * @throw std::logic_error if factorization.S.n_cols != c.n_cols
+	 */
+	bool SolveFactoredDiophantineSystem(const DiophantineFactorization<MatrixExt<long long>>& factorization,
+		const RowVector<long long>& c,
+		RowVector<long long>& t);
+
+	/** Same as above, for matrices with inline storage. */
+	bool SolveFactoredDiophantineSystem(const DiophantineFactorization<SmallMatrix<long long>>& factorization,
+		const SmallRowVector<long long>& c,
+		SmallRowVector<long long>& t);
+
+	/**
+	 * Solves the system xA = c for every right-hand side of the batch c using single factorization of A. Vectors t and has_solution are
+	 * resized to c.size(); t[k] holds the determined components of the solution for c[k] when has_solution[k] is TRUE.
+	 *
+	 * @retval Number of right-hand sides for which the system has an integer solution.
+	 */
+	std::size_t SolveFactoredDiophantineSystems(const DiophantineFactorization<MatrixExt<long long>>& factorization,
+		const std::vector<RowVector<long long>>& c,
+		std::vector<RowVector<long long>>& t,
+		std::vector<bool>& has_solution);
+
 } /// namespace util
 } /// namespace gap
 
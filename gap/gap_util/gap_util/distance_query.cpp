@@ -0,0 +1,235 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "distance_query.h"
+#include "fourier_elimination.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace gap
+{
+namespace dep
+{
+
+namespace
+{
+	/** Rounds x / y towards +oo, y must be positive. */
+	long long CeilDiv(long long x, long long y)
+	{
+		long long q(x / y);
+		return (x % y != 0 && x > 0) ? q + 1 : q;
+	}
+
+} /// unnamed namespace
+
+	DistanceQuery::DistanceQuery(arma::uword nest_depth, unsigned queries)
+		: m_nest_depth(nest_depth)
+		, m_queries(queries)
+		, m_has_bounds(false)
+		, m_distances(nest_depth)
+		, m_added_cnt(0)
+		, m_added_since_check(0)
+		, m_checked_cnt(0)
+		, m_changed_since_check(false)
+		, m_multiplier_fixed(false)
+		, m_answered(false)
+	{
+		if (queries == 0)
+			throw std::logic_error("c2cuda::DistanceQuery::DistanceQuery(): queries must be non-zero");
+	}
+
+	void DistanceQuery::SetDistanceBounds(const util::RowVector<long long>& lower, const util::RowVector<long long>& upper)
+	{
+		if (lower.n_cols != m_nest_depth || upper.n_cols != m_nest_depth)
+			throw std::logic_error("c2cuda::DistanceQuery::SetDistanceBounds(): bounds must have nest depth elements");
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_lower.assign(lower.begin(), lower.end());
+		m_upper.assign(upper.begin(), upper.end());
+		m_has_bounds = true;
+		m_changed_since_check = true;
+	}
+
+	bool DistanceQuery::Add(const util::RowVector<long long>& d)
+	{
+		if (d.n_cols != m_nest_depth)
+			throw std::logic_error("c2cuda::DistanceQuery::Add(): distance must have nest depth elements");
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_added_cnt;
+		if (m_answered)
+			return false;
+
+		if (m_distances.Insert(d))
+			m_changed_since_check = true;
+
+		bool rank_answered(m_distances.Rank() == m_nest_depth);
+		if ((m_queries & QUERY_MULTIPLIER) != 0 && m_has_bounds && (rank_answered || (m_queries & QUERY_RANK) == 0))
+		{
+			/**
+			 * The check visits every stored distance, so it is repeated only after as many distances have been added as there were stored
+			 * distances at the previous check (the set at most doubles in between).
+			 */
+			++m_added_since_check;
+			if (m_changed_since_check && m_added_since_check >= m_checked_cnt)
+			{
+				m_multiplier_fixed = IsMultiplierFixed();
+				m_checked_cnt = m_distances.Size();
+				m_added_since_check = 0;
+				m_changed_since_check = false;
+			}
+		}
+
+		m_answered = ((m_queries & QUERY_RANK) == 0 || rank_answered) && ((m_queries & QUERY_MULTIPLIER) == 0 || m_multiplier_fixed);
+		return !m_answered;
+	}
+
+	bool DistanceQuery::IsAnswered() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_answered;
+	}
+
+	arma::uword DistanceQuery::GetRank() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_distances.Rank();
+	}
+
+	std::vector<util::RowVector<long long>> DistanceQuery::GetDistances() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_distances.ToVectors();
+	}
+
+	unsigned long long DistanceQuery::GetAddedCnt() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_added_cnt;
+	}
+
+	bool DistanceQuery::IsMultiplierFixed() const
+	{
+		/** Calculate u from the innermost level outwards, in the same way as the hyperplane method does. */
+		std::vector<long long> u(m_nest_depth, 0);
+		for (auto i = m_nest_depth; i-- > 0;)
+		{
+			if (m_distances.NumDistances(i) == 0)
+			{
+				/** ui stays 0 only if no distance of level i is possible. */
+				if (m_upper[i] >= 1)
+					return false;
+				continue;
+			}
+
+			long long bound(1);
+			for (auto k = 0U; k < m_distances.NumDistances(i); ++k)
+			{
+				const long long* d(m_distances.Distance(i, k));
+				long long numerator(1);
+				for (auto j = i + 1; j < m_nest_depth; ++j)
+					numerator -= d[j] * u[j];
+				bound = std::max(bound, CeilDiv(numerator, d[i]));
+			}
+			u[i] = bound;
+
+			/** Highest bound any distance of level i within the bounds can produce. */
+			long long numerator(1);
+			for (auto j = i + 1; j < m_nest_depth; ++j)
+				numerator -= m_lower[j] * u[j];
+			long long highest(numerator > 0 ? numerator : CeilDiv(numerator, std::max(m_upper[i], 1LL)));
+			if (highest > u[i])
+				return false;
+		}
+		return true;
+	}
+
+	bool FindDistanceBounds(
+		const util::MatrixExt<long long>& P,
+		const util::RowVector<long long>& p0,
+		const util::MatrixExt<long long>& Q,
+		const util::RowVector<long long>& q0,
+		util::RowVector<long long>& lower,
+		util::RowVector<long long>& upper)
+	{
+		const arma::uword m(P.n_rows);
+		if (P.n_cols != m || Q.n_rows != m || Q.n_cols != m || p0.n_cols != m || q0.n_cols != m || m == 0)
+			throw std::logic_error("c2cuda::FindDistanceBounds(): loop bounds are not consistent");
+
+		util::FourierEliminationOptions options;
+		options.arithmetic = util::FOURIER_INTEGER;
+
+		util::RowVector<long long> distance_lower(m), distance_upper(m);
+		const util::RowVector<long long> no_variables(0);
+		for (auto k = 0U; k < m; ++k)
+		{
+			/** System -IP <= -p0, IQ <= q0 with Ik moved to the first row, so that its bounds are constants. */
+			util::MatrixExt<long long> A(m, 2 * m);
+			util::RowVector<long long> c(2 * m);
+			for (auto row = 0U; row < m; ++row)
+			{
+				const arma::uword index(row == 0 ? k : (row <= k ? row - 1 : row));
+				for (auto col = 0U; col < m; ++col)
+				{
+					A(row, col) = -P(index, col);
+					A(row, m + col) = Q(index, col);
+				}
+			}
+			for (auto col = 0U; col < m; ++col)
+			{
+				c(col) = -p0(col);
+				c(m + col) = q0(col);
+			}
+
+			util::BoundSet index_lower, index_upper;
+			if (!util::PerformFourierElimination(A, c, index_lower, index_upper, options) || !index_lower.IsBounded(0) ||
+				!index_upper.IsBounded(0))
+				return false;
+
+			const long long min_k(index_lower.CeilMax(0, no_variables)), max_k(index_upper.FloorMin(0, no_variables));
+			if (min_k > max_k)
+				return false;
+
+			distance_lower(k) = min_k - max_k;
+			distance_upper(k) = max_k - min_k;
+		}
+
+		lower = distance_lower;
+		upper = distance_upper;
+		return true;
+	}
+
+} /// namespace dep
+} /// namespace gap
@@ -0,0 +1,145 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef GAP_DISTANCE_QUERY_H
+#define GAP_DISTANCE_QUERY_H
+
+#include "row_vector.h"
+#include "matrix_ext.h"
+#include "distance_set.h"
+#include <vector>
+#include <mutex>
+
+namespace gap
+{
+namespace dep
+{
+
+/** Questions about the set of dependence distance vectors of a loop nest that DistanceQuery answers. Kinds can be combined with |. */
+enum DistanceQueryKind
+{
+	QUERY_RANK = 1				/** Rank of the distance matrix (FindOuterLoopTransformMatrix() in gap_transform). */
+	, QUERY_MULTIPLIER = 2		/** Vector u such that d * u >= 1 for every distance d > 0 (hyperplane method in gap_transform). */
+};
+
+/**
+ * Collects dependence distance vectors of a loop nest on behalf of the loop transformations, which don't need every distance vector but
+ * only the answers to a few questions about the set (@see DistanceQueryKind). The query is handed to the dependence analysers through
+ * DependenceTestOptions::query. The analysers pass every distance to Add() instead of storing it, and stop enumerating the dependences as
+ * soon as Add() reports that every registered query is answered, i.e. that no further distance can change the answers:
+ *
+ * 1) QUERY_RANK is answered once the distances span the whole space (rank is equal to the nest depth).
+ *
+ * 2) QUERY_MULTIPLIER is answered once no distance within the bounds set by SetDistanceBounds() can raise vector u. Vector u is calculated
+ *    from the innermost level outwards, and component ui is the maximum of 1 and of the lower bounds (1 - di+1 * ui+1 - ... - dm * um) / di
+ *    over the distances d of level i. Since every uj >= 0, the highest bound any distance of level i can produce is reached at the lower
+ *    bounds of dj (j > i), with di = 1 when the numerator is positive and with di at its upper bound otherwise. Once every ui is equal
+ *    to that highest bound (and no distance can fall into a level that is empty so far), u is fixed. Without bounds, the query is never
+ *    answered before all distances have been added.
+ *
+ * Distances are kept in util::DistanceSet, which drops duplicates and distances that can't affect either of the answers, so GetDistances()
+ * gives the same answers as the complete set. The check of QUERY_MULTIPLIER visits all stored distances, so it is repeated only after as
+ * many distances have been added as there were stored distances at the previous check, which keeps the cost of Add() constant on average.
+ *
+ * Add() is guarded by a mutex, so the query can be shared by the analysers testing different pairs of variables concurrently.
+ */
+class DistanceQuery
+{
+public:
+	/** Queries is a combination of DistanceQueryKind values. @throw std::logic_error if nest_depth or queries is zero. */
+	DistanceQuery(arma::uword nest_depth, unsigned queries);
+
+	DistanceQuery(const DistanceQuery&) = delete;
+	DistanceQuery& operator=(const DistanceQuery&) = delete;
+
+	/** Sets bounds lower <= d <= upper that hold for every distance vector d of the nest (@see FindDistanceBounds()). */
+	void SetDistanceBounds(const util::RowVector<long long>& lower, const util::RowVector<long long>& upper);
+
+	/**
+	 * Adds lexicographically non-negative distance vector d. Returns FALSE once every registered query is answered, in which case the
+	 * caller should stop enumerating distances.
+	 *
+	 * @throw std::logic_error if d doesn't have nest depth elements, std::overflow_error if the echelon basis overflows.
+	 */
+	bool Add(const util::RowVector<long long>& d);
+
+	/** TRUE once every registered query is answered. */
+	bool IsAnswered() const;
+
+	/** Rank of the distances added so far. */
+	arma::uword GetRank() const;
+
+	/** Distances stored so far (@see util::DistanceSet::ToVectors()). */
+	std::vector<util::RowVector<long long>> GetDistances() const;
+
+	/** Number of calls to Add() (including duplicates and the ones made after the queries were answered). */
+	unsigned long long GetAddedCnt() const;
+
+private:
+	bool IsMultiplierFixed() const;
+
+	arma::uword m_nest_depth;
+	unsigned m_queries;
+	bool m_has_bounds;
+	std::vector<long long> m_lower;
+	std::vector<long long> m_upper;
+	util::DistanceSet m_distances;
+
+	unsigned long long m_added_cnt;
+	unsigned long long m_added_since_check;
+	std::size_t m_checked_cnt;
+	bool m_changed_since_check;
+	bool m_multiplier_fixed;
+	bool m_answered;
+	mutable std::mutex m_mutex;
+};
+
+/**
+ * Calculates bounds lower <= d <= upper of the distance vectors d = j - i of the loop nest with bounds p0 <= IP, IQ <= q0, from the integer
+ * range [min_k, max_k] of each loop index Ik over the REAL solutions of the bounds (dk is within [min_k - max_k, max_k - min_k]). Returns
+ * FALSE if the nest is empty or if the range of some index is not bounded, in which case lower and upper are not modified.
+ */
+bool FindDistanceBounds(
+	const util::MatrixExt<long long>& P,
+	const util::RowVector<long long>& p0,
+	const util::MatrixExt<long long>& Q,
+	const util::RowVector<long long>& q0,
+	util::RowVector<long long>& lower,
+	util::RowVector<long long>& upper);
+
+} /// namespace dep
+} /// namespace gap
+
+#endif /// GAP_DISTANCE_QUERY_H
@@ -0,0 +1,302 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "distance_set.h"
+#include "checked_arithmetic.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace gap
+{
+namespace util
+{
+
+namespace
+{
+	/** Calculates x = x_scale * x - y_scale * y, checked for overflow. */
+	void CheckedSubtract(long long x_scale, std::vector<long long>& x, long long y_scale, const std::vector<long long>& y)
+	{
+		for (auto k = 0U; k < x.size(); ++k)
+		{
+			long long x_k, y_k;
+			if (MulOverflow(x[k], x_scale, x_k) || MulOverflow(y[k], y_scale, y_k) || SubOverflow(x_k, y_k, x[k]))
+				throw std::overflow_error("c2cuda::DistanceSet::Insert(): echelon basis doesn't fit into long long");
+		}
+	}
+
+	/** Divides all elements of x by their GCD. */
+	void RemoveContent(std::vector<long long>& x)
+	{
+		unsigned long long g(0);
+		for (auto value : x)
+			g = BinaryGcd(static_cast<long long>(g), value);
+
+		if (g > 1)
+			for (auto& value : x)
+				value /= static_cast<long long>(g);
+	}
+
+	/** Returns TRUE if ej <= dj for every j > level. */
+	bool Dominates(const long long* e, const long long* d, uword level, uword nest_depth)
+	{
+		for (auto j = level + 1; j < nest_depth; ++j)
+			if (e[j] > d[j])
+				return false;
+		return true;
+	}
+
+} /// unnamed namespace
+
+	DistanceSet::DistanceSet(uword nest_depth, bool drop_dominated)
+		: m_nest_depth(nest_depth)
+		, m_drop_dominated(drop_dominated)
+		, m_levels(nest_depth)
+		, m_has_zero(false)
+	{
+		if (nest_depth == 0)
+			throw std::logic_error("c2cuda::DistanceSet::DistanceSet(): nest depth must be non-zero");
+	}
+
+	bool DistanceSet::Insert(const RowVector<long long>& d)
+	{
+		if (d.n_cols != m_nest_depth)
+			throw std::logic_error("c2cuda::DistanceSet::Insert(): distance must have nest depth elements");
+		return Insert(d.memptr());
+	}
+
+	void DistanceSet::Merge(const DistanceSet& other)
+	{
+		if (other.m_nest_depth != m_nest_depth)
+			throw std::logic_error("c2cuda::DistanceSet::Merge(): sets must have the same nest depth");
+
+		m_has_zero = m_has_zero || other.m_has_zero;
+		for (const auto& level : other.m_levels)
+			for (auto slot : level)
+				Insert(&other.m_data[slot * m_nest_depth]);
+	}
+
+	uword DistanceSet::NestDepth() const
+	{
+		return m_nest_depth;
+	}
+
+	bool DistanceSet::DropsDominated() const
+	{
+		return m_drop_dominated;
+	}
+
+	std::size_t DistanceSet::Size() const
+	{
+		return m_index.size();
+	}
+
+	bool DistanceSet::HasZero() const
+	{
+		return m_has_zero;
+	}
+
+	uword DistanceSet::Rank() const
+	{
+		return static_cast<uword>(m_basis.size());
+	}
+
+	std::size_t DistanceSet::NumDistances(uword level) const
+	{
+		return m_levels[level].size();
+	}
+
+	const long long* DistanceSet::Distance(uword level, std::size_t k) const
+	{
+		return &m_data[m_levels[level][k] * m_nest_depth];
+	}
+
+	std::vector<RowVector<long long>> DistanceSet::ToVectors() const
+	{
+		std::vector<std::vector<long long>> sorted;
+		sorted.reserve(Size() + (m_has_zero ? 1 : 0));
+		if (m_has_zero)
+			sorted.push_back(std::vector<long long>(m_nest_depth, 0));
+		for (auto level = 0U; level < m_nest_depth; ++level)
+			for (auto k = 0U; k < NumDistances(level); ++k)
+				sorted.push_back(std::vector<long long>(Distance(level, k), Distance(level, k) + m_nest_depth));
+		std::sort(sorted.begin(), sorted.end());
+
+		std::vector<RowVector<long long>> distances;
+		distances.reserve(sorted.size());
+		for (const auto& d : sorted)
+			distances.push_back(RowVector<long long>(d));
+		return distances;
+	}
+
+	bool DistanceSet::Insert(const long long* d)
+	{
+		const uword level(static_cast<uword>(std::find_if(d, d + m_nest_depth, [](long long value) { return value != 0; }) - d));
+		if (level == m_nest_depth)
+		{
+			bool changed(!m_has_zero);
+			m_has_zero = true;
+			return changed;
+		}
+		if (d[level] < 0)
+			throw std::logic_error("c2cuda::DistanceSet::Insert(): distance must be lexicographically non-negative");
+
+		const std::size_t hash(Hash(d));
+		if (Contains(d, hash))
+			return false;
+
+		/** Distance that raises the rank is stored even if it is dominated, otherwise dominated distance changes nothing. */
+		const bool in_basis(m_basis.size() < m_nest_depth && AddToBasis(d));
+		auto& slots = m_levels[level];
+		if (m_drop_dominated)
+		{
+			if (!in_basis)
+			{
+				for (auto slot : slots)
+				{
+					const long long* e(&m_data[slot * m_nest_depth]);
+					if (e[level] == d[level] && Dominates(e, d, level, m_nest_depth))
+						return false;
+				}
+			}
+
+			for (std::size_t position = 0; position < slots.size();)
+			{
+				const std::size_t slot(slots[position]);
+				const long long* e(&m_data[slot * m_nest_depth]);
+				if (!m_in_basis[slot] && e[level] == d[level] && Dominates(d, e, level, m_nest_depth))
+					Remove(level, position);
+				else
+					++position;
+			}
+		}
+
+		std::size_t slot;
+		if (!m_free_slots.empty())
+		{
+			slot = m_free_slots.back();
+			m_free_slots.pop_back();
+			std::copy(d, d + m_nest_depth, m_data.begin() + slot * m_nest_depth);
+			m_in_basis[slot] = in_basis;
+		}
+		else
+		{
+			slot = m_in_basis.size();
+			m_data.insert(m_data.end(), d, d + m_nest_depth);
+			m_in_basis.push_back(in_basis);
+		}
+
+		slots.push_back(slot);
+		m_index.emplace(hash, slot);
+		return true;
+	}
+
+	bool DistanceSet::Contains(const long long* d, std::size_t hash) const
+	{
+		auto range = m_index.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it)
+			if (std::equal(d, d + m_nest_depth, m_data.begin() + it->second * m_nest_depth))
+				return true;
+		return false;
+	}
+
+	bool DistanceSet::AddToBasis(const long long* distance)
+	{
+		std::vector<long long> d(distance, distance + m_nest_depth);
+
+		/** Eliminate pivot columns of the basis from d. Rows have zeros before their pivot, so earlier pivots stay eliminated. */
+		auto row = m_basis.begin();
+		for (; row != m_basis.end(); ++row)
+		{
+			auto pivot = std::find_if(row->begin(), row->end(), [](long long value) { return value != 0; }) - row->begin();
+			auto lead = std::find_if(d.begin(), d.end(), [](long long value) { return value != 0; }) - d.begin();
+			if (lead == static_cast<std::ptrdiff_t>(d.size()))
+				return false; /** d is linearly dependent on the basis. */
+
+			if (lead < pivot)
+				break;
+
+			if (d[pivot] != 0)
+			{
+				long long g(static_cast<long long>(BinaryGcd(d[pivot], (*row)[pivot])));
+				CheckedSubtract((*row)[pivot] / g, d, d[pivot] / g, *row);
+				RemoveContent(d);
+			}
+		}
+
+		auto lead = std::find_if(d.begin(), d.end(), [](long long value) { return value != 0; });
+		if (lead == d.end())
+			return false;
+
+		/** d has a new pivot column, insert it in front of the rows with greater pivots. */
+		if (*lead < 0)
+			std::transform(d.begin(), d.end(), d.begin(), [](long long value) { return -value; });
+		m_basis.insert(row, std::move(d));
+		return true;
+	}
+
+	void DistanceSet::Remove(uword level, std::size_t position)
+	{
+		auto& slots = m_levels[level];
+		const std::size_t slot(slots[position]);
+
+		auto range = m_index.equal_range(Hash(&m_data[slot * m_nest_depth]));
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (it->second == slot)
+			{
+				m_index.erase(it);
+				break;
+			}
+		}
+
+		slots[position] = slots.back();
+		slots.pop_back();
+		m_free_slots.push_back(slot);
+	}
+
+	std::size_t DistanceSet::Hash(const long long* d) const
+	{
+		/** FNV-1a over the elements of the distance. */
+		unsigned long long hash(14695981039346656037ULL);
+		for (auto k = 0U; k < m_nest_depth; ++k)
+		{
+			hash ^= static_cast<unsigned long long>(d[k]);
+			hash *= 1099511628211ULL;
+		}
+		return static_cast<std::size_t>(hash ^ (hash >> 32));
+	}
+
+} /// namespace util
+} /// namespace gap
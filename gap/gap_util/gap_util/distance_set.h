@@ -0,0 +1,129 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef GAP_UTIL_DISTANCE_SET_H
+#define GAP_UTIL_DISTANCE_SET_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include "row_vector.h"
+
+namespace gap
+{
+namespace util
+{
+
+	/**
+	 * @brief Set of dependence distance vectors of an m-deep loop nest that keeps only the vectors the loop transformations depend on. The
+	 * transformations use the distances in two ways: the rank of the distance matrix (and the space it spans), and the hyperplane multiplier u,
+	 * which is calculated level by level from the maximum of (1 - di+1 * ui+1 - ... - dm * um) / di over the distances d of level i, where
+	 * every uj >= 0. The set is therefore reduced on insert:
+	 *
+	 * 1) Duplicates are found by hash and stored only once. Zero distance (a dependence that is not loop carried) only sets a flag.
+	 * 2) Distances are partitioned by level, the index of the first non-zero element (as CalcDistanceMultiplierVec() in gap_transform does).
+	 * 3) Distance d of level i is dominated by stored distance e of the same level if ei = di and ej <= dj for every j > i, as e yields at
+	 *    least the same bound for any u. Dominated distances are not stored, and storing d removes the distances it dominates.
+	 * 4) Distances that increase the rank when they are inserted are always stored (and never removed), which keeps the spanned space.
+	 *
+	 * Distances are stored contiguously, m elements each, and slots of removed distances are reused, so memory scales with the number of
+	 * distinct distances that can matter rather than with the number of dependences.
+	 *
+	 * Steps 3 and 4 are specific to the unimodular transformations. When the set is created with drop_dominated set to FALSE, only step 1
+	 * is applied and every distinct distance is kept, which is what consumers other than these transformations need.
+	 */
+	class DistanceSet
+	{
+	public:
+		/** @throw std::logic_error if nest_depth is zero. */
+		explicit DistanceSet(uword nest_depth, bool drop_dominated = true);
+
+		/**
+		 * Inserts lexicographically non-negative distance d. Returns TRUE if the set has changed, FALSE if d is a duplicate or dominated
+		 * (the latter only when dominated distances are dropped).
+		 *
+		 * @throw std::logic_error if d doesn't have nest depth elements or it is lexicographically negative. std::overflow_error is thrown if
+		 * the echelon basis used to track the rank doesn't fit into long long.
+		 */
+		bool Insert(const RowVector<long long>& d);
+
+		/** Inserts every distance stored in other, which must have the same nest depth. Distances are reduced as configured for this set. */
+		void Merge(const DistanceSet& other);
+
+		uword NestDepth() const;
+		bool DropsDominated() const;
+
+		/** Number of stored non-zero distances. */
+		std::size_t Size() const;
+		bool HasZero() const;
+
+		/** Rank of all distances inserted so far. */
+		uword Rank() const;
+
+		/** Number of stored distances of the level, and the elements of distance k of the level (in no particular order). */
+		std::size_t NumDistances(uword level) const;
+		const long long* Distance(uword level, std::size_t k) const;
+
+		/** Stored distances (zero distance included) sorted lexicographically, so the result doesn't depend on the order of insertion. */
+		std::vector<RowVector<long long>> ToVectors() const;
+
+	private:
+		bool Insert(const long long* d);
+		bool Contains(const long long* d, std::size_t hash) const;
+		bool AddToBasis(const long long* d);
+		void Remove(uword level, std::size_t position);
+		std::size_t Hash(const long long* d) const;
+
+		uword m_nest_depth;
+		bool m_drop_dominated;
+
+		/** Slot s holds the distance in elements [s * m, (s + 1) * m). Slots of removed distances are listed in m_free_slots. */
+		std::vector<long long> m_data;
+		std::vector<bool> m_in_basis;
+		std::vector<std::size_t> m_free_slots;
+
+		/** Slots of the stored distances of every level, and the slots by the hash of their distance. */
+		std::vector<std::vector<std::size_t>> m_levels;
+		std::unordered_multimap<std::size_t, std::size_t> m_index;
+
+		/** Echelon basis of the inserted distances, rows are sorted by their pivot (leading) column and have positive pivot elements. */
+		std::vector<std::vector<long long>> m_basis;
+		bool m_has_zero;
+	};
+
+} /// namespace util
+} /// namespace gap
+
+#endif /// GAP_UTIL_DISTANCE_SET_H
@@ -34,24 +34,642 @@
 
 #include "fourier_elimination.h"
 #include "util.h"
+#include "thread_pool.h"
 #include <limits>
 #include <stdexcept>
 #include <algorithm>
+#include <iterator>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <type_traits>
 
 namespace gap
 {
 namespace util
 {
 
+	namespace
+	{
+
+		/** PerformFourierElimination() counters (@see FourierEliminationStatistics). */
+		std::atomic<unsigned long long> peak_inequalities(0);
+		std::atomic<unsigned long long> generated_inequalities(0);
+		std::atomic<unsigned long long> pruned_inequalities(0);
+
+		void UpdatePeakInequalities(unsigned long long count)
+		{
+			unsigned long long peak(peak_inequalities.load());
+			while (count > peak && !peak_inequalities.compare_exchange_weak(peak, count))
+			{
+			}
+		}
+
+		/** Single inequality coeffs * x <= rhs (or coeffs * x < rhs when strict is TRUE) used by HasRealSolution(). */
+		struct Inequality
+		{
+			std::vector<Rational<long long>> coeffs;
+			Rational<long long> rhs;
+			bool strict;
+		};
+
+		/**
+		 * Checks if the system of (possibly strict) inequalities has a REAL solution by eliminating variables one by one, the same way
+		 * PerformFourierElimination() does. Combination of two inequalities is strict if at least one of them is strict. Bounds are not
+		 * needed, so only the remaining inequalities are kept.
+		 */
+		bool HasRealSolution(std::vector<Inequality> system, uword num_variables)
+		{
+			std::vector<Inequality> upper, lower, next;
+			for (auto var = num_variables; var-- > 0;)
+			{
+				upper.clear();
+				lower.clear();
+				next.clear();
+
+				for (auto & ineq : system)
+				{
+					if (Sign(ineq.coeffs[var]) > 0)
+						upper.push_back(std::move(ineq));
+					else if (Sign(ineq.coeffs[var]) < 0)
+						lower.push_back(std::move(ineq));
+					else
+					{
+						ineq.coeffs.resize(var);
+						next.push_back(std::move(ineq));
+					}
+				}
+
+				/** Dividing upper bound by its (positive) coefficient and lower bound by the absolute value of its coefficient eliminates xr. */
+				for (const auto & up : upper)
+				{
+					for (const auto & low : lower)
+					{
+						Rational<long long> up_coeff(up.coeffs[var]), low_coeff(-1LL * low.coeffs[var]);
+
+						Inequality combined;
+						combined.coeffs.resize(var);
+						for (auto k = 0U; k < var; ++k)
+							combined.coeffs[k] = up.coeffs[k] / up_coeff + low.coeffs[k] / low_coeff;
+						combined.rhs = up.rhs / up_coeff + low.rhs / low_coeff;
+						combined.strict = up.strict || low.strict;
+						next.push_back(std::move(combined));
+					}
+				}
+
+				system.swap(next);
+			}
+
+			/** Only inequalities without variables (0 <= rhs or 0 < rhs) are left. */
+			return std::all_of(system.begin(), system.end(), [](const Inequality& ineq)
+			{
+				return ineq.strict ? Sign(ineq.rhs) > 0 : Sign(ineq.rhs) >= 0;
+			});
+		}
+
+		/**
+		 * Checks if inequality j of the system formed by columns kept of matrix T and elements of vector q is implied by the rest of the
+		 * system, that is, if the rest of the system together with T(:,j) * x > q(j) has no REAL solution.
+		 */
+		template<typename Element>
+		bool IsImpliedInequality(const MatrixExt<Element>& T,
+			const RowVector<Element>& q,
+			const std::vector<uword>& kept,
+			uword j,
+			uword num_variables)
+		{
+			std::vector<Inequality> system;
+			system.reserve(kept.size());
+			for (auto col : kept)
+			{
+				Inequality ineq;
+				ineq.coeffs.assign(T.begin_col(col), T.begin_col(col) + num_variables);
+				ineq.rhs = Rational<long long>(q(col));
+				ineq.strict = false;
+				if (col == j)
+				{
+					/** Negated inequality: -T(:,j) * x < -q(j). */
+					for (auto & coeff : ineq.coeffs)
+						coeff = -1LL * coeff;
+					ineq.rhs = -1LL * ineq.rhs;
+					ineq.strict = true;
+				}
+				system.push_back(std::move(ineq));
+			}
+
+			return !HasRealSolution(std::move(system), num_variables);
+		}
+
+		/** Returns -1, 0 or 1 depending on the sign of the coefficient of the rational or the integer system. */
+		inline int CoefficientSign(const Rational<long long>& value)
+		{
+			return Sign(value);
+		}
+
+		template<typename Integer>
+		inline int CoefficientSign(Integer value)
+		{
+			return (value > Integer(0)) - (value < Integer(0));
+		}
+
+		/** Returns -x. @throw std::overflow_error if the result doesn't fit into Integer. */
+		template<typename Integer>
+		Integer CheckedNegate(Integer x)
+		{
+			Integer result;
+			if (SubOverflow(Integer(0), x, result))
+				throw std::overflow_error("c2cuda::PerformIntegerFourierElimination(): integer overflow during elimination");
+			return result;
+		}
+
+		/** Returns a * x + b * y. @throw std::overflow_error if the result doesn't fit into Integer. */
+		template<typename Integer>
+		Integer CheckedCombination(Integer a, Integer x, Integer b, Integer y)
+		{
+			Integer ax, by, sum;
+			if (MulOverflow(a, x, ax) || MulOverflow(b, y, by) || AddOverflow(ax, by, sum))
+				throw std::overflow_error("c2cuda::PerformIntegerFourierElimination(): integer overflow during elimination");
+			return sum;
+		}
+
+		/**
+		 * Divides inequality j of the integer system (first num_variables rows of column j of T and element j of q) by the GCD of its
+		 * coefficients and the right-hand side, which doesn't change its REAL solutions. Returns the GCD of the coefficients that are
+		 * left (zero if all of them are zero).
+		 */
+		template<typename Integer>
+		Integer ReduceInequality(MatrixExt<Integer>& T, RowVector<Integer>& q, uword num_variables, uword j)
+		{
+			typedef typename std::make_unsigned<Integer>::type Unsigned;
+
+			Unsigned coeffs_gcd(0);
+			for (auto it = T.begin_col(j); it != T.begin_col(j) + num_variables && coeffs_gcd != 1; ++it)
+				coeffs_gcd = BinaryGcd(static_cast<Integer>(coeffs_gcd), *it);
+
+			/** GCD of the coefficients doesn't fit into Integer only when it is the magnitude of the most negative value. */
+			const Unsigned max_gcd(static_cast<Unsigned>(std::numeric_limits<Integer>::max()));
+			const Unsigned gcd_val(coeffs_gcd > max_gcd ? coeffs_gcd : BinaryGcd(static_cast<Integer>(coeffs_gcd), q(j)));
+			if (gcd_val > 1 && gcd_val <= max_gcd)
+			{
+				const Integer divisor(static_cast<Integer>(gcd_val));
+				for (auto it = T.begin_col(j); it != T.begin_col(j) + num_variables; ++it)
+					*it /= divisor;
+				q(j) /= divisor;
+				coeffs_gcd /= gcd_val;
+			}
+
+			if (coeffs_gcd > max_gcd)
+				throw std::overflow_error("c2cuda::PerformIntegerFourierElimination(): integer overflow during elimination");
+			return static_cast<Integer>(coeffs_gcd);
+		}
+
+		/**
+		 * Prepares inequality j (whose first non-zero coefficient is passed in) for finding the duplicates and returns its direction scale:
+		 * two inequalities have the same direction (their coefficients are positive multiples of each other) exactly when coefficients
+		 * divided by their direction scales are equal. The rational inequality is divided by the magnitude of its first non-zero coefficient,
+		 * so its direction scale is 1. The integer inequality is reduced by ReduceInequality() and its direction scale is the GCD of its
+		 * coefficients.
+		 */
+		inline Rational<long long> NormalizeInequality(MatrixExt<Rational<long long>>& T,
+			RowVector<Rational<long long>>& q,
+			uword num_variables,
+			uword j,
+			const Rational<long long>& first_nonzero)
+		{
+			Rational<long long> scale(std::abs(first_nonzero));
+			if (scale != 1LL)
+			{
+				q(j) /= scale;
+				T(span(0, num_variables - 1), j) /= scale;
+			}
+			return Rational<long long>(1);
+		}
+
+		template<typename Integer>
+		Integer NormalizeInequality(MatrixExt<Integer>& T, RowVector<Integer>& q, uword num_variables, uword j, Integer)
+		{
+			return ReduceInequality(T, q, num_variables, j);
+		}
+
+		/**
+		 * Compares x1 / scale1 and x2 / scale2, where scales are direction scales returned by NormalizeInequality() (rational ones are always 1).
+		 * Integer values are compared as x1 * scale2 < x2 * scale1 and as rational numbers only if one of the products overflows.
+		 */
+		inline bool LessScaled(const Rational<long long>& x1,
+			const Rational<long long>&,
+			const Rational<long long>& x2,
+			const Rational<long long>&)
+		{
+			return x1 < x2;
+		}
+
+		template<typename Integer>
+		bool LessScaled(Integer x1, Integer scale1, Integer x2, Integer scale2)
+		{
+			Integer lhs, rhs;
+			if (!MulOverflow(x1, scale2, lhs) && !MulOverflow(x2, scale1, rhs))
+				return lhs < rhs;
+			return Rational<long long>(static_cast<long long>(x1), static_cast<long long>(scale1)) <
+				Rational<long long>(static_cast<long long>(x2), static_cast<long long>(scale2));
+		}
+
+		/**
+		 * Removes redundant inequalities, as selected by options, from the system formed by the first num_inequalities columns of matrix T
+		 * (only the first num_variables rows are used) and elements of vector q, after num_eliminated variables have been eliminated. Element
+		 * j of histories holds sorted indexes of inequalities of the original system that were combined to form inequality j (it is empty when
+		 * options.prune_redundant is FALSE). Remaining inequalities are moved to the beginning of T, q and histories, preserving their order,
+		 * and num_inequalities is set to their number. Element is either Rational<long long> or the integer type of the fraction-free
+		 * elimination, both keep the same inequalities.
+		 *
+		 * Returns FALSE if some inequality without variables (0 <= qj) is not satisfied, which means that system doesn't have a solution.
+		 */
+		template<typename Element>
+		bool PruneRedundantInequalities(MatrixExt<Element>& T,
+			RowVector<Element>& q,
+			std::vector<std::vector<uword>>& histories,
+			uword num_variables,
+			uword num_eliminated,
+			uword& num_inequalities,
+			const FourierEliminationOptions& options)
+		{
+			std::vector<uword> kept;
+			kept.reserve(num_inequalities);
+
+			if (options.prune_redundant)
+			{
+				std::vector<Element> scales(num_inequalities);
+				for (auto j = 0U; j < num_inequalities; ++j)
+				{
+					/** Chernikov's rule: inequality formed from more than num_eliminated + 1 original inequalities is redundant. */
+					if (histories[j].size() > num_eliminated + 1)
+						continue;
+
+					auto first_nonzero = std::find_if(T.begin_col(j), T.begin_col(j) + num_variables,
+						[](const Element& value) { return CoefficientSign(value) != 0; });
+
+					if (first_nonzero == T.begin_col(j) + num_variables)
+					{
+						/** Inequality without variables: 0 <= qj. */
+						if (CoefficientSign(q(j)) < 0)
+							return false;
+						continue;
+					}
+
+					/** Normalized inequalities with the same direction have the same scaled coefficients. This makes duplicates easy to find. */
+					scales[j] = NormalizeInequality(T, q, num_variables, j, Element(*first_nonzero));
+					kept.push_back(j);
+				}
+
+				/**
+				 * Among the inequalities with the same direction only the one with the smallest (scaled) right-hand side has to be kept, as it
+				 * implies every other. Ties are broken in favour of the shorter history and then of the first inequality, so the rational and
+				 * the integer elimination keep the same one.
+				 */
+				auto less_coeffs = [&T, &scales, num_variables](uword j1, uword j2)
+				{
+					for (auto k = 0U; k < num_variables; ++k)
+					{
+						if (LessScaled(T(k, j1), scales[j1], T(k, j2), scales[j2]))
+							return true;
+						if (LessScaled(T(k, j2), scales[j2], T(k, j1), scales[j1]))
+							return false;
+					}
+					return false;
+				};
+
+				std::sort(kept.begin(), kept.end(), [&](uword j1, uword j2)
+				{
+					if (less_coeffs(j1, j2))
+						return true;
+					if (less_coeffs(j2, j1))
+						return false;
+					if (LessScaled(q(j1), scales[j1], q(j2), scales[j2]))
+						return true;
+					if (LessScaled(q(j2), scales[j2], q(j1), scales[j1]))
+						return false;
+					if (histories[j1].size() != histories[j2].size())
+						return histories[j1].size() < histories[j2].size();
+					return j1 < j2;
+				});
+
+				kept.erase(std::unique(kept.begin(), kept.end(), [&less_coeffs](uword j1, uword j2)
+				{
+					return !less_coeffs(j1, j2) && !less_coeffs(j2, j1);
+				}), kept.end());
+
+				std::sort(kept.begin(), kept.end());
+			}
+			else
+			{
+				for (auto j = 0U; j < num_inequalities; ++j)
+					kept.push_back(j);
+			}
+
+			if (options.exact_redundancy_check)
+			{
+				/** Inequalities are checked one by one against the rest of the system from which already found redundant ones were removed. */
+				for (auto it = kept.begin(); it != kept.end();)
+				{
+					if (IsImpliedInequality(T, q, kept, *it, num_variables))
+						it = kept.erase(it);
+					else
+						++it;
+				}
+			}
+
+			pruned_inequalities += num_inequalities - kept.size();
+
+			for (auto k = 0U; k < kept.size(); ++k)
+			{
+				if (kept[k] == k)
+					continue;
+
+				T(span(0, num_variables - 1), k) = T(span(0, num_variables - 1), kept[k]);
+				q(k) = q(kept[k]);
+				if (options.prune_redundant)
+					histories[k] = std::move(histories[kept[k]]);
+			}
+
+			num_inequalities = kept.size();
+			if (options.prune_redundant)
+				histories.resize(num_inequalities);
+			return true;
+		}
+	} // unnamed namespace
+
+	template<typename Integer>
+	bool PerformIntegerFourierElimination(const MatrixExt<Integer>& A,
+		const RowVector<Integer>& c,
+		std::vector<Bound>& b,
+		std::vector<Bound>& B,
+		const FourierEliminationOptions& options)
+	{
+		static_assert(std::is_integral<Integer>::value, "PerformIntegerFourierElimination() can be instantiated with integral types only!");
+
+		if (A.n_rows == 0 || A.n_cols == 0 || A.n_cols != c.n_cols)
+			throw std::logic_error("c2cuda::PerformIntegerFourierElimination(): A.n_rows and A.n_cols cannot be zero and A.n_cols must be equal to c.n_cols");
+
+		/** STEP 1: the system stays integer throughout the algorithm, each inequality is kept reduced by the GCD of its elements. */
+		MatrixExt<Integer> T(A);
+		RowVector<Integer> q(c);
+
+		uword curr_variable(A.n_rows);		/** Parameter r in algorithm. */
+		uword num_inequalities(A.n_cols);	/** Parameter s in algorithm. */
+
+		for (auto j = 0U; j < num_inequalities; ++j)
+			ReduceInequality(T, q, curr_variable, j);
+
+		std::vector<std::vector<uword>> histories;
+		if (options.prune_redundant)
+		{
+			histories.reserve(A.n_cols);
+			for (auto j = 0U; j < A.n_cols; ++j)
+				histories.push_back(std::vector<uword>(1, j));
+		}
+		UpdatePeakInequalities(num_inequalities);
+
+		std::vector<uword> pos_coefficients,
+						   neg_coefficients,
+						   zero_coefficients;
+
+		pos_coefficients.reserve(2 * A.n_cols);
+		neg_coefficients.reserve(2 * A.n_cols);
+		zero_coefficients.reserve(2 * A.n_cols);
+
+		b.reserve(A.n_rows);
+		B.reserve(A.n_rows);
+		b.clear();
+		B.clear();
+
+		/** STEP 2: set lower and upper boundary for each variable to -oo and +00 respectivelly (these are only initial values). */
+		for (auto i = 0U; i < A.n_rows; ++i)
+		{
+			b.push_back(std::make_pair(MatrixExt<Rational<long long>>(i + 1, 1), RowVector<Rational<long long>>({ Rational<long long>(std::numeric_limits<long long>::min()) })));
+			B.push_back(std::make_pair(MatrixExt<Rational<long long>>(i + 1, 1), RowVector<Rational<long long>>({ Rational<long long>(std::numeric_limits<long long>::max()) })));
+		}
+
+		if ((options.prune_redundant || options.exact_redundancy_check) &&
+			!PruneRedundantInequalities(T, q, histories, curr_variable, 0, num_inequalities, options))
+		{
+			b.clear();
+			B.clear();
+			return false;
+		}
+
+		/** System of the next iteration, T and q are swapped with them at the end of every iteration. */
+		MatrixExt<Integer> T_new(0, 0);
+		RowVector<Integer> q_new(0);
+
+		do
+		{
+			pos_coefficients.clear();
+			neg_coefficients.clear();
+			zero_coefficients.clear();
+
+			/** STEP 3: calculate pos_coefficients, neg_coefficients and zero_coefficients vectors for this iteration. */
+			for (auto j = 0U; j < num_inequalities; ++j)
+			{
+				if (T(curr_variable - 1, j) > Integer(0))
+					pos_coefficients.push_back(j);
+				else if (T(curr_variable - 1, j) < Integer(0))
+					neg_coefficients.push_back(j);
+				else
+					zero_coefficients.push_back(j);
+			}
+
+			/**
+			 * STEP 4 and 5: inequalities are not divided by trj. Bound functions are the only rational values that are formed, each element
+			 * -tkj/trj and qj/trj is created directly from the integer numerator and denominator.
+			 */
+			if (pos_coefficients.size() > 0)
+			{
+				B[curr_variable - 1] = std::make_pair(MatrixExt<Rational<long long>>(curr_variable, pos_coefficients.size()), RowVector<Rational<long long>>(pos_coefficients.size()));
+				for (auto i = 0U; i < pos_coefficients.size(); ++i)
+				{
+					const long long t_rj(static_cast<long long>(T(curr_variable - 1, pos_coefficients[i])));
+					for (auto k = 0U; k + 1 < curr_variable; ++k)
+						B[curr_variable - 1].first(k, i) = Rational<long long>(CheckedNegate(static_cast<long long>(T(k, pos_coefficients[i]))), t_rj);
+					B[curr_variable - 1].second(i) = Rational<long long>(static_cast<long long>(q(pos_coefficients[i])), t_rj);
+				}
+			}
+
+			if (neg_coefficients.size() > 0)
+			{
+				b[curr_variable - 1] = std::make_pair(MatrixExt<Rational<long long>>(curr_variable, neg_coefficients.size()), RowVector<Rational<long long>>(neg_coefficients.size()));
+				for (auto i = 0U; i < neg_coefficients.size(); ++i)
+				{
+					const long long t_rj(static_cast<long long>(T(curr_variable - 1, neg_coefficients[i])));
+					for (auto k = 0U; k + 1 < curr_variable; ++k)
+						b[curr_variable - 1].first(k, i) = Rational<long long>(CheckedNegate(static_cast<long long>(T(k, neg_coefficients[i]))), t_rj);
+					b[curr_variable - 1].second(i) = Rational<long long>(static_cast<long long>(q(neg_coefficients[i])), t_rj);
+				}
+			}
+
+			if (curr_variable == 1)
+			{
+				/** STEP 6: the same as in PerformFourierElimination(), inequalities 0 <= qj are checked on the integer right-hand sides. */
+				bool trivial_ineq_hold(std::all_of(zero_coefficients.begin(), zero_coefficients.end(),
+					[&q](uword i) { return q(i) >= Integer(0); }));
+
+				if (A.n_rows == 1 && pos_coefficients.empty() && neg_coefficients.empty())
+				{
+					b.clear();
+					B.clear();
+					return trivial_ineq_hold;
+				}
+
+				if (!trivial_ineq_hold)
+					return false;
+
+				Rational<long long> b1_max(b[curr_variable - 1].second.max());
+				Rational<long long> B1_min(B[curr_variable - 1].second.min());
+
+				if (b1_max > B1_min)
+					return false;		/** No solution. */
+
+				b[curr_variable - 1].first = { { Rational<long long>(0) } };
+				b[curr_variable - 1].second = { Rational<long long>(b1_max) };
+				B[curr_variable - 1].first = { { Rational<long long>(0) } };
+				B[curr_variable - 1].second = { Rational<long long>(B1_min) };
+
+				return true;
+			}
+
+			/** STEP 7: calculate the number of inequalities in the new system. */
+			uword num_inequalities_new = pos_coefficients.size() * neg_coefficients.size() + zero_coefficients.size();
+			if (num_inequalities_new == 0)
+				return true;
+
+			/** STEP 8: the new system is formed in T_new and q_new, as its inequalities are combined from the columns of T. */
+			T_new.set_size(curr_variable - 1, num_inequalities_new);
+			q_new.set_size(1, num_inequalities_new);
+
+			uword col_index(0);
+			for (auto i : zero_coefficients)
+			{
+				std::copy(T.begin_col(i), T.begin_col(i) + curr_variable - 1, T_new.begin_col(col_index));
+				q_new(col_index++) = q(i);
+			}
+
+			std::vector<std::vector<uword>> new_histories;
+			if (options.prune_redundant)
+			{
+				new_histories.reserve(num_inequalities_new);
+				for (auto i : zero_coefficients)
+					new_histories.push_back(std::move(histories[i]));
+			}
+
+			/**
+			 * Lower bound i of xr is (ti * x - qi) / n where n = -tri > 0 and upper bound j is (qj - tj * x) / p where p = trj > 0. Instead of
+			 * the rational inequality ti * x / n + tj * x / p <= qi / n + qj / p, its positive multiple (by lcm(n, p)) is formed. Both have
+			 * the same solutions and the integer one is then reduced by the GCD of its elements.
+			 */
+			for (auto i : neg_coefficients)
+			{
+				for (auto j : pos_coefficients)
+				{
+					const Integer n(CheckedNegate(T(curr_variable - 1, i))), p(T(curr_variable - 1, j));
+					const Integer g(static_cast<Integer>(BinaryGcd(n, p)));
+					const Integer mult_i(p / g), mult_j(n / g);
+
+					for (auto k = 0U; k + 1 < curr_variable; ++k)
+						T_new(k, col_index) = CheckedCombination(mult_i, T(k, i), mult_j, T(k, j));
+					q_new(col_index) = CheckedCombination(mult_i, q(i), mult_j, q(j));
+					ReduceInequality(T_new, q_new, curr_variable - 1, col_index++);
+
+					if (options.prune_redundant)
+					{
+						const auto & lower_history = histories[i];
+						const auto & upper_history = histories[j];
+						new_histories.push_back(std::vector<uword>());
+						std::set_union(lower_history.begin(), lower_history.end(), upper_history.begin(), upper_history.end(),
+							std::back_inserter(new_histories.back()));
+					}
+				}
+			}
+
+			generated_inequalities += num_inequalities_new - zero_coefficients.size();
+			UpdatePeakInequalities(num_inequalities_new);
+
+			T.swap(T_new);
+			q.swap(q_new);
+
+			if (options.prune_redundant || options.exact_redundancy_check)
+			{
+				histories.swap(new_histories);
+				if (!PruneRedundantInequalities(T, q, histories, curr_variable - 1, A.n_rows - curr_variable + 1, num_inequalities_new, options))
+					return false;	/** Some inequality 0 <= qj is not satisfied, no solution. */
+
+				if (num_inequalities_new == 0)
+					return true;
+			}
+
+			--curr_variable;
+			num_inequalities = num_inequalities_new;
+		} while (curr_variable >= 1);
+
+		return false;
+	}
+
+	namespace
+	{
+
+		/**
+		 * Runs PerformIntegerFourierElimination() for the integer system and stores its result in has_solution. Returns FALSE if the system
+		 * is not integer or if integer elimination overflowed, in which case the caller falls back to the rational elimination.
+		 */
+		template<typename T>
+		bool TryIntegerFourierElimination(const MatrixExt<T>& A,
+			const RowVector<T>& c,
+			std::vector<Bound>& b,
+			std::vector<Bound>& B,
+			const FourierEliminationOptions& options,
+			bool& has_solution,
+			std::true_type)
+		{
+			try
+			{
+				has_solution = PerformIntegerFourierElimination(A, c, b, B, options);
+				return true;
+			}
+			catch (const std::overflow_error&)
+			{
+				return false;
+			}
+		}
+
+		template<typename T>
+		bool TryIntegerFourierElimination(const MatrixExt<T>&,
+			const RowVector<T>&,
+			std::vector<Bound>&,
+			std::vector<Bound>&,
+			const FourierEliminationOptions&,
+			bool&,
+			std::false_type)
+		{
+			return false;
+		}
+
+	} // unnamed namespace
+
 	template<typename _T>
 	bool PerformFourierElimination(const MatrixExt<_T>& A,
 		const RowVector<_T>& c,
 		std::vector<Bound>& b,
-		std::vector<Bound>& B)
+		std::vector<Bound>& B,
+		const FourierEliminationOptions& options)
 	{
 		if (A.n_rows == 0 || A.n_cols == 0 || A.n_cols != c.n_cols)
 			throw std::logic_error("c2cuda::PerformFourierElimination(): A.n_rows and A.n_cols cannot be zero and A.n_cols must be equal to c.n_cols");
 
+		bool has_solution(false);
+		if (options.arithmetic == FOURIER_INTEGER &&
+			TryIntegerFourierElimination(A, c, b, B, options, has_solution, typename std::is_integral<_T>::type()))
+		{
+			return has_solution;
+		}
+
 		/** STEP 1: initialize coefficients matrix T and constants vector q that we'll work with throughout the algorithm. */
 		MatrixExt<Rational<long long>> T(A);
 		RowVector<Rational<long long>> q(c);
@@ -59,6 +677,16 @@ namespace util
 		uword curr_variable(A.n_rows);		/** Parameter r in algorithm. */
 		uword num_inequalities(A.n_cols);	/** Parameter s in algorithm. */
 
+		/** History of inequality j holds indexes of the inequalities of the original system that were combined to form it. */
+		std::vector<std::vector<uword>> histories;
+		if (options.prune_redundant)
+		{
+			histories.reserve(A.n_cols);
+			for (auto j = 0U; j < A.n_cols; ++j)
+				histories.push_back(std::vector<uword>(1, j));
+		}
+		UpdatePeakInequalities(num_inequalities);
+
 		/**
 		 * Reserve memory for pos_coefficients, neg_coefficients and zero_coefficients up-front, to minimize the number of
 		 * reallocations during algorithm. We're assuming any of these vectors will never have more than 2*A.n_cols elements
@@ -85,6 +713,15 @@ namespace util
 			B.push_back(std::make_pair(MatrixExt<Rational<long long>>(i + 1, 1), RowVector<Rational<long long>>({ Rational<long long>(std::numeric_limits<long long>::max()) })));
 		}
 
+		/** Duplicated, dominated and (optionally) implied inequalities of the original system are removed as well. */
+		if ((options.prune_redundant || options.exact_redundancy_check) &&
+			!PruneRedundantInequalities(T, q, histories, curr_variable, 0, num_inequalities, options))
+		{
+			b.clear();
+			B.clear();
+			return false;
+		}
+
 		//std::cout << std::endl << std::endl << "FOURIER ANALYSIS START\n\n";
 
 		do
@@ -100,12 +737,14 @@ namespace util
 			/** STEP 3: calculate pos_coefficients, neg_coefficients and zero_coefficients vectors for this iteration. */
 			for (auto j = 0U; j < num_inequalities; ++j)
 			{
-				if (T(curr_variable - 1, j) > Rational<_T>())
+				/** Only the sign of the coefficient matters, which is the sign of its numerator. */
+				int coeff_sign(Sign(T(curr_variable - 1, j)));
+				if (coeff_sign > 0)
 				{
 					/** Coefficient trj (inequality j) of variable xr is > 0. */
 					pos_coefficients.push_back(j);
 				}
-				else if (T(curr_variable - 1, j) < Rational<_T>())
+				else if (coeff_sign < 0)
 				{
 					/** Coefficient trj (inequality j) of variable xr is < 0. */
 					neg_coefficients.push_back(j);
@@ -173,7 +812,7 @@ namespace util
 				bool trivial_ineq_hold(true);
 				for (auto i : zero_coefficients)
 				{
-					if (q(i) < 0LL)
+					if (Sign(q(i)) < 0)
 					{
 						trivial_ineq_hold = false;	/** No solution. */
 						break;
@@ -222,7 +861,7 @@ namespace util
 			}
 
 			/** STEP 8: prepare new system of inequalities by modifying matrix T (coefficients) and vector q (right side of the system). */
-			if (num_inequalities_new > num_inequalities)
+			if (num_inequalities_new > T.n_cols)
 			{
 				/**
 				 * New system has num_inequalities_new - num_inequalities more inequalities than the previous one. Extend matrix T and vector
@@ -251,20 +890,59 @@ namespace util
 				++col_index;
 			}
 
+			/** Histories of the new system, in the same order as its inequalities. */
+			std::vector<std::vector<uword>> new_histories;
+			if (options.prune_redundant)
+			{
+				new_histories.reserve(num_inequalities_new);
+				for (auto i : zero_coefficients)
+					new_histories.push_back(std::move(histories[i]));
+			}
+
 			/*std::cout << std::endl << "T and q after moving zero_coefficients to beginning" << std::endl;
 			T.print("T:");
 			q.print("q:");*/
 
-			/** Form a new system by setting each lower boundary of xr <= than each upper boundary of xr. Append these to matrix T and vector q. */
-			for (auto i = 0U; i < b[curr_variable - 1].first.n_cols; ++i)
+			/**
+			 * Form a new system by setting each lower boundary of xr <= than each upper boundary of xr. Append these to matrix T and vector q.
+			 * If xr isn't bounded from below or above, b or B still holds its initial (infinite) bound, which is not combined.
+			 */
+			for (auto i = 0U; i < neg_coefficients.size(); ++i)
 			{
-				for (auto j = 0U; j < B[curr_variable - 1].first.n_cols; ++j)
+				for (auto j = 0U; j < pos_coefficients.size(); ++j)
 				{
 					std::transform(b[curr_variable - 1].first.begin_col(i), b[curr_variable - 1].first.begin_col(i) + curr_variable - 1,
 						B[curr_variable - 1].first.begin_col(j), T.begin_col(col_index),
 						[](const Rational<long long>& b_val, const Rational<long long>& B_val) { return b_val - B_val; });
 
 					q(col_index++) = B[curr_variable - 1].second(j) - b[curr_variable - 1].second(i);
+
+					if (options.prune_redundant)
+					{
+						/** History of the new inequality is the union of histories of the two inequalities it was formed from. */
+						const auto & lower_history = histories[neg_coefficients[i]];
+						const auto & upper_history = histories[pos_coefficients[j]];
+						new_histories.push_back(std::vector<uword>());
+						std::set_union(lower_history.begin(), lower_history.end(), upper_history.begin(), upper_history.end(),
+							std::back_inserter(new_histories.back()));
+					}
+				}
+			}
+
+			generated_inequalities += num_inequalities_new - zero_coefficients.size();
+			UpdatePeakInequalities(num_inequalities_new);
+
+			/** Remove redundant inequalities from the new system, so that it doesn't grow quadratically with every eliminated variable. */
+			if (options.prune_redundant || options.exact_redundancy_check)
+			{
+				histories.swap(new_histories);
+				if (!PruneRedundantInequalities(T, q, histories, curr_variable - 1, A.n_rows - curr_variable + 1, num_inequalities_new, options))
+					return false;	/** Some inequality 0 <= qj is not satisfied, no solution. */
+
+				if (num_inequalities_new == 0)
+				{
+					/** Every inequality has been trivially satisfied. Variables xi, i=1,...,r-1 can be chosen arbitrarily. */
+					return true;
 				}
 			}
 
@@ -279,95 +957,676 @@ namespace util
 		return false;
 	}
 
+	template<typename T>
+	bool PerformFourierElimination(const MatrixExt<T>& A,
+		const RowVector<T>& c,
+		BoundSet& lower,
+		BoundSet& upper,
+		const FourierEliminationOptions& options)
+	{
+		std::vector<Bound> b, B;
+		if (!PerformFourierElimination(A, c, b, B, options))
+		{
+			lower = BoundSet();
+			upper = BoundSet();
+			return false;
+		}
+
+		lower = BoundSet(b);
+		upper = BoundSet(B);
+		return true;
+	}
+
 	namespace
 	{
 
-		void EnumerateHelper(const std::vector<Bound>& b,
-			const std::vector<Bound>& B,
-			const RowVector<Rational<long long>>& partial_solution_vector,
-			uword current_variable, /** Counting starts from 0. */
-			std::vector<std::vector<RowVector<long long>>>& solution_sets,
-			size_t& solution_set_idx)
+		/** Rounds x / y towards -oo, y must be positive. */
+		long long FloorDiv(long long x, long long y)
 		{
-			if (current_variable >= b.size() || partial_solution_vector.n_cols != current_variable + 1 || partial_solution_vector(current_variable) != Rational<long long>(0))
-				throw std::logic_error("c2cuda::EnumerateIntegerSolutions(): internal error occured");
+			long long q(x / y);
+			return (x % y != 0 && x < 0) ? q - 1 : q;
+		}
 
-			auto & lower_bound = b[current_variable];
-			auto & upper_bound = B[current_variable];
+		/** Rounds x / y towards +oo, y must be positive. */
+		long long CeilDiv(long long x, long long y)
+		{
+			long long q(x / y);
+			return (x % y != 0 && x > 0) ? q + 1 : q;
+		}
 
-			if (lower_bound.first.n_rows != current_variable + 1 || lower_bound.second.n_rows != 1 || upper_bound.first.n_rows != current_variable + 1 ||
-				upper_bound.second.n_rows != 1)
-				throw std::logic_error("c2cuda::EnumerateIntegerSolutions(): form of lower and/or upper bounds is not valid");
+	} // unnamed namespace
 
-			/** Both lower and upper bound have to be finite. */
-			if (lower_bound.second(0) == std::numeric_limits<long long>::min() || upper_bound.second(0) == std::numeric_limits<long long>::max())
-				throw std::logic_error("c2cuda::EnumerateIntegerSolutions(): solution set is infinite");
+	IntegerSolutionEnumerator::IntegerSolutionEnumerator(const BoundSet& lower, const BoundSet& upper)
+		: m_first(std::numeric_limits<long long>::min())
+		, m_last(std::numeric_limits<long long>::max())
+		, m_solution(lower.NumVariables())
+		, m_started(false)
+		, m_done(false)
+	{
+		if (lower.NumVariables() != upper.NumVariables() || lower.NumVariables() == 0)
+			throw std::logic_error("c2cuda::EnumerateIntegerSolutions(): lower and upper bounds must have the same, non-zero, number of variables");
 
-			/** Find max of lower bounds rounded up to nearest integer.  */
-			long long max_lower_bound = static_cast<long long>(std::ceil((partial_solution_vector * lower_bound.first + lower_bound.second).max()));
+		const uword m(lower.NumVariables());
+		m_row_offsets.reserve(m + 1);
+		m_num_lower.reserve(m);
+		m_row_offsets.push_back(0);
+		for (auto v = 0U; v < m; ++v)
+		{
+			m_num_lower.push_back(lower.NumBounds(v));
+			m_row_offsets.push_back(m_row_offsets.back() + lower.NumBounds(v) + upper.NumBounds(v));
+		}
+		const uword num_rows(m_row_offsets.back());
 
-			/** Find min of upper bounds rounded down to nearest integer. */
-			long long min_upper_bound = static_cast<long long>(std::floor((partial_solution_vector * upper_bound.first + upper_bound.second).min()));
-			
-			if (max_lower_bound > min_upper_bound)
-				return;		/** No integer solution found. */
+		auto row = [&lower, &upper](uword v, uword k)
+		{
+			return k < lower.NumBounds(v) ? lower.Row(v, k) : upper.Row(v, k - lower.NumBounds(v));
+		};
+
+		uword partial_size(0), column_size(0);
+		m_partial_offsets.reserve(m);
+		m_column_offsets.reserve(m);
+		for (auto l = 0U; l < m; ++l)
+		{
+			m_partial_offsets.push_back(partial_size);
+			m_column_offsets.push_back(column_size);
+			partial_size += num_rows - m_row_offsets[l];
+			column_size += num_rows - m_row_offsets[l + 1];
+		}
+
+		m_denominators.resize(num_rows);
+		m_partial.resize(partial_size);
+		m_columns.resize(column_size);
+		m_upper.resize(m);
 
-			if (current_variable < b.size() - 1)
+		for (auto v = 0U; v < m; ++v)
+		{
+			for (auto k = 0U; k < m_row_offsets[v + 1] - m_row_offsets[v]; ++k)
 			{
-				/**
-				 * If current_variable < b.size() - 1 we still didn't reach the last variable. For each current variable's integer value
-				 * go level deeper to evaluate the rest of the variables.
-				 */
-				RowVector<Rational<long long>> new_solution_vector(arma::resize(partial_solution_vector, 1, partial_solution_vector.n_cols + 1).eval());
-				new_solution_vector(current_variable + 1) = 0;
-				for (auto int_val = max_lower_bound; int_val <= min_upper_bound; ++int_val)
+				const long long* bound(row(v, k));
+				const uword g(m_row_offsets[v] + k);
+				m_denominators[g] = bound[0];
+
+				/** Numerators of level 0 are the constant parts n0. */
+				m_partial[g] = bound[1];
+				for (auto l = 0U; l < v; ++l)
+					m_columns[m_column_offsets[l] + g - m_row_offsets[l + 1]] = bound[l + 2];
+			}
+		}
+	}
+
+	bool IntegerSolutionEnumerator::EnterLevel(uword level)
+	{
+		const uword num_rows(m_row_offsets[level + 1] - m_row_offsets[level]);
+		const uword num_lower(m_num_lower[level]);
+		if (num_lower == 0 || num_lower == num_rows)
+			throw std::logic_error("c2cuda::EnumerateIntegerSolutions(): solution set is infinite");
+
+		/** Rows of xl come first in the numerators of level l. */
+		const long long* partial(m_partial.data() + m_partial_offsets[level]);
+		const long long* denominators(m_denominators.data() + m_row_offsets[level]);
+
+		long long lower_bound(CeilDiv(partial[0], denominators[0]));
+		for (auto k = 1U; k < num_lower; ++k)
+			lower_bound = std::max(lower_bound, CeilDiv(partial[k], denominators[k]));
+
+		long long upper_bound(FloorDiv(partial[num_lower], denominators[num_lower]));
+		for (auto k = num_lower + 1; k < num_rows; ++k)
+			upper_bound = std::min(upper_bound, FloorDiv(partial[k], denominators[k]));
+
+		if (level == 0)
+		{
+			lower_bound = std::max(lower_bound, m_first);
+			upper_bound = std::min(upper_bound, m_last);
+		}
+
+		if (lower_bound > upper_bound)
+			return false;
+
+		m_solution(level) = lower_bound;
+		m_upper[level] = upper_bound;
+
+		if (level + 1 < m_solution.n_cols)
+		{
+			/** Numerators of level l + 1 are the ones of level l (without rows of xl) plus coefficients of xl multiplied by its value. */
+			const uword count(m_row_offsets.back() - m_row_offsets[level + 1]);
+			const long long* column(m_columns.data() + m_column_offsets[level]);
+			long long* next(m_partial.data() + m_partial_offsets[level + 1]);
+			bool overflow(false);
+			for (auto i = 0U; i < count; ++i)
+			{
+				long long product;
+				overflow |= MulOverflow(column[i], lower_bound, product) || AddOverflow(partial[num_rows + i], product, next[i]);
+			}
+
+			if (overflow)
+				throw std::overflow_error("c2cuda::EnumerateIntegerSolutions(): bound function doesn't fit into long long");
+		}
+		return true;
+	}
+
+	void IntegerSolutionEnumerator::IncrementLevel(uword level)
+	{
+		++m_solution(level);
+		if (level + 1 < m_solution.n_cols)
+		{
+			/** Incrementing xl adds its coefficients to the numerators of the inner variables. */
+			const uword count(m_row_offsets.back() - m_row_offsets[level + 1]);
+			const long long* column(m_columns.data() + m_column_offsets[level]);
+			long long* next(m_partial.data() + m_partial_offsets[level + 1]);
+			bool overflow(false);
+			for (auto i = 0U; i < count; ++i)
+				overflow |= AddOverflow(next[i], column[i], next[i]);
+
+			if (overflow)
+				throw std::overflow_error("c2cuda::EnumerateIntegerSolutions(): bound function doesn't fit into long long");
+		}
+	}
+
+	bool IntegerSolutionEnumerator::Next()
+	{
+		if (m_done)
+			return false;
+
+		const uword m(m_solution.n_cols);
+		if (m_started && m > 0 && m_solution[m - 1] < m_upper[m - 1])
+		{
+			/** Most of the calls only increment the innermost variable, no bound depends on it. */
+			++m_solution[m - 1];
+			return true;
+		}
+
+		uword level(m_started ? m : 0);
+		bool advance(m_started);
+		m_started = true;
+
+		for (;;)
+		{
+			if (advance)
+			{
+				/** Increment the innermost variable before level that is still below its upper bound. */
+				while (level > 0 && m_solution(level - 1) == m_upper[level - 1])
+					--level;
+
+				if (level == 0)
 				{
-					new_solution_vector(current_variable) = int_val;
-					EnumerateHelper(b, B, new_solution_vector, current_variable + 1, solution_sets, solution_set_idx);
+					m_done = true;
+					return false;
 				}
+				IncrementLevel(level - 1);
 			}
-			else
+
+			/** Set the inner variables to their lower bounds. If the range of one of them is empty, the variable outside of it is advanced. */
+			while (level < m && EnterLevel(level))
+				++level;
+
+			if (level == m)
+				return true;
+			advance = true;
+		}
+	}
+
+	const RowVector<long long>& IntegerSolutionEnumerator::Solution() const
+	{
+		return m_solution;
+	}
+
+	void IntegerSolutionEnumerator::RestrictFirstVariable(long long first, long long last)
+	{
+		m_first = first;
+		m_last = last;
+		m_started = false;
+		m_done = false;
+	}
+
+	bool EnumerateIntegerSolutions(const BoundSet& lower,
+		const BoundSet& upper,
+		const IntegerSolutionVisitor& visitor)
+	{
+		IntegerSolutionEnumerator enumerator(lower, upper);
+		bool found_solution(false);
+		while (enumerator.Next())
+		{
+			found_solution = true;
+			if (!visitor(enumerator.Solution()))
+				break;
+		}
+		return found_solution;
+	}
+
+	namespace
+	{
+
+		/** Part of the range of x1 owned by one worker of the parallel enumeration. The owner takes values from the front, thieves from the back. */
+		struct FirstVariablePart
+		{
+			std::mutex mutex;
+			long long next;
+			long long last;
+		};
+
+		/** Number of values in [first, last], computed modulo 2^64 so that it doesn't overflow for any range that is not empty. */
+		unsigned long long RangeSize(long long first, long long last)
+		{
+			return static_cast<unsigned long long>(last) - static_cast<unsigned long long>(first) + 1ULL;
+		}
+
+		/**
+		 * Takes the next value of x1 from part owner. If the part is empty, the upper half of the largest remaining part is stolen, the first
+		 * stolen value is returned and the rest becomes the new part of owner. Returns FALSE if there is no work left in any part.
+		 */
+		bool TakeFirstVariable(std::vector<FirstVariablePart>& parts, size_t owner, long long& x1)
+		{
 			{
-				/**
-				 * We reached the last variable and this is where recursion stops (as there are no more variables to evaluate). At this
-				 * point we have values of all variables including the last one. Expand solution_set with min_upper_bound - max_lower_bound + 1
-				 * new integer solutions.
-				 */
-				RowVector<long long> complete_solution_vector(partial_solution_vector);
-				for (auto int_val = max_lower_bound; int_val <= min_upper_bound; ++int_val)
+				std::lock_guard<std::mutex> lock(parts[owner].mutex);
+				if (parts[owner].next <= parts[owner].last)
+				{
+					x1 = parts[owner].next++;
+					return true;
+				}
+			}
+
+			for (;;)
+			{
+				size_t victim(parts.size());
+				unsigned long long largest(0);
+				for (auto p = 0U; p < parts.size(); ++p)
+				{
+					std::lock_guard<std::mutex> lock(parts[p].mutex);
+					if (parts[p].next <= parts[p].last && RangeSize(parts[p].next, parts[p].last) > largest)
+					{
+						largest = RangeSize(parts[p].next, parts[p].last);
+						victim = p;
+					}
+				}
+
+				if (victim == parts.size())
+					return false;
+
+				long long first, last;
+				{
+					std::lock_guard<std::mutex> lock(parts[victim].mutex);
+					if (parts[victim].next > parts[victim].last)
+						continue; /** Emptied in the meantime, look for another victim. */
+
+					unsigned long long half((RangeSize(parts[victim].next, parts[victim].last) + 1) / 2);
+					last = parts[victim].last;
+					first = static_cast<long long>(static_cast<unsigned long long>(last) - half + 1ULL);
+					parts[victim].last = first - 1;
+				}
+
+				std::lock_guard<std::mutex> lock(parts[owner].mutex);
+				x1 = first;
+				parts[owner].next = first + 1;
+				parts[owner].last = last;
+				return true;
+			}
+		}
+
+		/**
+		 * Tasks submitted to the pool by one parallel enumeration. ThreadPool::Wait() waits for every task of the pool, so the enumeration
+		 * waits only for its own tasks instead, which lets threads outside the pool share the pool by running enumerations concurrently.
+		 */
+		class EnumerationTasks
+		{
+		public:
+			explicit EnumerationTasks(ThreadPool& pool)
+				: m_pool(pool)
+				, m_pending(0)
+			{
+			}
+
+			void Submit(const ThreadPool::Task& task)
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					++m_pending;
+				}
+
+				m_pool.Submit([this, task](unsigned worker_idx)
+				{
+					std::exception_ptr exc;
+					try
+					{
+						task(worker_idx);
+					}
+					catch (...)
+					{
+						exc = std::current_exception();
+					}
+
+					std::lock_guard<std::mutex> lock(m_mutex);
+					if (exc && !m_exception)
+						m_exception = exc;
+
+					/** Notified under the lock, as the waiting thread destroys this object as soon as it sees no pending tasks. */
+					if (--m_pending == 0)
+						m_done.notify_all();
+				});
+			}
+
+			/** Blocks until all submitted tasks are done and rethrows the first exception thrown by any of them. */
+			void Wait()
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_done.wait(lock, [this]() { return m_pending == 0; });
+				if (m_exception)
+					std::rethrow_exception(m_exception);
+			}
+
+		private:
+			ThreadPool& m_pool;
+			std::mutex m_mutex;
+			std::condition_variable m_done;
+			size_t m_pending;
+			std::exception_ptr m_exception;
+		};
+
+		/** Calculates the integer range [first, last] of x1. Returns FALSE if it is empty. */
+		bool FindFirstVariableRange(const BoundSet& lower, const BoundSet& upper, long long& first, long long& last)
+		{
+			if (lower.NumVariables() != upper.NumVariables() || lower.NumVariables() == 0)
+				throw std::logic_error("c2cuda::EnumerateIntegerSolutions(): lower and upper bounds must have the same, non-zero, number of variables");
+
+			if (!lower.IsBounded(0) || !upper.IsBounded(0))
+				throw std::logic_error("c2cuda::EnumerateIntegerSolutions(): solution set is infinite");
+
+			/** x1 is the first variable, so its bounds are constants. */
+			const RowVector<long long> no_variables(0);
+			first = lower.CeilMax(0, no_variables);
+			last = upper.FloorMin(0, no_variables);
+			return first <= last;
+		}
+
+		/**
+		 * Runs the parallel enumeration of x1 in [first, last], visitor(worker_idx, solution) is called for every solution. Visitor is a template
+		 * parameter so that the call isn't made through another std::function for every solution.
+		 */
+		template<typename Visitor>
+		bool ParallelEnumerateIntegerSolutions(const BoundSet& lower,
+			const BoundSet& upper,
+			long long first,
+			long long last,
+			ThreadPool& pool,
+			const Visitor& visitor)
+		{
+			const unsigned long long count(RangeSize(first, last));
+			const size_t num_parts(static_cast<size_t>(std::min<unsigned long long>(pool.GetThreadCnt(), count)));
+			std::vector<FirstVariablePart> parts(num_parts);
+			const unsigned long long base(count / num_parts), rem(count % num_parts);
+			unsigned long long offset(0);
+			for (auto p = 0U; p < num_parts; ++p)
+			{
+				parts[p].next = static_cast<long long>(static_cast<unsigned long long>(first) + offset);
+				offset += base + (p < rem ? 1 : 0);
+				parts[p].last = static_cast<long long>(static_cast<unsigned long long>(first) + offset - 1ULL);
+			}
+
+			std::atomic<bool> stop(false), found_solution(false);
+			EnumerationTasks tasks(pool);
+			for (auto p = 0U; p < num_parts; ++p)
+			{
+				tasks.Submit([&lower, &upper, &visitor, &parts, &stop, &found_solution, p](unsigned worker_idx)
 				{
-					complete_solution_vector(current_variable) = int_val;
 					try
 					{
-						/** If this fails then we're out of continous memory space in current solution set. Switch to next one. */
-						solution_sets[solution_set_idx].push_back(complete_solution_vector);
+						IntegerSolutionEnumerator enumerator(lower, upper);
+						long long x1;
+						while (!stop.load(std::memory_order_relaxed) && TakeFirstVariable(parts, p, x1))
+						{
+
+							enumerator.RestrictFirstVariable(x1, x1);
+							if (!enumerator.Next())
+								continue;
+
+							found_solution = true;
+							do
+							{
+								if (!visitor(worker_idx, enumerator.Solution()))
+									stop = true;
+							} while (!stop.load(std::memory_order_relaxed) && enumerator.Next());
+						}
 					}
-					catch (const std::bad_alloc&)
+					catch (...)
 					{
-						/** Add new solution set as we're out of memory space in current one. */
-						solution_sets.push_back(std::vector<RowVector<long long>>());
-						solution_sets[++solution_set_idx].push_back(complete_solution_vector);
+						stop = true;
+						throw;
 					}
+				});
+			}
+
+			tasks.Wait();
+			return found_solution;
+		}
+
+		/** Number of values of x1 every worker of the ordered enumeration may explore ahead of the lowest value not handed over yet. */
+		const unsigned long long ORDERED_WINDOW_PER_WORKER(4);
+
+		/**
+		 * Runs the parallel enumeration of x1 in [first, last] and hands every solution to visitor in lexicographic order, one call at a time.
+		 * Workers claim the values of x1 in increasing order. The worker of the lowest value that hasn't been handed over yet (the head) calls
+		 * visitor directly, the other workers buffer the solutions of their values until these become the head. Values that are the window
+		 * size or more ahead of the head are not claimed until the head moves, so at most window values are buffered at any time.
+		 */
+		bool OrderedEnumerateIntegerSolutions(const BoundSet& lower,
+			const BoundSet& upper,
+			long long first,
+			long long last,
+			ThreadPool& pool,
+			const IntegerSolutionVisitor& visitor)
+		{
+			/** Solutions buffered for the value of x1 at offset (from first) equal to the index of the slot modulo the window size. */
+			struct Slot
+			{
+				bool done;
+				std::vector<RowVector<long long>> solutions;
+			};
+
+			const unsigned long long count(RangeSize(first, last));
+			const unsigned long long window(std::min<unsigned long long>(ORDERED_WINDOW_PER_WORKER * pool.GetThreadCnt(), count));
+			std::vector<Slot> slots(static_cast<size_t>(window));
+			std::mutex mutex;
+			std::condition_variable window_moved;
+			unsigned long long next_claim(0);
+			std::atomic<unsigned long long> head(0);
+			std::atomic<bool> stop(false), found_solution(false);
+
+			auto halt = [&]()
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					stop = true;
+				}
+				window_moved.notify_all();
+			};
+
+			auto hand_over = [&](std::vector<RowVector<long long>>& solutions)
+			{
+				for (auto& solution : solutions)
+				{
+					if (stop.load(std::memory_order_relaxed))
+						break;
+					if (!visitor(solution))
+						halt();
+				}
+				std::vector<RowVector<long long>>().swap(solutions);
+			};
+
+			/**
+			 * Marks the value at offset as done. When it is the head, the head is moved past it and past every following value that is done,
+			 * handing over their buffered solutions. A value that is done while it isn't the head is handed over by the worker that moves
+			 * the head past it later. Both happen under the lock, so every value is handed over exactly once.
+			 */
+			auto finish = [&](unsigned long long offset)
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				slots[offset % window].done = true;
+				for (unsigned long long h(offset); h == head.load() && slots[h % window].done;)
+				{
+					std::vector<RowVector<long long>> pending;
+					pending.swap(slots[h % window].solutions);
+					lock.unlock();
+					hand_over(pending);
+					lock.lock();
+
+					slots[h % window].done = false;
+					head = ++h;
+					window_moved.notify_all();
+					if (h == count)
+						break;
 				}
+			};
+
+			EnumerationTasks tasks(pool);
+			for (auto w = 0ULL; w < std::min<unsigned long long>(pool.GetThreadCnt(), count); ++w)
+			{
+				tasks.Submit([&](unsigned)
+				{
+					try
+					{
+						IntegerSolutionEnumerator enumerator(lower, upper);
+						for (;;)
+						{
+							unsigned long long offset;
+							{
+								std::unique_lock<std::mutex> lock(mutex);
+								window_moved.wait(lock, [&]() { return stop || next_claim == count || next_claim < head + window; });
+								if (stop || next_claim == count)
+									return;
+								offset = next_claim++;
+							}
+
+							/** The buffer is touched by other workers only after the value is done. */
+							std::vector<RowVector<long long>>& buffer(slots[offset % window].solutions);
+							const long long x1(static_cast<long long>(static_cast<unsigned long long>(first) + offset));
+							bool is_head(false);
+							enumerator.RestrictFirstVariable(x1, x1);
+							while (!stop.load(std::memory_order_relaxed) && enumerator.Next())
+							{
+								found_solution = true;
+								if (!is_head && head.load() == offset)
+								{
+									/** The previous head has handed over its solutions before it moved the head here. */
+									is_head = true;
+									hand_over(buffer);
+								}
+
+								if (!is_head)
+									buffer.push_back(enumerator.Solution());
+								else if (!visitor(enumerator.Solution()))
+									halt();
+							}
+							finish(offset);
+						}
+					}
+					catch (...)
+					{
+						halt();
+						throw;
+					}
+				});
 			}
+
+			tasks.Wait();
+			return found_solution;
 		}
+
 	} // unnamed namespace
 
+	bool EnumerateIntegerSolutions(const BoundSet& lower,
+		const BoundSet& upper,
+		ThreadPool& pool,
+		const ParallelIntegerSolutionVisitor& visitor)
+	{
+		long long first, last;
+		if (!FindFirstVariableRange(lower, upper, first, last))
+			return false;
+
+		return ParallelEnumerateIntegerSolutions(lower, upper, first, last, pool, visitor);
+	}
+
+	bool EnumerateIntegerSolutionsInOrder(const BoundSet& lower,
+		const BoundSet& upper,
+		ThreadPool& pool,
+		const IntegerSolutionVisitor& visitor)
+	{
+		long long first, last;
+		if (!FindFirstVariableRange(lower, upper, first, last))
+			return false;
+
+		return OrderedEnumerateIntegerSolutions(lower, upper, first, last, pool, visitor);
+	}
+
+	bool EnumerateIntegerSolutions(const BoundSet& lower,
+		const BoundSet& upper,
+		ThreadPool& pool,
+		std::vector<RowVector<long long>>& solutions)
+	{
+		return EnumerateIntegerSolutionsInOrder(lower, upper, pool, [&solutions](const RowVector<long long>& solution)
+		{
+			solutions.push_back(solution);
+			return true;
+		});
+	}
+
 	bool EnumerateIntegerSolutions(const std::vector<Bound>& b,
 		const std::vector<Bound>& B,
-		std::vector<std::vector<RowVector<long long>>>& solution_sets)
+		const IntegerSolutionVisitor& visitor)
 	{
 		if (b.size() != B.size() || b.empty() || B.empty())
 			throw std::logic_error("c2cuda::EnumerateIntegerSolutions(): vectors b and B must have the same size and be non-empty");
 
+		return EnumerateIntegerSolutions(BoundSet(b), BoundSet(B), visitor);
+	}
+
+	bool EnumerateIntegerSolutions(const std::vector<Bound>& b,
+		const std::vector<Bound>& B,
+		std::vector<std::vector<RowVector<long long>>>& solution_sets)
+	{
 		solution_sets.push_back(std::vector<RowVector<long long>>());
-		size_t set_idx(0);
-		EnumerateHelper(b, B, { 0 }, 0, solution_sets, set_idx);
-		return !solution_sets[0].empty();
+		size_t set_idx(solution_sets.size() - 1);
+
+		return EnumerateIntegerSolutions(b, B, [&solution_sets, &set_idx](const RowVector<long long>& solution)
+		{
+			try
+			{
+				/** If this fails then we're out of continous memory space in current solution set. Switch to next one. */
+				solution_sets[set_idx].push_back(solution);
+			}
+			catch (const std::bad_alloc&)
+			{
+				/** Add new solution set as we're out of memory space in current one. */
+				solution_sets.push_back(std::vector<RowVector<long long>>());
+				solution_sets[++set_idx].push_back(solution);
+			}
+			return true;
+		});
+	}
+
+	FourierEliminationStatistics GetFourierEliminationStatistics()
+	{
+		FourierEliminationStatistics stats;
+		stats.peak_inequalities = peak_inequalities.load();
+		stats.generated_inequalities = generated_inequalities.load();
+		stats.pruned_inequalities = pruned_inequalities.load();
+		return stats;
+	}
+
+	void ResetFourierEliminationStatistics()
+	{
+		peak_inequalities = 0;
+		generated_inequalities = 0;
+		pruned_inequalities = 0;
 	}
 
 	//template bool PerformFourierElimination<int>(const MatrixExt<int>& A, const RowVector<int>& c, std::vector<Bound>& b, std::vector<Bound>& B);
-	template bool PerformFourierElimination<long long>(const MatrixExt<long long>& A, const RowVector<long long>& c, std::vector<Bound>& b, std::vector<Bound>& B);
+	template bool PerformFourierElimination<long long>(const MatrixExt<long long>& A, const RowVector<long long>& c, std::vector<Bound>& b, std::vector<Bound>& B,
+		const FourierEliminationOptions& options);
+	template bool PerformFourierElimination<long long>(const MatrixExt<long long>& A, const RowVector<long long>& c, BoundSet& lower, BoundSet& upper,
+		const FourierEliminationOptions& options);
+	template bool PerformIntegerFourierElimination<int>(const MatrixExt<int>& A, const RowVector<int>& c, std::vector<Bound>& b, std::vector<Bound>& B,
+		const FourierEliminationOptions& options);
+	template bool PerformIntegerFourierElimination<long long>(const MatrixExt<long long>& A, const RowVector<long long>& c, std::vector<Bound>& b,
+		std::vector<Bound>& B, const FourierEliminationOptions& options);
 
 } /// namespace util
 } /// namespace gap
@@ -37,13 +37,16 @@
 
 #include <vector>
 #include <utility>
+#include <functional>
 #include "row_vector.h"
 #include "rational_number.hpp"
+#include "bound_set.h"
 
 namespace gap
 {
 namespace util
 {
+	class ThreadPool;
 
 	/**
 		* Solves the system of n inequalities with m variables by applying Fourier elimination method. System has the following
@@ -182,6 +185,9 @@ namespace util
 		*    inequality. In this way every inequality will be in proper form t1jx1 + t2jx2 + ... + tr-1jxr-1 <= qj. Append all the inequalities for which
 		*    coefficient trj was 0 (identified by zero_coeffficients).
 		*
+		*    Remove redundant inequalities from the new system as selected by options (@see FourierEliminationOptions) and set s' to the number
+		*    of remaining inequalities. If some inequality without variables 0 <= qj is not satisfied, THE SYSTEM DOESN'T HAVE a solution.
+		*
 		*    Set s = s', r = r - 1 and go to step 3.
 		*
 		* @param There are two input params: coefficients matrix A and vector of constants that represent the right-hand side of the system. There are two
@@ -207,17 +213,105 @@ namespace util
 		* @see Loop Transformations for Restructuring Compilers, The Foundations (Algorithm 3.2)
 		*/
 
-		/**
-		* Simple type alias that is used to represent bound of single variable xi. Fourier elimination produces set of these bounds for every variable in
-		* system.
+	/**
+		* Arithmetic used by PerformFourierElimination() for the inequalities of the intermediate systems. FOURIER_RATIONAL divides every
+		* inequality by its coefficient trj (step 4) and combines them in Rational<long long>. FOURIER_INTEGER is the fraction-free variant
+		* (@see PerformIntegerFourierElimination()), it is used only for integer systems and only as long as no intermediate value overflows,
+		* otherwise PerformFourierElimination() falls back to FOURIER_RATIONAL. Both produce the same bounds b and B.
+		*/
+	enum FourierArithmetic
+	{
+		FOURIER_RATIONAL = 0
+		, FOURIER_INTEGER
+	};
+
+	/**
+		* Options that control removal of redundant inequalities from the original system and from every system formed in step 8 of
+		* PerformFourierElimination(). Without it, each step produces pos * neg + zero inequalities and the system grows quadratically with
+		* every eliminated variable. Removing the redundant inequalities doesn't change the set of REAL solutions, so bounds b and B describe
+		* the same solution set (they only contain fewer bound functions).
+		*
+		* prune_redundant - for every inequality, indexes of inequalities of the original system that were combined to form it (its history)
+		* are tracked. After k variables have been eliminated, an inequality whose history has more than k + 1 elements is redundant
+		* (Chernikov's rule) and it is dropped. Inequalities are then scaled so that the first non-zero coefficient is +-1, trivially satisfied
+		* inequalities 0 <= qj are dropped and, among inequalities with the same coefficients, only the one with the smallest right-hand side
+		* is kept.
+		*
+		* exact_redundancy_check - inequality ax <= qj is additionally dropped when system formed from the rest of the inequalities and ax > qj
+		* has no REAL solution. This finds every redundant inequality, but it solves one system per inequality, so it is off by default.
+		*
+		* arithmetic - @see FourierArithmetic.
 		*/
-	typedef std::pair<MatrixExt<Rational<long long>>, RowVector<Rational<long long>>> Bound;
+	struct FourierEliminationOptions
+	{
+		bool prune_redundant;
+		bool exact_redundancy_check;
+		FourierArithmetic arithmetic;
+
+		FourierEliminationOptions()
+			: prune_redundant(true)
+			, exact_redundancy_check(false)
+			, arithmetic(FOURIER_RATIONAL)
+		{
+		}
+	};
+
+	/**
+		* Counters updated by PerformFourierElimination() and PerformIntegerFourierElimination() since the last ResetFourierEliminationStatistics()
+		* call. peak_inequalities is the largest number of inequalities any system had (before pruning), generated_inequalities is the number of
+		* inequalities formed in step 8 and pruned_inequalities the number of those removed as redundant.
+		*/
+	struct FourierEliminationStatistics
+	{
+		unsigned long long peak_inequalities;
+		unsigned long long generated_inequalities;
+		unsigned long long pruned_inequalities;
+	};
 
 	template<typename T>
 	bool PerformFourierElimination(const MatrixExt<T>& A,
 		const RowVector<T>& c,
 		std::vector<Bound>& b,
-		std::vector<Bound>& B);
+		std::vector<Bound>& B,
+		const FourierEliminationOptions& options = FourierEliminationOptions());
+
+	/**
+		* Same as PerformFourierElimination() above, but the bounds are returned in the compact form used by EnumerateIntegerSolutions() (@see
+		* BoundSet). Bound sets are empty if the system doesn't have a solution.
+		*
+		* @throw std::overflow_error if some bound function can't be represented by BoundSet.
+		*/
+	template<typename T>
+	bool PerformFourierElimination(const MatrixExt<T>& A,
+		const RowVector<T>& c,
+		BoundSet& lower,
+		BoundSet& upper,
+		const FourierEliminationOptions& options = FourierEliminationOptions());
+
+	/**
+		* Fraction-free variant of PerformFourierElimination() which never leaves the integer type of the system. Inequalities are not divided
+		* by trj in step 4. Instead, lower bound i and upper bound j of xr (n = -tri > 0, p = trj > 0) are combined in step 8 as
+		* (p / g) * Ti + (n / g) * Tj <= (p / g) * qi + (n / g) * qj, where g = GCD(n, p), which is a positive multiple of the inequality the
+		* rational variant forms, and every new inequality is divided by the GCD of its coefficients and its right-hand side. Only the elements
+		* of bounds b and B are formed as rational numbers, directly from the integer numerators and denominators, so b and B are exactly the
+		* same as the ones returned by PerformFourierElimination(). Redundant inequalities are removed as selected by options (options.arithmetic
+		* is ignored).
+		*
+		* @throw std::logic_error under the same conditions as PerformFourierElimination(). std::overflow_error is thrown if some coefficient
+		* of the intermediate system doesn't fit into Integer.
+		*/
+	template<typename Integer>
+	bool PerformIntegerFourierElimination(const MatrixExt<Integer>& A,
+		const RowVector<Integer>& c,
+		std::vector<Bound>& b,
+		std::vector<Bound>& B,
+		const FourierEliminationOptions& options = FourierEliminationOptions());
+
+	/** Returns the snapshot of PerformFourierElimination() counters. Counters are atomic and shared by all threads. */
+	FourierEliminationStatistics GetFourierEliminationStatistics();
+
+	/** Sets all PerformFourierElimination() counters to zero. */
+	void ResetFourierEliminationStatistics();
 
 
 	/**
@@ -246,6 +340,159 @@ namespace util
 		const std::vector<Bound>& B,
 		std::vector<std::vector<RowVector<long long>>>& solution_sets);
 
+	/**
+		* Callback type used by the streaming variant of EnumerateIntegerSolutions(). The visitor is invoked once for every integer solution
+		* vector, in the same (lexicographic) order in which the materializing variant stores them. The RowVector passed to the visitor is owned
+		* by the enumerator and is overwritten in place for every solution, so the visitor must copy it if it needs to keep it around. Returning
+		* FALSE from the visitor stops the enumeration.
+		*/
+	typedef std::function<bool(const RowVector<long long>&)> IntegerSolutionVisitor;
+
+	/**
+		* Streaming variant of EnumerateIntegerSolutions(). Instead of materializing the solution set, each integer solution is handed to the
+		* visitor as soon as it is found. A single solution vector is allocated up-front and reused for every point, which means that memory
+		* consumption doesn't depend on the size of the solution set. Lower and upper bounds of each variable are evaluated exactly (without
+		* conversion to floating point) before rounding them up/down to the nearest integer.
+		*
+		* @param b and B are the lower and upper bounds returned by PerformFourierElimination(). Visitor is invoked for every integer solution.
+		*
+		* @retval TRUE if at least one integer solution has been passed to the visitor, FALSE otherwise.
+		*
+		* @throw std::logic_error under the same conditions as the materializing variant. std::overflow_error is thrown if the bounds can't be
+		* converted to BoundSet.
+		*/
+	bool EnumerateIntegerSolutions(const std::vector<Bound>& b,
+		const std::vector<Bound>& B,
+		const IntegerSolutionVisitor& visitor);
+
+	/**
+		* Streaming variant of EnumerateIntegerSolutions() that works on the compact bounds (@see BoundSet). Variants taking std::vector<Bound>
+		* convert the bounds and call this one. Bounds of each variable are evaluated in integer arithmetic and rounded exactly.
+		*
+		* @throw std::logic_error if the solution set is infinite or if lower and upper don't have the same, non-zero, number of variables.
+		*/
+	bool EnumerateIntegerSolutions(const BoundSet& lower,
+		const BoundSet& upper,
+		const IntegerSolutionVisitor& visitor);
+
+	/**
+		* @brief Non-recursive (odometer) enumerator of the integer solutions described by lower and upper bounds of variables x1,...,xm, used by
+		* EnumerateIntegerSolutions(). Solutions are produced in the same lexicographic order: Next() increments the innermost variable that is
+		* still below its upper bound and resets every variable inside of it to its lower bound.
+		*
+		* Bound functions are not evaluated from scratch for every point. For every level l, numerators of the bound functions of the variables
+		* xl,...,xm with x1,...,xl-1 already applied are kept. Setting xl to its lower bound derives the numerators of level l + 1 from the ones of
+		* level l, and incrementing xl adds the coefficients of xl (one column per level, stored contiguously) to them. Bounds of xl are then the
+		* maximum (minimum) of the numerators divided by their denominators, rounded exactly. All memory is allocated in the constructor, Next()
+		* doesn't allocate.
+		*
+		* Bound sets must outlive the enumerator. Numerators are kept in long long, std::overflow_error is thrown by Next() if one of them
+		* overflows. std::logic_error is thrown by Next() when it reaches a variable that is not bounded from below or from above.
+		*/
+	class IntegerSolutionEnumerator
+	{
+	public:
+		/** @throw std::logic_error if lower and upper don't have the same, non-zero, number of variables. */
+		IntegerSolutionEnumerator(const BoundSet& lower, const BoundSet& upper);
+
+		IntegerSolutionEnumerator(const IntegerSolutionEnumerator&) = delete;
+		IntegerSolutionEnumerator& operator=(const IntegerSolutionEnumerator&) = delete;
+
+		/** Moves to the first solution on the first call and to the next one afterwards. Returns FALSE if there are no more solutions. */
+		bool Next();
+
+		/** Current solution, valid after Next() has returned TRUE. It is overwritten in place by the next call to Next(). */
+		const RowVector<long long>& Solution() const;
+
+		/**
+		 * Restricts x1 to [first, last] (intersected with its bounds) and restarts the enumeration, so that the next call to Next() moves
+		 * to the first solution with x1 in that range. Used to enumerate the subtrees of different values of x1 independently.
+		 */
+		void RestrictFirstVariable(long long first, long long last);
+
+	private:
+		bool EnterLevel(uword level);
+		void IncrementLevel(uword level);
+
+		/** Index of the first row of variable r in the order: rows of lower bounds of x1, rows of upper bounds of x1, lower bounds of x2,... */
+		std::vector<uword> m_row_offsets;
+		std::vector<uword> m_num_lower;
+		std::vector<long long> m_denominators;
+
+		/**
+		 * Numerators of rows of variables xl,...,xm with x1,...,xl-1 applied, for every level l (starting at m_partial_offsets[l]), and
+		 * coefficients of xl in rows of variables xl+1,...,xm, for every level l (starting at m_column_offsets[l]).
+		 */
+		std::vector<long long> m_partial;
+		std::vector<uword> m_partial_offsets;
+		std::vector<long long> m_columns;
+		std::vector<uword> m_column_offsets;
+
+		/** Upper bound of every variable for the current values of the outer variables. */
+		std::vector<long long> m_upper;
+		long long m_first;
+		long long m_last;
+		RowVector<long long> m_solution;
+		bool m_started;
+		bool m_done;
+	};
+
+	/**
+		* Callback type used by the parallel variant of EnumerateIntegerSolutions(). Besides the solution, the visitor receives the index of
+		* the worker thread that found it (in range [0, pool.GetThreadCnt())), so that every worker can feed its own sink without locking.
+		* Returning FALSE from the visitor stops the enumeration on all workers.
+		*/
+	typedef std::function<bool(unsigned, const RowVector<long long>&)> ParallelIntegerSolutionVisitor;
+
+	/**
+		* Parallel variant of EnumerateIntegerSolutions(). Once the integer range of x1 is known, the subtrees of its values are independent,
+		* so the range is split into one contiguous part per worker of the pool. Every worker takes the values of x1 from the front of its own
+		* part, and a worker which runs out of work steals the upper half of the largest remaining part, which balances triangular spaces
+		* where the subtrees differ in size. Every worker has its own IntegerSolutionEnumerator.
+		*
+		* Solutions of the same value of x1 are handed to the visitor by the same worker, in lexicographic order. The order across different
+		* values of x1 is not defined, use the variant below when the order matters. The method blocks until its own tasks are done (it doesn't
+		* wait for other tasks of the pool), so threads outside the pool can share it by enumerating concurrently. It must not be called from
+		* a task already running in the pool, as the task would wait for workers that may all be waiting too.
+		*
+		* @retval TRUE if at least one integer solution has been passed to the visitor, FALSE otherwise.
+		*
+		* @throw std::logic_error under the same conditions as the sequential variant. The first exception thrown by any worker (including the
+		* visitor) is rethrown after all workers have stopped.
+		*/
+	bool EnumerateIntegerSolutions(const BoundSet& lower,
+		const BoundSet& upper,
+		ThreadPool& pool,
+		const ParallelIntegerSolutionVisitor& visitor);
+
+	/**
+		* Parallel variant of EnumerateIntegerSolutions() that hands the solutions to the visitor in the same (lexicographic) order as the
+		* sequential variant, regardless of the number of workers. Workers claim the values of x1 in increasing order. The worker of the lowest
+		* value whose solutions haven't been handed over yet calls the visitor directly, while workers of the higher values buffer their
+		* solutions. Values are not claimed further than a few per worker ahead of the lowest one, so only the solutions of that many values
+		* are held in memory at any time. The visitor is called by the workers, but never by two of them at the same time, so it needs no
+		* locking. Returning FALSE from the visitor stops the enumeration on all workers. The same restrictions on the calling thread as above
+		* apply.
+		*
+		* @retval TRUE if at least one integer solution has been found, FALSE otherwise.
+		*/
+	bool EnumerateIntegerSolutionsInOrder(const BoundSet& lower,
+		const BoundSet& upper,
+		ThreadPool& pool,
+		const IntegerSolutionVisitor& visitor);
+
+	/**
+		* Parallel variant of EnumerateIntegerSolutions() that collects the solutions, in lexicographic order (@see
+		* EnumerateIntegerSolutionsInOrder()). Apart from the collected solutions, only the solutions of the values of x1 ahead of the lowest
+		* unfinished one are buffered, and they are released as soon as they are appended.
+		*
+		* @retval TRUE if at least one integer solution has been found, FALSE otherwise.
+		*/
+	bool EnumerateIntegerSolutions(const BoundSet& lower,
+		const BoundSet& upper,
+		ThreadPool& pool,
+		std::vector<RowVector<long long>>& solutions);
+
 } /// namespace util
 } /// namespace gap
 
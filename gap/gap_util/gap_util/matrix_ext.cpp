@@ -33,6 +33,7 @@
 /// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <utility>
+#include <algorithm>
 #include <stdexcept>
 #include "matrix_ext.h"
 #include "rational_number.hpp"
@@ -44,6 +45,22 @@ namespace gap
 {
 namespace util
 {
+namespace
+{
+
+	/** Returns TRUE if elements of column col are zero in rows first_row, first_row + 1,..., n_rows - 1. */
+	template<typename T>
+	bool IsZeroBelow(const MatrixExt<T>& X, const uword first_row, const uword col)
+	{
+		for (auto i = first_row; i < X.n_rows; ++i)
+		{
+			if (X(i, col) != static_cast<T>(0))
+				return false;
+		}
+		return true;
+	}
+
+} // unnamed namespace
 
     template<typename T>
     MatrixExt<T>::MatrixExt(const uword num_rows, const uword num_cols): Mat<T>(num_rows, num_cols, fill::zeros)
@@ -65,6 +82,16 @@ namespace util
     {
     }
 
+    template<typename T>
+    MatrixExt<T>::MatrixExt(const MatrixExt& X): Mat<T>(X)
+    {
+    }
+
+    template<typename T>
+    MatrixExt<T>::MatrixExt(MatrixExt&& X): Mat<T>(std::move(X))
+    {
+    }
+
     template<typename T>
     const MatrixExt<T>& MatrixExt<T>::operator=(const Mat<T>& X)
     {
@@ -79,88 +106,102 @@ namespace util
         return *this;
     }
 
+    template<typename T>
+    const MatrixExt<T>& MatrixExt<T>::operator=(const MatrixExt& X)
+    {
+        Mat<T>::operator=(X);
+        return *this;
+    }
+
+    template<typename T>
+    const MatrixExt<T>& MatrixExt<T>::operator=(MatrixExt&& X)
+    {
+        Mat<T>::operator=(std::move(X));
+        return *this;
+    }
+
     template<typename T>
     MatrixExt<T> operator+(const MatrixExt<T>& X, const MatrixExt<T>& Y)
     {
-        return MatrixExt<T>(dynamic_cast<const Mat<T>& >(X) + dynamic_cast<const Mat<T>& >(Y));
+        return MatrixExt<T>(static_cast<const Mat<T>& >(X) + static_cast<const Mat<T>& >(Y));
     }
 
     template<typename T>
     MatrixExt<T> operator-(const MatrixExt<T>& X, const MatrixExt<T>& Y)
     {
-        return MatrixExt<T>(dynamic_cast<const Mat<T>& >(X) - dynamic_cast<const Mat<T>& >(Y));
+        return MatrixExt<T>(static_cast<const Mat<T>& >(X) - static_cast<const Mat<T>& >(Y));
     }
 
     template<typename T>
     MatrixExt<T> operator*(const MatrixExt<T>& X, const MatrixExt<T>& Y)
     {
-        return MatrixExt<T>(dynamic_cast<const Mat<T>& >(X) * dynamic_cast<const Mat<T>& >(Y));
+        return MatrixExt<T>(static_cast<const Mat<T>& >(X) * static_cast<const Mat<T>& >(Y));
     }
 
     template<typename T>
     MatrixExt<T> operator*(const MatrixExt<T>& X, const T& scalar)
     {
-        return MatrixExt<T>(dynamic_cast<const Mat<T>& >(X) * scalar);
+        return MatrixExt<T>(static_cast<const Mat<T>& >(X) * scalar);
     }
 
     template<typename T>
     MatrixExt<T> operator*(const T& scalar, const MatrixExt<T>& X)
     {
-        return MatrixExt<T>(scalar * dynamic_cast<const Mat<T>& >(X));
+        return MatrixExt<T>(scalar * static_cast<const Mat<T>& >(X));
     }
 
     template<typename T>
     MatrixExt<T> operator/(const MatrixExt<T>& X, const MatrixExt<T>& Y)
     {
-        return MatrixExt<T>(dynamic_cast<const Mat<T>& >(X) / dynamic_cast<const Mat<T>& >(Y));
+        return MatrixExt<T>(static_cast<const Mat<T>& >(X) / static_cast<const Mat<T>& >(Y));
     }
 
     template<typename T>
     MatrixExt<T> operator/(const MatrixExt<T>& X, const T& scalar)
     {
-        return MatrixExt<T>(dynamic_cast<const Mat<T>& >(X) / scalar);
+        return MatrixExt<T>(static_cast<const Mat<T>& >(X) / scalar);
     }
 
     template<typename T>
     MatrixExt<T> operator/(const T& scalar, const MatrixExt<T>& X)
     {
-        return MatrixExt<T>(scalar / dynamic_cast<const Mat<T>& >(X));
+        return MatrixExt<T>(scalar / static_cast<const Mat<T>& >(X));
     }
 
     template<typename T>
     umat operator==(const MatrixExt<T>& X, const MatrixExt<T>& Y)
     {
-        return dynamic_cast<const Mat<T>& >(X) == dynamic_cast<const Mat<T>& >(Y);
+        return static_cast<const Mat<T>& >(X) == static_cast<const Mat<T>& >(Y);
     }
 
     template<typename T>
     umat operator!=(const MatrixExt<T>& X, const MatrixExt<T>& Y)
     {
-        return dynamic_cast<const Mat<T>& >(X) != dynamic_cast<const Mat<T>& >(Y);
+        return static_cast<const Mat<T>& >(X) != static_cast<const Mat<T>& >(Y);
     }
 
     template<typename T>
     umat operator>=(const MatrixExt<T>& X, const MatrixExt<T>& Y)
     {
-        return dynamic_cast<const Mat<T>& >(X) >= dynamic_cast<const Mat<T>& >(Y);
+        return static_cast<const Mat<T>& >(X) >= static_cast<const Mat<T>& >(Y);
     }
 
     template<typename T>
     umat operator<=(const MatrixExt<T>& X, const MatrixExt<T>& Y)
     {
-        return dynamic_cast<const Mat<T>& >(X) <= dynamic_cast<const Mat<T>& >(Y);
+        return static_cast<const Mat<T>& >(X) <= static_cast<const Mat<T>& >(Y);
     }
 
     template<typename T>
     umat operator>(const MatrixExt<T>& X, const MatrixExt<T>& Y)
     {
-        return dynamic_cast<const Mat<T>& >(X) > dynamic_cast<const Mat<T>& >(Y);
+        return static_cast<const Mat<T>& >(X) > static_cast<const Mat<T>& >(Y);
     }
 
     template<typename T>
     umat operator<(const MatrixExt<T>& X, const MatrixExt<T>& Y)
     {
-        return dynamic_cast<const Mat<T>& >(X) < dynamic_cast<const Mat<T>& >(Y);
+        return static_cast<const Mat<T>& >(X) < static_cast<const Mat<T>& >(Y);
     }
 
     template<typename T>
@@ -301,18 +342,15 @@ namespace util
             if (x >= this->n_rows || y >= this->n_rows)
                 throw std::range_error("MatrixExt::DoInterchangeOperation(): x and y must be smaller than n_rows");
 
-            Row<T> r(this->row(x));
-            this->row(x) = this->row(y);
-            this->row(y) = r;
+            for (auto j = 0U; j < this->n_cols; ++j)
+                std::swap((*this)(x, j), (*this)(y, j));
         }
         else
         {
             if (x >= this->n_cols || y >= this->n_cols)
                 throw std::range_error("MatrixExt::DoInterchangeOperation(): x and y must be smaller than n_cols");
 
-            Col<T> c(this->col(x));
-            this->col(x) = this->col(y);
-            this->col(y) = c;
+            std::swap_ranges(this->colptr(x), this->colptr(x) + this->n_rows, this->colptr(y));
         }
         return *this;
     }
@@ -328,14 +366,18 @@ namespace util
             if (source >= this->n_rows || target >= this->n_rows)
                 throw std::range_error("MatrixExt::DoSkewingOperation(): source/target row must be smaller than n_rows");
 
-            this->row(target) += MatrixExt<T>(this->row(source)) * scalar;
+            for (auto j = 0U; j < this->n_cols; ++j)
+                (*this)(target, j) += (*this)(source, j) * scalar;
         }
         else
         {
             if (source >= this->n_cols || target >= this->n_cols)
                 throw std::range_error("MatrixExt::DoSkewingOperation(): source/target row must be smaller than n_cols");
 
-            this->col(target) += this->col(source) * scalar;
+            T* target_col(this->colptr(target));
+            const T* source_col(this->colptr(source));
+            for (auto i = 0U; i < this->n_rows; ++i)
+                target_col[i] += source_col[i] * scalar;
         }
         return *this;
     }
@@ -348,28 +390,33 @@ namespace util
         if (S.IsEchelon())
             return S.ComputeRank();
 
-        uword i0 = -1;
-        for (uword j = 0; j < this->n_cols; ++j)
+        /**
+         * Each step of Euclid's algorithm on rows i-1 and i is done on both U and S in a single pass (@see DoEuclidStep()). Matrices are
+         * stored in column-major order, so both rows are adjacent in memory and consecutive elements of a row are n_rows apart. Elements
+         * of S left of column j are zero in both rows, so these are skipped.
+         */
+        const uword n_rows(this->n_rows);
+        uword rank(0);
+        for (uword j = 0; j < this->n_cols && rank < n_rows; ++j)
         {
-            if (i0 < this->n_rows - 1 && !any(S(span(i0 + 1, this->n_rows - 1), j)))
+            if (IsZeroBelow(S, rank, j))
                 continue;
 
-            if (++i0 >= this->n_rows - 1)
-                break;
-
-            for (uword i = this->n_rows - 1; i >= i0 + 1; --i)
+            for (uword i = n_rows - 1; i > rank; --i)
             {
                 while(S(i,j) != T(0))
                 {
 					T multiplier = T(-1) * static_cast<T>(util::signum(S(i - 1, j) * S(i, j)) * std::floor(std::abs(S(i - 1, j)) / std::abs(S(i, j))));
-                    U.DoSkewingOperation(i, i-1, multiplier, true).DoInterchangeOperation(i, i-1, true);
-                    S.DoSkewingOperation(i, i-1, multiplier, true).DoInterchangeOperation(i, i-1, true);
+                    DoEuclidStep(U.memptr() + i - 1, U.memptr() + i, n_rows, n_rows, multiplier);
+                    DoEuclidStep(S.colptr(j) + i - 1, S.colptr(j) + i, n_rows, S.n_cols - j, multiplier);
                 }
             }
+
+            /** Row 'rank' now holds the leading element of column j. */
+            ++rank;
         }
 
-        /** i0 + 1 is the rank of the echelon matrix S. */
-        return i0 + 1;
+        return rank;
     }
 
     template<typename T>
@@ -380,28 +427,32 @@ namespace util
         if (S.IsEchelon())
             return S.ComputeRank();
 
-        uword i0 = -1;
-        for (uword j = 0; j < this->n_cols; ++j)
+        /**
+         * Same as ReduceToEchelon(), except that the inverse operations are applied to the columns of V: column i-1 is added multiplier
+         * times to column i and both are interchanged. Columns are contiguous in memory.
+         */
+        const uword n_rows(this->n_rows);
+        uword rank(0);
+        for (uword j = 0; j < this->n_cols && rank < n_rows; ++j)
         {
-            if (i0 < this->n_rows - 1 && !any(S(span(i0 + 1, this->n_rows - 1), j)))
+            if (IsZeroBelow(S, rank, j))
                 continue;
 
-            if (++i0 >= this->n_rows - 1)
-                break;
-
-            for (uword i = this->n_rows - 1; i >= i0 + 1; --i)
+            for (uword i = n_rows - 1; i > rank; --i)
             {
                 while(S(i,j) != T(0))
                 {
 					T multiplier = static_cast<T>(util::signum(S(i - 1, j) * S(i, j)) * std::floor(std::abs(S(i - 1, j)) / std::abs(S(i, j))));
-                    S.DoSkewingOperation(i, i-1, T(-1) * multiplier, true).DoInterchangeOperation(i, i-1, true);
-                    V.DoSkewingOperation(i-1, i, multiplier, false).DoInterchangeOperation(i, i-1, false);
+                    DoEuclidStep(S.colptr(j) + i - 1, S.colptr(j) + i, n_rows, S.n_cols - j, T(-1) * multiplier);
+                    DoEuclidStep(V.colptr(i), V.colptr(i - 1), 1, n_rows, multiplier);
                 }
             }
+
+            /** Row 'rank' now holds the leading element of column j. */
+            ++rank;
         }
 
-        /** i0 + 1 is the rank of the echelon matrix S. */
-        return i0 + 1;
+        return rank;
     }
 
     template<typename T>
@@ -500,6 +551,17 @@ namespace util
         } while(k < smaller_dim);
     }
 
+	template<typename T>
+	bool MatrixExt<T>::InvertUnimodular(MatrixExt<T>& inverse) const
+	{
+		if (this->n_rows != this->n_cols)
+			return false;
+
+		MatrixExt<T> U(this->n_rows, this->n_rows), S(this->n_rows, this->n_cols);
+		const uword rank_s(ReduceToEchelon(U, S));
+		inverse.set_size(this->n_rows, this->n_rows);
+		return InvertFromEchelon(S, rank_s, U, inverse);
+	}
 
     template class MatrixExt<int>;
     template MatrixExt<int> operator+<int>(const MatrixExt<int>& X, const MatrixExt<int>& Y);
@@ -112,8 +112,30 @@ namespace util
         MatrixExt(const Mat<T>& X);
         MatrixExt(const std::initializer_list<std::initializer_list<T> >& X);
         MatrixExt(Mat<T>&& X);
+        MatrixExt(const MatrixExt& X);
+        MatrixExt(MatrixExt&& X);
+
+		/**
+		 * @brief Evaluates delayed armadillo expression X (for instance product of two submatrices) directly into this instance,
+		 * without materializing it into a temporary Mat<T> first.
+		 */
+		template<typename T1>
+		MatrixExt(const Base<T, T1>& X) : Mat<T>(X.get_ref())
+		{
+		}
+
         const MatrixExt& operator=(const Mat<T>& X);
         const MatrixExt& operator=(const std::initializer_list<std::initializer_list<T> >& X);
+        const MatrixExt& operator=(const MatrixExt& X);
+        const MatrixExt& operator=(MatrixExt&& X);
+
+		template<typename T1>
+		const MatrixExt& operator=(const Base<T, T1>& X)
+		{
+			Mat<T>::operator=(X.get_ref());
+			return *this;
+		}
+
         virtual ~MatrixExt()
         {
         }
@@ -266,9 +288,68 @@ namespace util
          * @see Loop Transformations for Restructuring Compilers, The Foundations (Algorithm 2.3)
          */
         void ReduceToDiagonal(MatrixExt& U, MatrixExt& V, MatrixExt& D) const;
+
+        /**
+         * @brief Calculates exact inverse of this instance if it is a unimodular matrix. Inverse is derived from the echelon reduction
+         * UA = S (see ReduceToEchelon()) by back substitution, without leaving the element type (see InvertFromEchelon()).
+         *
+         * @retval FALSE if this instance is not a square unimodular matrix (inverse is left unspecified in that case).
+         */
+        bool InvertUnimodular(MatrixExt& inverse) const;
     };
 
 
+	/**
+	 * @brief Completes the inverse of square matrix A from its echelon reduction UA = S of rank rank_s. A is unimodular IFF S is upper
+	 * triangular with +1 or -1 on the main diagonal, and then A^-1 = S^-1 * U. It is calculated by back substitution over the columns
+	 * of U, where division by a diagonal element of S is the same as multiplying by it. Therefore, the result is exact. Inverse must
+	 * already have the dimensions of U.
+	 *
+	 * @retval FALSE if A is not unimodular (inverse is left unspecified in that case).
+	 */
+	template<typename EchelonMatrix, typename UnimodularMatrix>
+	bool InvertFromEchelon(const EchelonMatrix& S, const uword rank_s, const UnimodularMatrix& U, UnimodularMatrix& inverse)
+	{
+		typedef typename std::decay<decltype(U(0, 0))>::type T;
+		const uword m(U.n_rows);
+		if (S.n_rows != m || S.n_cols != m || rank_s != m)
+			return false;
+
+		for (uword i = 0; i < m; ++i)
+		{
+			if (S(i, i) != T(1) && S(i, i) != T(-1))
+				return false;
+		}
+
+		for (uword col = 0; col < m; ++col)
+		{
+			for (uword i = m; i-- > 0;)
+			{
+				T sum(U(i, col));
+				for (uword k = i + 1; k < m; ++k)
+					sum -= S(i, k) * inverse(k, col);
+				inverse(i, col) = sum * S(i, i);
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Fused step of Euclid's algorithm used by echelon reductions. Pair of rows (or columns) x and y, given by pointers to their
+	 * first elements and the distance between their consecutive elements, is replaced by pair (y, x + multiplier * y). This is the same
+	 * as skewing operation (x += multiplier * y) followed by interchange of x and y, but done in a single pass without temporaries.
+	 */
+	template<typename T>
+	inline void DoEuclidStep(T* x, T* y, const uword stride, const uword count, const T multiplier)
+	{
+		for (uword k = 0; k < count; ++k, x += stride, y += stride)
+		{
+			const T x_old(*x), y_old(*y);
+			*x = y_old;
+			*y = x_old + multiplier * y_old;
+		}
+	}
+
 	template<typename T>
 	typename std::enable_if<std::is_integral<T>::value, bool>::type Equal(const MatrixExt<T>& X, const MatrixExt<T>& Y)
 	{
@@ -0,0 +1,310 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "normal_form.h"
+#include "checked_arithmetic.h"
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <vector>
+
+namespace gap
+{
+namespace util
+{
+
+namespace
+{
+
+	/** Returns a * x + b * y. @throw std::overflow_error if the result doesn't fit into long long. */
+	long long CheckedCombination(long long a, long long x, long long b, long long y)
+	{
+		long long ax, by, sum;
+		if (MulOverflow(a, x, ax) || MulOverflow(b, y, by) || AddOverflow(ax, by, sum))
+			throw std::overflow_error("CheckedCombination(): element of the normal form doesn't fit into long long");
+		return sum;
+	}
+
+	/** Returns g = GCD(a, b) >= 0 and calculates coefficients x and y such that x * a + y * b = g (extended Euclid's algorithm). */
+	long long ExtendedGcd(long long a, long long b, long long& x, long long& y)
+	{
+		long long old_r(a), r(b), old_x(1), cur_x(0), old_y(0), cur_y(1);
+		while (r != 0)
+		{
+			const long long q(old_r / r);
+			long long tmp(old_r - q * r);
+			old_r = r;
+			r = tmp;
+			tmp = old_x - q * cur_x;
+			old_x = cur_x;
+			cur_x = tmp;
+			tmp = old_y - q * cur_y;
+			old_y = cur_y;
+			cur_y = tmp;
+		}
+
+		if (old_r < 0)
+		{
+			old_r = -old_r;
+			old_x = -old_x;
+			old_y = -old_y;
+		}
+		x = old_x;
+		y = old_y;
+		return old_r;
+	}
+
+	/** Returns floor(a / b) for b > 0. */
+	long long FloorDivide(long long a, long long b)
+	{
+		long long q(a / b);
+		if (a % b < 0)
+			--q;
+		return q;
+	}
+
+	/**
+	 * Replaces rows r and i of matrix X with x * row_r + y * row_i and p * row_r + q * row_i. Elements left of column first_col are
+	 * skipped (caller knows that these are zero in both rows).
+	 */
+	void TransformRows(MatrixExt<long long>& X, uword r, uword i, long long x, long long y, long long p, long long q, uword first_col)
+	{
+		for (auto col = first_col; col < X.n_cols; ++col)
+		{
+			const long long x_r(X(r, col)), x_i(X(i, col));
+			X(r, col) = CheckedCombination(x, x_r, y, x_i);
+			X(i, col) = CheckedCombination(p, x_r, q, x_i);
+		}
+	}
+
+	/** Adds factor * row_source to row_target of matrix X, starting from column first_col. */
+	void AddRowMultiple(MatrixExt<long long>& X, uword target, uword source, long long factor, uword first_col)
+	{
+		for (auto col = first_col; col < X.n_cols; ++col)
+			X(target, col) = CheckedCombination(1, X(target, col), factor, X(source, col));
+	}
+
+	/** Adds factor * col_source to col_target of matrix X, starting from row first_row. */
+	void AddColMultiple(MatrixExt<long long>& X, uword target, uword source, long long factor, uword first_row)
+	{
+		for (auto row = first_row; row < X.n_rows; ++row)
+			X(row, target) = CheckedCombination(1, X(row, target), factor, X(row, source));
+	}
+
+	/**
+	 * Zeroes element H(i, j) with an extended GCD step on rows r and i, which leaves GCD(H(r, j), H(i, j)) in H(r, j). The same row
+	 * operation is performed on U. Elements of rows r and i left of column j must be zero. If H(r, j) is zero, rows are interchanged and
+	 * if it divides H(i, j), row r is left unchanged and a multiple of it is subtracted from row i.
+	 */
+	void EliminateRowElement(MatrixExt<long long>& H, MatrixExt<long long>& U, uword r, uword i, uword j)
+	{
+		const long long a(H(r, j)), b(H(i, j));
+		if (a == 0)
+		{
+			H.DoInterchangeOperation(r, i, true);
+			U.DoInterchangeOperation(r, i, true);
+			return;
+		}
+		if (b % a == 0)
+		{
+			AddRowMultiple(H, i, r, -(b / a), j);
+			AddRowMultiple(U, i, r, -(b / a), 0);
+			return;
+		}
+
+		long long x, y;
+		const long long g(ExtendedGcd(a, b, x, y));
+		TransformRows(H, r, i, x, y, -(b / g), a / g, j);
+		TransformRows(U, r, i, x, y, -(b / g), a / g, 0);
+	}
+
+	/** Returns the column of the first non-zero element of row r of matrix X, or X.n_cols if the row is zero. */
+	uword FindLeadingColumn(const MatrixExt<long long>& X, uword r)
+	{
+		uword col(0);
+		while (col < X.n_cols && X(r, col) == 0)
+			++col;
+		return col;
+	}
+
+	/**
+	 * Makes pivots of rows 0,..., pivot_cols.size()-1 of H positive and reduces elements above every pivot to range [0, pivot). Pivots
+	 * are processed from left to right, since reduction by pivot t changes only the columns right of pivot_cols[t] in the rows above it.
+	 */
+	void ReduceAbovePivots(MatrixExt<long long>& H, MatrixExt<long long>& U, const std::vector<uword>& pivot_cols)
+	{
+		for (auto t = 0U; t < pivot_cols.size(); ++t)
+		{
+			const uword col(pivot_cols[t]);
+			if (H(t, col) < 0)
+			{
+				H.DoReversalOperation(t, true);
+				U.DoReversalOperation(t, true);
+			}
+
+			for (auto k = 0U; k < t; ++k)
+			{
+				const long long factor(FloorDivide(H(k, col), H(t, col)));
+				if (factor != 0)
+				{
+					AddRowMultiple(H, k, t, -factor, col);
+					AddRowMultiple(U, k, t, -factor, 0);
+				}
+			}
+		}
+	}
+
+	/** Reduces H to its Hermite normal form in place, performing the same row operations on U. @retval Rank of H. */
+	uword ReduceToHermiteForm(MatrixExt<long long>& H, MatrixExt<long long>& U)
+	{
+		/** Rows 0,..., rank-1 are in Hermite normal form, pivot_cols[t] is the pivot column of row t. Rows rank,..., i-1 are zero. */
+		std::vector<uword> pivot_cols;
+		uword rank(0);
+		for (auto i = 0U; i < H.n_rows; ++i)
+		{
+			if (i != rank)
+			{
+				H.DoInterchangeOperation(rank, i, true);
+				U.DoInterchangeOperation(rank, i, true);
+			}
+
+			/** Eliminate the new row against the pivots until it has an element in a column that has no pivot. */
+			uword t(0);
+			uword lead(FindLeadingColumn(H, rank));
+			for (; t < rank && lead >= pivot_cols[t]; ++t)
+			{
+				if (lead == pivot_cols[t])
+				{
+					EliminateRowElement(H, U, t, rank, lead);
+					lead = FindLeadingColumn(H, rank);
+				}
+			}
+
+			/** Unless it was eliminated completely, new row becomes the pivot row t and rows below it are moved down by one. */
+			if (lead < H.n_cols)
+			{
+				for (auto k = rank; k > t; --k)
+				{
+					H.DoInterchangeOperation(k, k - 1, true);
+					U.DoInterchangeOperation(k, k - 1, true);
+				}
+				pivot_cols.insert(pivot_cols.begin() + t, lead);
+				++rank;
+			}
+
+			/** Elimination steps changed the pivot rows, so they have to be reduced again. */
+			ReduceAbovePivots(H, U, pivot_cols);
+		}
+
+		return rank;
+	}
+
+	/** Same as ReduceToHermiteForm() with column operations: D becomes lower echelon matrix, V collects column operations. */
+	void ReduceColumnsToHermiteForm(MatrixExt<long long>& D, MatrixExt<long long>& V)
+	{
+		MatrixExt<long long> D_t(Mat<long long>(D.t())), V_t(Mat<long long>(V.t()));
+		ReduceToHermiteForm(D_t, V_t);
+		D = D_t.t();
+		V = V_t.t();
+	}
+
+	/**
+	 * Finds diagonal elements D(i, i) and D(j, j), i < j, such that D(i, i) doesn't divide D(j, j). Diagonal elements have to be
+	 * non-negative. Returns FALSE if every non-zero diagonal element divides the next one.
+	 */
+	bool FindIndivisiblePair(const MatrixExt<long long>& D, uword& i, uword& j)
+	{
+		const uword smaller_dim(std::min(D.n_rows, D.n_cols));
+		for (i = 0; i < smaller_dim && D(i, i) != 0; ++i)
+		{
+			for (j = i + 1; j < smaller_dim && D(j, j) != 0; ++j)
+			{
+				if (D(j, j) % D(i, i) != 0)
+					return true;
+			}
+		}
+		return false;
+	}
+
+} /// unnamed namespace
+
+	uword ComputeHermiteNormalForm(const MatrixExt<long long>& A, MatrixExt<long long>& U, MatrixExt<long long>& H)
+	{
+		U.eye(A.n_rows, A.n_rows);
+		H = A;
+		return ReduceToHermiteForm(H, U);
+	}
+
+	uword ComputeSmithNormalForm(const MatrixExt<long long>& A, MatrixExt<long long>& U, MatrixExt<long long>& V, MatrixExt<long long>& D)
+	{
+		U.eye(A.n_rows, A.n_rows);
+		V.eye(A.n_cols, A.n_cols);
+		D = A;
+
+		/**
+		 * Row and column Hermite forms are computed alternately until D becomes diagonal. Since both of them reduce the elements off the
+		 * diagonal modulo the pivots, entries of D stay bounded by the pivots, which only decrease.
+		 */
+		uword rank(0);
+		for (;;)
+		{
+			rank = ReduceToHermiteForm(D, U);
+			if (D.IsDiagonal())
+			{
+				/** Column j is added to column i if D(i, i) doesn't divide D(j, j), which makes the next row reduction compute their GCD. */
+				uword i, j;
+				if (!FindIndivisiblePair(D, i, j))
+					break;
+
+				D(j, i) = D(j, j);
+				AddColMultiple(V, i, j, 1, 0);
+				continue;
+			}
+
+			ReduceColumnsToHermiteForm(D, V);
+		}
+
+		return rank;
+	}
+
+	uword ReduceToEchelon(const MatrixExt<long long>& A, MatrixExt<long long>& U, MatrixExt<long long>& S, EchelonAlgorithm algorithm)
+	{
+		if (algorithm == ECHELON_HERMITE)
+			return ComputeHermiteNormalForm(A, U, S);
+
+		return A.ReduceToEchelon(U, S);
+	}
+
+} /// namespace util
+} /// namespace gap
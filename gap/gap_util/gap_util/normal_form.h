@@ -0,0 +1,94 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef GAP_UTIL_NORMAL_FORM_H
+#define GAP_UTIL_NORMAL_FORM_H
+
+#include "matrix_ext.h"
+
+namespace gap
+{
+namespace util
+{
+
+	/** Algorithms that can be used to reduce integer matrix to echelon form UA = S. */
+	enum EchelonAlgorithm
+	{
+		ECHELON_EUCLID = 0		/** MatrixExt::ReduceToEchelon() - repeated Euclid steps on adjacent rows. */
+		, ECHELON_HERMITE		/** ComputeHermiteNormalForm() - extended GCD steps with reduction above pivots. */
+	};
+
+	/**
+	 * @brief Reduces (m x n) integer matrix A to its Hermite Normal Form H, calculating (m x m) unimodular matrix U such that UA = H.
+	 * Matrix H is echelon matrix (so it can be used anywhere the result of MatrixExt::ReduceToEchelon() is expected) and additionally:
+	 *
+	 * 1) the leading (pivot) element of every non-zero row is positive,
+	 * 2) elements above the pivot are reduced modulo the pivot, so 0 <= H(k, j) < H(r, j) for k < r when H(r, j) is the pivot of row r.
+	 *
+	 * Following Kannan and Bachem, rows of A are added one at a time to the Hermite form of the rows before them. New row is eliminated
+	 * against every pivot in one extended GCD step: rows r and i are replaced by x * row_r + y * row_i and -(b / g) * row_r + (a / g) * row_i
+	 * where a and b are their elements in the pivot column and g = GCD(a, b) = x * a + y * b (determinant of this transformation is 1).
+	 * Elements above all pivots are reduced after every row, which keeps intermediate entries of H and U bounded by the pivots instead of
+	 * letting them grow with the number of steps, as in MatrixExt::ReduceToEchelon().
+	 *
+	 * @retval Rank of matrix H (number of non-zero rows).
+	 *
+	 * @throw std::overflow_error if an element of U or H doesn't fit into long long
+	 * @see R. Kannan, A. Bachem, Polynomial Algorithms for Computing the Smith and Hermite Normal Forms of an Integer Matrix (1979)
+	 */
+	uword ComputeHermiteNormalForm(const MatrixExt<long long>& A, MatrixExt<long long>& U, MatrixExt<long long>& H);
+
+	/**
+	 * @brief Reduces (m x n) integer matrix A to its Smith Normal Form D, calculating (m x m) unimodular matrix U and (n x n) unimodular
+	 * matrix V such that UAV = D. Matrix D is diagonal with non-negative elements d1, d2,..., dr (r is the rank of A) where every element
+	 * di divides d(i+1), which is not guaranteed by MatrixExt::ReduceToDiagonal().
+	 *
+	 * Row and column Hermite normal forms are computed alternately until D becomes diagonal (Kannan and Bachem). If some diagonal element
+	 * doesn't divide the next one, column of the latter is added to the column of the former and the reduction is repeated, which replaces
+	 * the former with their GCD.
+	 *
+	 * @retval Rank of matrix D (number of non-zero diagonal elements).
+	 *
+	 * @throw std::overflow_error if an element of U, V or D doesn't fit into long long
+	 * @see R. Kannan, A. Bachem, Polynomial Algorithms for Computing the Smith and Hermite Normal Forms of an Integer Matrix (1979)
+	 */
+	uword ComputeSmithNormalForm(const MatrixExt<long long>& A, MatrixExt<long long>& U, MatrixExt<long long>& V, MatrixExt<long long>& D);
+
+	/** Reduces A to echelon form UA = S using the given algorithm. @retval Rank of matrix S. */
+	uword ReduceToEchelon(const MatrixExt<long long>& A, MatrixExt<long long>& U, MatrixExt<long long>& S, EchelonAlgorithm algorithm);
+
+} /// namespace util
+} /// namespace gap
+
+#endif /// GAP_UTIL_NORMAL_FORM_H
@@ -0,0 +1,610 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "omega_elimination.h"
+#include "diophantine.h"
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cstdlib>
+
+namespace gap
+{
+namespace util
+{
+
+namespace
+{
+	/** Single constraint a * x <= c, or a * x = c when it is part of the equalities. */
+	struct Constraint
+	{
+		std::vector<long long> a;
+		long long c;
+	};
+
+	/**
+	 * System of constraints over var_cnt variables. Eliminated variables are not removed, their coefficients are simply zero in every
+	 * constraint, so that variable indexes stay valid during the whole elimination process.
+	 */
+	struct Problem
+	{
+		std::size_t var_cnt;
+		std::vector<Constraint> ineqs;
+		std::vector<Constraint> eqs;
+	};
+
+	long long CheckedAdd(long long x, long long y)
+	{
+		if ((y > 0 && x > std::numeric_limits<long long>::max() - y) || (y < 0 && x < std::numeric_limits<long long>::min() - y))
+			throw std::overflow_error("c2cuda::OmegaTest(): integer overflow during elimination");
+		return x + y;
+	}
+
+	long long CheckedMul(long long x, long long y)
+	{
+		bool overflow(false);
+		if (x > 0)
+			overflow = y > 0 ? x > std::numeric_limits<long long>::max() / y : y < std::numeric_limits<long long>::min() / x;
+		else if (x < 0)
+			overflow = y > 0 ? x < std::numeric_limits<long long>::min() / y : y != 0 && x < std::numeric_limits<long long>::max() / y;
+
+		if (overflow)
+			throw std::overflow_error("c2cuda::OmegaTest(): integer overflow during elimination");
+		return x * y;
+	}
+
+	long long Gcd(long long a, long long b)
+	{
+		a = std::abs(a);
+		b = std::abs(b);
+		while (b != 0)
+		{
+			long long r(a % b);
+			a = b;
+			b = r;
+		}
+		return a;
+	}
+
+	/** Rounds x / y towards -oo, y must be positive. */
+	long long FloorDiv(long long x, long long y)
+	{
+		long long q(x / y);
+		return (x % y != 0 && x < 0) ? q - 1 : q;
+	}
+
+	void ValidateArguments(const MatrixExt<long long>& A, const RowVector<long long>& c)
+	{
+		if (A.n_rows == 0 || A.n_cols == 0 || A.n_cols != c.n_cols)
+			throw std::logic_error("c2cuda::OmegaTest(): A.n_rows and A.n_cols cannot be zero and A.n_cols must be equal to c.n_cols");
+	}
+
+	/** Forms the problem from the system xA <= c, every column of A is a single inequality. */
+	Problem FormProblem(const MatrixExt<long long>& A, const RowVector<long long>& c)
+	{
+		Problem p{ A.n_rows, {}, {} };
+		p.ineqs.reserve(A.n_cols);
+		for (auto j = 0U; j < A.n_cols; ++j)
+		{
+			Constraint ineq{ std::vector<long long>(A.n_rows), c(j) };
+			for (auto i = 0U; i < A.n_rows; ++i)
+				ineq.a[i] = A(i, j);
+			p.ineqs.push_back(std::move(ineq));
+		}
+		return p;
+	}
+
+	Constraint UnitConstraint(std::size_t var_cnt, std::size_t var, long long coefficient, long long c)
+	{
+		Constraint con{ std::vector<long long>(var_cnt), c };
+		con.a[var] = coefficient;
+		return con;
+	}
+
+	/**
+	 * Step 1 of OmegaTest(). Inequalities are divided by the GCD of their coefficients, inequalities without variables are checked, and
+	 * duplicates are merged. If detect_equalities is TRUE, pairs of opposite inequalities that enclose a single value are turned into
+	 * equalities. Returns FALSE if the system is proven to have no integer solution.
+	 */
+	bool Normalize(Problem& p, bool detect_equalities)
+	{
+		std::vector<Constraint> eqs;
+		for (auto & eq : p.eqs)
+		{
+			long long g(0);
+			for (auto coeff : eq.a)
+				g = Gcd(g, coeff);
+
+			if (g == 0)
+			{
+				if (eq.c != 0)
+					return false;
+				continue;
+			}
+
+			if (eq.c % g != 0)
+				return false;
+
+			for (auto & coeff : eq.a)
+				coeff /= g;
+			eq.c /= g;
+			eqs.push_back(std::move(eq));
+		}
+
+		std::map<std::vector<long long>, long long> tightest;
+		for (auto & ineq : p.ineqs)
+		{
+			long long g(0);
+			for (auto coeff : ineq.a)
+				g = Gcd(g, coeff);
+
+			if (g == 0)
+			{
+				if (ineq.c < 0)
+					return false;
+				continue;
+			}
+
+			for (auto & coeff : ineq.a)
+				coeff /= g;
+			ineq.c = FloorDiv(ineq.c, g);
+
+			auto entry = tightest.find(ineq.a);
+			if (entry == tightest.end())
+				tightest.emplace(std::move(ineq.a), ineq.c);
+			else if (ineq.c < entry->second)
+				entry->second = ineq.c;
+		}
+
+		p.ineqs.clear();
+		for (auto & entry : tightest)
+		{
+			std::vector<long long> negated(entry.first);
+			for (auto & coeff : negated)
+				coeff = CheckedMul(coeff, -1);
+
+			auto opposite = tightest.find(negated);
+			if (opposite != tightest.end())
+			{
+				/** a * x <= c and -a * x <= d, so -d <= a * x <= c. */
+				if (CheckedAdd(entry.second, opposite->second) < 0)
+					return false;
+
+				if (detect_equalities && entry.second == -opposite->second)
+				{
+					/** Both inequalities are visited, equality is added only once. */
+					if (entry.first < negated)
+						eqs.push_back({ entry.first, entry.second });
+					continue;
+				}
+			}
+			p.ineqs.push_back({ entry.first, entry.second });
+		}
+
+		p.eqs = std::move(eqs);
+		return true;
+	}
+
+	/**
+	 * Step 2 of OmegaTest(). Eliminates the last equality of the problem. The equality must be normalized, which means that its coefficients'
+	 * GCD is 1 and there is an integer solution.
+	 */
+	void EliminateEquality(Problem& p)
+	{
+		Constraint eq(std::move(p.eqs.back()));
+		p.eqs.pop_back();
+
+		std::size_t k(p.var_cnt);
+		for (auto i = 0U; i < p.var_cnt; ++i)
+			if (eq.a[i] != 0 && (k == p.var_cnt || std::abs(eq.a[i]) < std::abs(eq.a[k])))
+				k = i;
+
+		if (std::abs(eq.a[k]) == 1)
+		{
+			/** xk = sign * (c - sum(ai * xi)) where i != k. */
+			long long sign(eq.a[k]);
+			auto substitute = [&](Constraint& con)
+			{
+				long long factor(CheckedMul(con.a[k], sign));
+				for (auto i = 0U; i < p.var_cnt; ++i)
+					if (i != k)
+						con.a[i] = CheckedAdd(con.a[i], -CheckedMul(factor, eq.a[i]));
+				con.c = CheckedAdd(con.c, -CheckedMul(factor, eq.c));
+				con.a[k] = 0;
+			};
+
+			for (auto & ineq : p.ineqs)
+				substitute(ineq);
+			for (auto & other_eq : p.eqs)
+				substitute(other_eq);
+			return;
+		}
+
+		/**
+		 * General solution of the equality is x = tU where t = (t1, t2, ..., tm), t1 is determined and the rest are free. Constraint a * x <= c
+		 * becomes (U * a^T)^T * t <= c where the first component of t is moved to the right-hand side. Free components of t take the place of
+		 * the original variables, variable x1 is replaced by the determined component and its coefficients are set to zero.
+		 */
+		MatrixExt<long long> U(p.var_cnt, p.var_cnt);
+		long long t1;
+		SolveDiophantineEquation(ColVector<long long>(eq.a), eq.c, U, t1);
+
+		auto substitute = [&](Constraint& con)
+		{
+			std::vector<long long> transformed(p.var_cnt);
+			for (auto r = 0U; r < p.var_cnt; ++r)
+				for (auto i = 0U; i < p.var_cnt; ++i)
+					transformed[r] = CheckedAdd(transformed[r], CheckedMul(U(r, i), con.a[i]));
+
+			con.c = CheckedAdd(con.c, -CheckedMul(t1, transformed[0]));
+			transformed[0] = 0;
+			con.a = std::move(transformed);
+		};
+
+		for (auto & ineq : p.ineqs)
+			substitute(ineq);
+		for (auto & other_eq : p.eqs)
+			substitute(other_eq);
+	}
+
+	/**
+	 * Eliminates variable xk by combining each of its upper bounds a * xk <= alpha with each of its lower bounds beta <= b * xk. Produces
+	 * the real shadow or, if dark is TRUE, the dark shadow of the problem (see OmegaTest()).
+	 */
+	Problem Shadow(const Problem& p, std::size_t k, bool dark)
+	{
+		Problem shadow{ p.var_cnt, {}, {} };
+		for (auto & upper : p.ineqs)
+		{
+			if (upper.a[k] == 0)
+				shadow.ineqs.push_back(upper);
+			if (upper.a[k] <= 0)
+				continue;
+
+			for (auto & lower : p.ineqs)
+			{
+				if (lower.a[k] >= 0)
+					continue;
+
+				long long a(upper.a[k]), b(-lower.a[k]);
+				Constraint combined{ std::vector<long long>(p.var_cnt), CheckedAdd(CheckedMul(b, upper.c), CheckedMul(a, lower.c)) };
+				for (auto i = 0U; i < p.var_cnt; ++i)
+					combined.a[i] = CheckedAdd(CheckedMul(b, upper.a[i]), CheckedMul(a, lower.a[i]));
+
+				if (dark)
+					combined.c = CheckedAdd(combined.c, -CheckedMul(a - 1, b - 1));
+				shadow.ineqs.push_back(std::move(combined));
+			}
+		}
+		return shadow;
+	}
+
+	/** Removes every inequality in which variable xk appears. */
+	void DropVariable(Problem& p, std::size_t k)
+	{
+		std::vector<Constraint> kept;
+		for (auto & ineq : p.ineqs)
+			if (ineq.a[k] == 0)
+				kept.push_back(std::move(ineq));
+		p.ineqs = std::move(kept);
+	}
+
+	/** Counts lower (negative coefficient) and upper (positive coefficient) bounds of variable xk. */
+	void CountBounds(const Problem& p, std::size_t k, std::size_t& lower_cnt, std::size_t& upper_cnt, bool& is_exact)
+	{
+		bool unit_lower(true), unit_upper(true);
+		lower_cnt = upper_cnt = 0;
+		for (auto & ineq : p.ineqs)
+		{
+			if (ineq.a[k] < 0)
+			{
+				++lower_cnt;
+				unit_lower = unit_lower && ineq.a[k] == -1;
+			}
+			else if (ineq.a[k] > 0)
+			{
+				++upper_cnt;
+				unit_upper = unit_upper && ineq.a[k] == 1;
+			}
+		}
+		is_exact = unit_lower || unit_upper;
+	}
+
+	/** Decides if the problem has an integer solution, see OmegaTest() for the description of the steps. */
+	bool Solve(Problem p)
+	{
+		for (;;)
+		{
+			if (!Normalize(p, true))
+				return false;
+			if (p.eqs.empty())
+				break;
+			EliminateEquality(p);
+		}
+
+		/** Choose the variable to eliminate, preferring exact eliminations and then the smallest number of combined pairs. */
+		std::size_t k(p.var_cnt), min_pairs(0);
+		bool k_is_exact(false);
+		for (auto i = 0U; i < p.var_cnt; ++i)
+		{
+			std::size_t lower_cnt, upper_cnt;
+			bool is_exact;
+			CountBounds(p, i, lower_cnt, upper_cnt, is_exact);
+			if (lower_cnt == 0 && upper_cnt == 0)
+				continue;
+
+			if (lower_cnt == 0 || upper_cnt == 0)
+			{
+				/** Variable is unbounded in one direction so inequalities containing it can always be satisfied. */
+				DropVariable(p, i);
+				return Solve(std::move(p));
+			}
+
+			if (k == p.var_cnt || (is_exact && !k_is_exact) || (is_exact == k_is_exact && lower_cnt * upper_cnt < min_pairs))
+			{
+				k = i;
+				k_is_exact = is_exact;
+				min_pairs = lower_cnt * upper_cnt;
+			}
+		}
+
+		/** Normalization has removed every inequality without variables. */
+		if (k == p.var_cnt)
+			return true;
+
+		if (k_is_exact)
+			return Solve(Shadow(p, k, false));
+
+		if (!Solve(Shadow(p, k, false)))
+			return false;
+		if (Solve(Shadow(p, k, true)))
+			return true;
+
+		/** Integer solution, if any, lies close to one of the lower bounds of xk. Try every splinter. */
+		long long a_max(0);
+		for (auto & ineq : p.ineqs)
+			a_max = std::max(a_max, ineq.a[k]);
+
+		for (auto & lower : p.ineqs)
+		{
+			if (lower.a[k] >= 0)
+				continue;
+
+			long long b(-lower.a[k]);
+			long long last(FloorDiv(CheckedAdd(CheckedMul(a_max, b), -CheckedAdd(a_max, b)), a_max));
+			for (long long i = 0; i <= last; ++i)
+			{
+				/** -b * xk + r * x <= c is lower bound beta = r * x - c <= b * xk, so b * xk = beta + i is -b * xk + r * x = c - i. */
+				Problem splinter(p);
+				splinter.eqs.push_back({ lower.a, CheckedAdd(lower.c, -i) });
+				if (Solve(std::move(splinter)))
+					return true;
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * Finds the range of xk over the REAL solutions of the normalized problem (with integer tightening of every inequality) by eliminating
+	 * every other variable. Returns FALSE if the range is empty.
+	 */
+	bool ProjectOnto(Problem p, std::size_t k, long long& lower, long long& upper)
+	{
+		for (;;)
+		{
+			if (!Normalize(p, false))
+				return false;
+
+			std::size_t j(p.var_cnt), min_pairs(0);
+			for (auto i = 0U; i < p.var_cnt; ++i)
+			{
+				std::size_t lower_cnt, upper_cnt;
+				bool is_exact;
+				if (i == k)
+					continue;
+
+				CountBounds(p, i, lower_cnt, upper_cnt, is_exact);
+				if (lower_cnt == 0 && upper_cnt == 0)
+					continue;
+				if (j == p.var_cnt || lower_cnt * upper_cnt < min_pairs)
+				{
+					j = i;
+					min_pairs = lower_cnt * upper_cnt;
+				}
+			}
+
+			if (j == p.var_cnt)
+				break;
+
+			if (min_pairs == 0)
+				DropVariable(p, j);
+			else
+				p = Shadow(p, j, false);
+		}
+
+		/** Only inequalities xk <= c and -xk <= c are left after normalization. */
+		bool has_lower(false), has_upper(false);
+		lower = std::numeric_limits<long long>::min();
+		upper = std::numeric_limits<long long>::max();
+		for (auto & ineq : p.ineqs)
+		{
+			if (ineq.a[k] > 0)
+			{
+				upper = std::min(upper, ineq.c);
+				has_upper = true;
+			}
+			else
+			{
+				lower = std::max(lower, -ineq.c);
+				has_lower = true;
+			}
+		}
+
+		if (!has_lower || !has_upper)
+			throw std::logic_error("c2cuda::FindIntegerBounds(): solution set is infinite");
+		return lower <= upper;
+	}
+
+	/** Returns the value in the middle of [lo, hi] (lo < hi), rounded towards lo. Computed modulo 2^64 so that hi - lo doesn't overflow. */
+	long long LowerMidpoint(long long lo, long long hi)
+	{
+		const unsigned long long half((static_cast<unsigned long long>(hi) - static_cast<unsigned long long>(lo)) / 2);
+		return static_cast<long long>(static_cast<unsigned long long>(lo) + half);
+	}
+
+	/** Returns the value in the middle of [lo, hi] (lo < hi), rounded towards hi. */
+	long long UpperMidpoint(long long lo, long long hi)
+	{
+		const unsigned long long half((static_cast<unsigned long long>(hi) - static_cast<unsigned long long>(lo)) / 2);
+		return static_cast<long long>(static_cast<unsigned long long>(hi) - half);
+	}
+
+	/** Calculates exact integer bounds of xk. Problem must have an integer solution. */
+	void BoundVariable(const Problem& p, std::size_t k, long long& lower, long long& upper)
+	{
+		long long real_lower(0), real_upper(0);
+		if (!ProjectOnto(p, k, real_lower, real_upper))
+			throw std::logic_error("c2cuda::BoundVariable(): problem doesn't have a solution");
+
+		/** Smallest v such that the problem extended with xk <= v is feasible. */
+		long long lo(real_lower), hi(real_upper);
+		while (lo < hi)
+		{
+			long long mid(LowerMidpoint(lo, hi));
+			Problem bounded(p);
+			bounded.ineqs.push_back(UnitConstraint(p.var_cnt, k, 1, mid));
+			if (Solve(std::move(bounded)))
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		lower = lo;
+
+		/** Largest v such that the problem extended with xk >= v is feasible. */
+		hi = real_upper;
+		while (lo < hi)
+		{
+			long long mid(UpperMidpoint(lo, hi));
+			Problem bounded(p);
+			bounded.ineqs.push_back(UnitConstraint(p.var_cnt, k, -1, -mid));
+			if (Solve(std::move(bounded)))
+				lo = mid;
+			else
+				hi = mid - 1;
+		}
+		upper = hi;
+	}
+
+	/** Replaces variable xk by the given value in every constraint. */
+	Problem Substitute(const Problem& p, std::size_t k, long long value)
+	{
+		Problem substituted(p);
+		for (auto & ineq : substituted.ineqs)
+		{
+			ineq.c = CheckedAdd(ineq.c, -CheckedMul(ineq.a[k], value));
+			ineq.a[k] = 0;
+		}
+		return substituted;
+	}
+
+	bool EnumerateHelper(
+		const Problem& p,
+		std::size_t current_variable,
+		RowVector<long long>& solution,
+		const IntegerSolutionVisitor& visitor,
+		bool& found)
+	{
+		if (!Solve(p))
+			return true;
+
+		if (current_variable == p.var_cnt)
+		{
+			found = true;
+			return visitor(solution);
+		}
+
+		long long lower, upper;
+		BoundVariable(p, current_variable, lower, upper);
+		for (long long value = lower; value <= upper; ++value)
+		{
+			solution(current_variable) = value;
+			if (!EnumerateHelper(Substitute(p, current_variable, value), current_variable + 1, solution, visitor, found))
+				return false;
+		}
+		return true;
+	}
+
+} /// unnamed namespace
+
+	bool OmegaTest(const MatrixExt<long long>& A, const RowVector<long long>& c)
+	{
+		ValidateArguments(A, c);
+		return Solve(FormProblem(A, c));
+	}
+
+	bool FindIntegerBounds(const MatrixExt<long long>& A,
+		const RowVector<long long>& c,
+		RowVector<long long>& lower,
+		RowVector<long long>& upper)
+	{
+		ValidateArguments(A, c);
+
+		Problem p(FormProblem(A, c));
+		if (!Solve(p))
+			return false;
+
+		lower = RowVector<long long>(A.n_rows);
+		upper = RowVector<long long>(A.n_rows);
+		for (auto k = 0U; k < A.n_rows; ++k)
+			BoundVariable(p, k, lower(k), upper(k));
+		return true;
+	}
+
+	bool OmegaEnumerateIntegerSolutions(const MatrixExt<long long>& A,
+		const RowVector<long long>& c,
+		const IntegerSolutionVisitor& visitor)
+	{
+		ValidateArguments(A, c);
+
+		RowVector<long long> solution(A.n_rows);
+		bool found(false);
+		EnumerateHelper(FormProblem(A, c), 0, solution, visitor, found);
+		return found;
+	}
+
+} /// namespace util
+} /// namespace gap
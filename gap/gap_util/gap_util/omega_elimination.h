@@ -0,0 +1,115 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef GAP_UTIL_OMEGA_ELIMINATION_H
+#define GAP_UTIL_OMEGA_ELIMINATION_H
+
+#include "row_vector.h"
+#include "fourier_elimination.h"
+
+namespace gap
+{
+namespace util
+{
+
+	/**
+		* Decides if the system of n inequalities with m variables xA <= c (the same form as in PerformFourierElimination()) has an INTEGER
+		* solution, using the Omega test (W. Pugh, The Omega Test: a fast and practical integer programming algorithm for dependence analysis).
+		* Unlike Fourier elimination, the answer is exact and no enumeration of the solution set is required. The steps of the algorithm are:
+		*
+		* 1) Normalize every inequality by dividing its coefficients by their GCD g and replacing the right-hand side c with floor(c/g). This
+		*    tightens the inequality without losing any integer solution. Inequalities without variables are checked and removed, duplicates
+		*    are merged keeping the tightest right-hand side. Pairs of inequalities ax <= c and -ax <= -c are turned into equality ax = c, while
+		*    pairs for which ax <= c and -ax <= d where c + d < 0 prove that there is no solution.
+		*
+		* 2) Equalities are eliminated exactly. If some variable xk has coefficient +-1, it is expressed from the equality and substituted in
+		*    every other constraint. Otherwise, SolveDiophantineEquation() is used to obtain general solution x = tU of the equality, and the
+		*    system is rewritten in terms of free components of t. Equality whose coefficients' GCD doesn't divide the right-hand side has no
+		*    integer solution.
+		*
+		* 3) When there are no equalities, variable xk is chosen for elimination. If xk has no lower or no upper bound, every inequality that
+		*    contains it can always be satisfied and is dropped. Otherwise, every pair of upper bound a*xk <= alpha and lower bound beta <= b*xk
+		*    is combined into:
+		*
+		*    real shadow: a*beta <= b*alpha
+		*    dark shadow: a*beta + (a - 1)(b - 1) <= b*alpha
+		*
+		*    If a = 1 or b = 1 for every pair, the real shadow is exact and the algorithm continues with it. Otherwise, if the real shadow has
+		*    no integer solution, neither does the system. If the dark shadow has an integer solution, so does the system. If neither applies,
+		*    the system has an integer solution IFF one of the splinters has it: for every lower bound beta <= b*xk and i = 0, ...,
+		*    floor((amax*b - amax - b) / amax), where amax is the largest upper bound coefficient of xk, splinter is the original system with
+		*    additional equality b*xk = beta + i.
+		*
+		* @retval TRUE if the system has an INTEGER solution, FALSE otherwise.
+		*
+		* @throw std::logic_error if A.n_rows == 0 OR A.n_cols == 0 OR A.n_cols != c.n_cols. std::overflow_error is thrown if coefficients of
+		* the system overflow long long during elimination.
+		*/
+	bool OmegaTest(const MatrixExt<long long>& A, const RowVector<long long>& c);
+
+	/**
+		* Calculates exact integer bounds of every variable of the system xA <= c, so that lower(k) is the smallest and upper(k) the largest
+		* value that xk takes over all INTEGER solutions of the system. Unlike the bounds calculated by PerformFourierElimination(), these are
+		* attained by some integer solution. Initial range of xk is found by projecting the system onto xk (real shadows of normalized
+		* inequalities), and it is then narrowed by the binary search that asks OmegaTest() whether the system extended with xk <= v (or
+		* xk >= v) has an integer solution.
+		*
+		* @retval TRUE if the system has an integer solution, FALSE otherwise (lower and upper are left unchanged in this case).
+		*
+		* @throw std::logic_error under the same conditions as OmegaTest(), as well as when the solution set is infinite.
+		*/
+	bool FindIntegerBounds(const MatrixExt<long long>& A,
+		const RowVector<long long>& c,
+		RowVector<long long>& lower,
+		RowVector<long long>& upper);
+
+	/**
+		* Enumerates every integer solution of the system xA <= c and hands it to the visitor, in the same (lexicographic) order and under the
+		* same contract as the streaming variant of EnumerateIntegerSolutions(). Instead of rounding the REAL bounds produced by Fourier
+		* elimination, the exact integer range of x1 is calculated by FindIntegerBounds(), and each value from that range is substituted in the
+		* system before moving on to x2. Subsystems without integer solutions are recognized by OmegaTest() and are never descended into, so
+		* the amount of work depends on the number of integer solutions instead of the volume of the REAL solution set.
+		*
+		* @retval TRUE if at least one integer solution has been passed to the visitor, FALSE otherwise.
+		*
+		* @throw std::logic_error under the same conditions as FindIntegerBounds().
+		*/
+	bool OmegaEnumerateIntegerSolutions(const MatrixExt<long long>& A,
+		const RowVector<long long>& c,
+		const IntegerSolutionVisitor& visitor);
+
+} /// namespace util
+} /// namespace gap
+
+#endif /// GAP_UTIL_OMEGA_ELIMINATION_H
@@ -40,6 +40,7 @@
 #include <type_traits>
 #include <limits>
 #include "column_vector.h"
+#include "checked_arithmetic.h"
 #include "util.h"
 
 
@@ -82,21 +83,23 @@ namespace util
 				m_numerator *= -1;
 				m_denominator *= -1;
 			}
-			else if (m_numerator == 0)
+
+			if (m_numerator == 0)
 			{
 				m_denominator = 1;
 			}
 
-			/**																															*/
-			/* Once numerator and/or denominator exceed certain size limit, attempt to normalize numerator and denominator by dividing	*/
-			/* dividing both with GCD(nom, den).																						*/
-			/*																															*/
-			/*if (m_numerator >= T(0.01 * std::numeric_limits<T>::max()) || m_denominator >= T(0.01 * std::numeric_limits<T>::max()))
-			{*/
-				T gcd_val = gcd(ColVector<T>({ m_numerator, m_denominator }));
-				m_numerator /= gcd_val;
-				m_denominator /= gcd_val;
-			//}
+			/** Reduce by GCD, unless lazy normalization is enabled and both values are still small (@see rational_normalization_threshold). */
+			const unsigned long long threshold(GetRationalNormalizationThreshold());
+			if (threshold == 0 || Magnitude(m_numerator) > threshold || Magnitude(m_denominator) > threshold)
+			{
+				const T gcd_val(static_cast<T>(BinaryGcd(m_numerator, m_denominator)));
+				if (gcd_val > 1)
+				{
+					m_numerator /= gcd_val;
+					m_denominator /= gcd_val;
+				}
+			}
 		}
 
 		template<typename U>
@@ -115,10 +118,11 @@ namespace util
 
 		operator T() const
 		{
-			if (static_cast<int>(std::abs(m_denominator)) != 1)
+			/** Fractions which haven't been reduced (@see rational_normalization_threshold) may have an integral value as well. */
+			if (m_denominator != 1 && m_numerator % m_denominator != 0)
 				throw std::runtime_error("Rational::operator T(): rational can be cast to integral type only when denominator is 1");
 
-			return m_numerator * m_denominator;
+			return m_numerator / m_denominator;
 		}
 
 		operator long double() const
@@ -204,218 +208,368 @@ namespace util
 
 	private:
 
+		static unsigned long long Magnitude(T value)
+		{
+			return value < 0 ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+		}
+
 		T m_numerator;
 		T m_denominator;
 	};
 
 
+	/*******************************************************************************************************************************/
+	/****************************************** Overflow-checked arithmetic on rationals *******************************************/
+
+	/**
+	 * Every operator below reduces to one of the operations n1/d1 op n2/d2 (integral operands have denominator 1). The operation is
+	 * first carried out in T with overflow checks (RATIONAL_TIER_FAST). If any intermediate value overflows, it is carried out again in
+	 * 128-bit integers (RATIONAL_TIER_WIDE) or, when the compiler doesn't provide them, in BigInteger (RATIONAL_TIER_BIG). Both slow
+	 * tiers reduce the result by GCD of numerator and denominator before narrowing it back to T, and std::overflow_error is thrown
+	 * (RATIONAL_TIER_OVERFLOW) if the reduced result still doesn't fit. @see checked_arithmetic.h
+	 */
+	enum RationalOp
+	{
+		RATIONAL_OP_ADD = 0
+		, RATIONAL_OP_SUB
+		, RATIONAL_OP_MUL
+		, RATIONAL_OP_DIV
+	};
+
+	/** Calculates numerator and denominator of n1/d1 op n2/d2 in type W, without reducing them. */
+	template<typename W>
+	inline void CalculateRationalOp(W n1, W d1, W n2, W d2, RationalOp op, W& num, W& den)
+	{
+		switch (op)
+		{
+		case RATIONAL_OP_ADD:	num = n1 * d2 + n2 * d1;	den = d1 * d2;	break;
+		case RATIONAL_OP_SUB:	num = n1 * d2 - n2 * d1;	den = d1 * d2;	break;
+		case RATIONAL_OP_MUL:	num = n1 * n2;				den = d1 * d2;	break;
+		default:				num = n1 * d2;				den = d1 * n2;	break;
+		}
+	}
+
+	/** Slow path of CheckedRationalOp(), taken when some intermediate value of the operation overflows T. */
+	template<typename T>
+	Rational<T> WideRationalOp(T n1, T d1, T n2, T d2, RationalOp op)
+	{
+		if ((op == RATIONAL_OP_DIV && n2 == 0) || d1 == 0 || d2 == 0)
+			throw std::runtime_error("Rational::Rational(): denominator mustn't be equal to 0");
+
+		long long num_value(0), den_value(0);
+		bool fits(false);
+
+#ifdef GAP_UTIL_HAS_INT128
+		/** Products of two values of (at most) 64 bits, as well as their sum, always fit in 128 bits. */
+		static_assert(sizeof(T) <= sizeof(long long), "Rational<T>: 128-bit tier supports types of at most 64 bits");
+
+		__int128 num, den;
+		CalculateRationalOp<__int128>(n1, d1, n2, d2, op, num, den);
+
+		__int128 a(num < 0 ? -num : num), b(den < 0 ? -den : den);
+		while (b != 0)
+		{
+			__int128 r(a % b);
+			a = b;
+			b = r;
+		}
+		if (den < 0)
+			a = -a;
+		num /= a;
+		den /= a;
+
+		fits = num >= std::numeric_limits<T>::min() && num <= std::numeric_limits<T>::max() && den <= std::numeric_limits<T>::max();
+		num_value = static_cast<long long>(num);
+		den_value = static_cast<long long>(den);
+		RecordRationalTier(fits ? RATIONAL_TIER_WIDE : RATIONAL_TIER_OVERFLOW);
+#else
+		BigInteger num, den;
+		CalculateRationalOp<BigInteger>(static_cast<long long>(n1), static_cast<long long>(d1), static_cast<long long>(n2),
+			static_cast<long long>(d2), op, num, den);
+
+		BigInteger gcd_val(BigInteger::Gcd(num, den)), remainder;
+		if (den.IsNegative())
+			gcd_val = -gcd_val;
+		BigInteger::DivMod(BigInteger(num), gcd_val, num, remainder);
+		BigInteger::DivMod(BigInteger(den), gcd_val, den, remainder);
+
+		fits = num.ToLongLong(num_value) && den.ToLongLong(den_value) && num_value >= std::numeric_limits<T>::min() &&
+			num_value <= std::numeric_limits<T>::max() && den_value <= std::numeric_limits<T>::max();
+		RecordRationalTier(fits ? RATIONAL_TIER_BIG : RATIONAL_TIER_OVERFLOW);
+#endif
+
+		if (!fits)
+			throw std::overflow_error("Rational: result of the operation can't be represented without overflow");
+
+		return Rational<T>(static_cast<T>(num_value), static_cast<T>(den_value));
+	}
+
+	/** Calculates n1/d1 op n2/d2, switching to the slow path only when some intermediate value overflows T. */
+	template<typename T>
+	inline Rational<T> CheckedRationalOp(T n1, T d1, T n2, T d2, RationalOp op)
+	{
+		T num, den, p1, p2;
+		bool overflow;
+		switch (op)
+		{
+		case RATIONAL_OP_ADD:
+			overflow = MulOverflow(n1, d2, p1) || MulOverflow(n2, d1, p2) || AddOverflow(p1, p2, num) || MulOverflow(d1, d2, den);
+			break;
+		case RATIONAL_OP_SUB:
+			overflow = MulOverflow(n1, d2, p1) || MulOverflow(n2, d1, p2) || SubOverflow(p1, p2, num) || MulOverflow(d1, d2, den);
+			break;
+		case RATIONAL_OP_MUL:
+			overflow = MulOverflow(n1, n2, num) || MulOverflow(d1, d2, den);
+			break;
+		default:
+			/** Negative denominator is negated in Rational constructor (together with numerator), which must not overflow either. */
+			overflow = MulOverflow(n1, d2, num) || MulOverflow(d1, n2, den) ||
+				(den < 0 && (den == std::numeric_limits<T>::min() || num == std::numeric_limits<T>::min()));
+			break;
+		}
+
+		if (overflow)
+			return WideRationalOp(n1, d1, n2, d2, op);
+
+		RecordRationalTier(RATIONAL_TIER_FAST);
+		return Rational<T>(num, den);
+	}
+
+
 	/*******************************************************************************************************************************/
 	/********************* Free standing arithmetic operator function templates for Rational class template. ***********************/
 
 	template<typename T1, typename T2>
 	inline Rational<typename std::common_type<T1, T2>::type> operator+(const Rational<T1>& v1, const Rational<T2>& v2)
 	{
-		return { v1.numerator() * v2.denominator() + v2.numerator() * v1.denominator(), v1.denominator() * v2.denominator() };
+		typedef typename std::common_type<T1, T2>::type T;
+		return CheckedRationalOp<T>(v1.numerator(), v1.denominator(), v2.numerator(), v2.denominator(), RATIONAL_OP_ADD);
 	}
 
 	template<typename T>
 	inline Rational<T> operator+(const Rational<T>& v1, const T v2)
 	{
-		return { v1.numerator() + v2 * v1.denominator(), v1.denominator() };
+		return CheckedRationalOp<T>(v1.numerator(), v1.denominator(), v2, T(1), RATIONAL_OP_ADD);
 	}
 
 	template<typename T>
 	inline Rational<T> operator+(const T v1, const Rational<T>& v2)
 	{
-		return { v1 * v2.denominator() + v2.numerator(), v2.denominator() };
+		return CheckedRationalOp<T>(v1, T(1), v2.numerator(), v2.denominator(), RATIONAL_OP_ADD);
 	}
 
 	template<typename T1, typename T2>
 	inline Rational<typename std::common_type<T1, T2>::type> operator-(const Rational<T1>& v1, const Rational<T2>& v2)
 	{
-		return { v1.numerator() * v2.denominator() - v2.numerator() * v1.denominator(), v1.denominator() * v2.denominator() };
+		typedef typename std::common_type<T1, T2>::type T;
+		return CheckedRationalOp<T>(v1.numerator(), v1.denominator(), v2.numerator(), v2.denominator(), RATIONAL_OP_SUB);
 	}
 
 	template<typename T>
 	inline Rational<T> operator-(const Rational<T>& v1, const T v2)
 	{
-		return { v1.numerator() - v2 * v1.denominator(), v1.denominator() };
+		return CheckedRationalOp<T>(v1.numerator(), v1.denominator(), v2, T(1), RATIONAL_OP_SUB);
 	}
 
 	template<typename T>
 	inline Rational<T> operator-(const T v1, const Rational<T>& v2)
 	{
-		return { v1 * v2.denominator() - v2.numerator(), v2.denominator() };
+		return CheckedRationalOp<T>(v1, T(1), v2.numerator(), v2.denominator(), RATIONAL_OP_SUB);
 	}
 
 	template<typename T1, typename T2>
 	inline Rational<typename std::common_type<T1, T2>::type> operator*(const Rational<T1>& v1, const Rational<T2>& v2)
 	{
-		return { v1.numerator() * v2.numerator(), v1.denominator() * v2.denominator() };
+		typedef typename std::common_type<T1, T2>::type T;
+		return CheckedRationalOp<T>(v1.numerator(), v1.denominator(), v2.numerator(), v2.denominator(), RATIONAL_OP_MUL);
 	}
 
 	template<typename T>
 	inline Rational<T> operator*(const Rational<T>& v1, const T v2)
 	{
-		return { v1.numerator() * v2, v1.denominator() };
+		return CheckedRationalOp<T>(v1.numerator(), v1.denominator(), v2, T(1), RATIONAL_OP_MUL);
 	}
 
 	template<typename T>
 	inline Rational<T> operator*(const T v1, const Rational<T>& v2)
 	{
-		return { v1 * v2.numerator(), v2.denominator() };
+		return CheckedRationalOp<T>(v1, T(1), v2.numerator(), v2.denominator(), RATIONAL_OP_MUL);
 	}
 
 	template<typename T1, typename T2>
 	inline Rational<typename std::common_type<T1, T2>::type> operator/(const Rational<T1>& v1, const Rational<T2>& v2)
 	{
-		return { v1.numerator() * v2.denominator(), v1.denominator() * v2.numerator() };
+		typedef typename std::common_type<T1, T2>::type T;
+		return CheckedRationalOp<T>(v1.numerator(), v1.denominator(), v2.numerator(), v2.denominator(), RATIONAL_OP_DIV);
 	}
 
 	template<typename T>
 	inline Rational<T> operator/(const Rational<T>& v1, const T v2)
 	{
-		return { v1.numerator(), v1.denominator() * v2 };
+		return CheckedRationalOp<T>(v1.numerator(), v1.denominator(), v2, T(1), RATIONAL_OP_DIV);
 	}
 
 	template<typename T>
 	inline Rational<T> operator/(const T v1, const Rational<T>& v2)
 	{
-		return { v1 * v2.denominator(), v2.numerator() };
+		return CheckedRationalOp<T>(v1, T(1), v2.numerator(), v2.denominator(), RATIONAL_OP_DIV);
 	}
 
 
 	/*******************************************************************************************************************************/
 	/************************ Free standing logical operator function templates for Rational class template. ***********************/
-	/**																															   */
-	/* Note: because of the possibility of overflow when multiplying numerators and denominators of two rationals, comparison is   */
-	/* done by first converting Rationals to doubles. Doubles are considered equal when difference between them is < 10^-8.		   */
-	/*																															   */
+
+	/**
+	 * Compares n1/d1 and n2/d2 exactly and returns negative value, zero or positive value when the first one is lower than, equal to or
+	 * greater than the second one. Denominators are positive (@see Rational constructor), so the rationals compare the same way as the
+	 * cross products n1*d2 and n2*d1. Rationals with equal denominators (e.g. two integers) are compared without any multiplication.
+	 * Cross products are calculated in T when they don't overflow, and in 128-bit integers (or BigInteger) otherwise.
+	 */
+	template<typename T>
+	inline int CompareRationals(T n1, T d1, T n2, T d2)
+	{
+		if (d1 == d2)
+			return (n1 > n2) - (n1 < n2);
+
+		/** Signs decide whenever they differ (or one of the numerators is zero). */
+		int sign1((n1 > 0) - (n1 < 0)), sign2((n2 > 0) - (n2 < 0));
+		if (sign1 != sign2 || sign1 == 0)
+			return sign1 - sign2;
+
+		T p1, p2;
+		if (!MulOverflow(n1, d2, p1) && !MulOverflow(n2, d1, p2))
+			return (p1 > p2) - (p1 < p2);
+
+#ifdef GAP_UTIL_HAS_INT128
+		static_assert(sizeof(T) <= sizeof(long long), "Rational<T>: 128-bit comparison supports types of at most 64 bits");
+		__int128 w1(static_cast<__int128>(n1) * d2), w2(static_cast<__int128>(n2) * d1);
+		return (w1 > w2) - (w1 < w2);
+#else
+		BigInteger difference(BigInteger(static_cast<long long>(n1)) * BigInteger(static_cast<long long>(d2)) -
+			BigInteger(static_cast<long long>(n2)) * BigInteger(static_cast<long long>(d1)));
+		return difference.IsZero() ? 0 : (difference.IsNegative() ? -1 : 1);
+#endif
+	}
+
+	/** Returns -1, 0 or 1 depending on the sign of the rational number, without any arithmetic. */
+	template<typename T>
+	inline int Sign(const Rational<T>& value)
+	{
+		return (value.numerator() > T(0)) - (value.numerator() < T(0));
+	}
 
 	template<typename T1, typename T2>
 	inline bool operator<(const Rational<T1>& v1, const Rational<T2>& v2)
 	{
-		//return v1.numerator() * v2.denominator() < v2.numerator() * v1.denominator();
-		return lower(v1, v2);
+		typedef typename std::common_type<T1, T2>::type T;
+		return CompareRationals<T>(v1.numerator(), v1.denominator(), v2.numerator(), v2.denominator()) < 0;
 	}
 
 	template<typename T>
 	inline bool operator<(const Rational<T>& v1, const T v2)
 	{
-		//return v1.numerator() < v2 * v1.denominator();
-		return lower(v1, v2);
+		return CompareRationals<T>(v1.numerator(), v1.denominator(), v2, T(1)) < 0;
 	}
 
 	template<typename T>
 	inline bool operator<(const T v1, const Rational<T>& v2)
 	{
-		//return v1 * v2.denominator() < v2.numerator();
-		return lower(v1, v2);
+		return CompareRationals<T>(v1, T(1), v2.numerator(), v2.denominator()) < 0;
 	}
 
 	template<typename T1, typename T2>
 	inline bool operator>(const Rational<T1>& v1, const Rational<T2>& v2)
 	{
-		//return v1.numerator() * v2.denominator() > v2.numerator() * v1.denominator();
-		return greater(v1, v2);
+		typedef typename std::common_type<T1, T2>::type T;
+		return CompareRationals<T>(v1.numerator(), v1.denominator(), v2.numerator(), v2.denominator()) > 0;
 	}
 
 	template<typename T>
 	inline bool operator>(const Rational<T>& v1, const T v2)
 	{
-		//return v1.numerator() > v2 * v1.denominator();
-		return greater(v1, v2);
+		return CompareRationals<T>(v1.numerator(), v1.denominator(), v2, T(1)) > 0;
 	}
 
 	template<typename T>
 	inline bool operator>(const T v1, const Rational<T>& v2)
 	{
-		//return v1 * v2.denominator() > v2.numerator();
-		return greater(v1, v2);
+		return CompareRationals<T>(v1, T(1), v2.numerator(), v2.denominator()) > 0;
 	}
 
 	template<typename T1, typename T2>
 	inline bool operator==(const Rational<T1>& v1, const Rational<T2>& v2)
 	{
-		//return v1.numerator() * v2.denominator() == v2.numerator() * v1.denominator();
-		return equal(v1, v2);
+		typedef typename std::common_type<T1, T2>::type T;
+		return CompareRationals<T>(v1.numerator(), v1.denominator(), v2.numerator(), v2.denominator()) == 0;
 	}
 
 	template<typename T>
 	inline bool operator==(const Rational<T>& v1, const T v2)
 	{
-		//return v1.numerator() == v2 * v1.denominator();
-		return equal(v1, v2);
+		return CompareRationals<T>(v1.numerator(), v1.denominator(), v2, T(1)) == 0;
 	}
 
 	template<typename T>
 	inline bool operator==(const T v1, const Rational<T>& v2)
 	{
-		//return v1 * v2.denominator() == v2.numerator();
-		return equal(v1, v2);
+		return CompareRationals<T>(v1, T(1), v2.numerator(), v2.denominator()) == 0;
 	}
 
 	template<typename T1, typename T2>
 	inline bool operator<=(const Rational<T1>& v1, const Rational<T2>& v2)
 	{
-		//return v1.numerator() * v2.denominator() <= v2.numerator() * v1.denominator();
-		return lower_equal(v1, v2);
+		typedef typename std::common_type<T1, T2>::type T;
+		return CompareRationals<T>(v1.numerator(), v1.denominator(), v2.numerator(), v2.denominator()) <= 0;
 	}
 
 	template<typename T>
 	inline bool operator<=(const Rational<T>& v1, const T v2)
 	{
-		//return v1.numerator() <= v2 * v1.denominator();
-		return lower_equal(v1, v2);
+		return CompareRationals<T>(v1.numerator(), v1.denominator(), v2, T(1)) <= 0;
 	}
 
 	template<typename T>
 	inline bool operator<=(const T v1, const Rational<T>& v2)
 	{
-		//return v1 * v2.denominator() <= v2.numerator();
-		return lower_equal(v1, v2);
+		return CompareRationals<T>(v1, T(1), v2.numerator(), v2.denominator()) <= 0;
 	}
 
 	template<typename T1, typename T2>
 	inline bool operator>=(const Rational<T1>& v1, const Rational<T2>& v2)
 	{
-		//return v1.numerator() * v2.denominator() >= v2.numerator() * v1.denominator();
-		return greater_equal(v1, v2);
+		typedef typename std::common_type<T1, T2>::type T;
+		return CompareRationals<T>(v1.numerator(), v1.denominator(), v2.numerator(), v2.denominator()) >= 0;
 	}
 
 	template<typename T>
 	inline bool operator>=(const Rational<T>& v1, const T v2)
 	{
-		//return v1.numerator() >= v2 * v1.denominator();
-		return greater_equal(v1, v2);
+		return CompareRationals<T>(v1.numerator(), v1.denominator(), v2, T(1)) >= 0;
 	}
 
 	template<typename T>
 	inline bool operator>=(const T v1, const Rational<T>& v2)
 	{
-		//return v1 * v2.denominator() >= v2.numerator();
-		return greater_equal(v1, v2);
+		return CompareRationals<T>(v1, T(1), v2.numerator(), v2.denominator()) >= 0;
 	}
 
 	template<typename T1, typename T2>
 	inline bool operator!=(const Rational<T1>& v1, const Rational<T2>& v2)
 	{
-		//return v1.numerator() * v2.denominator() != v2.numerator() * v1.denominator();
-		return not_equal(v1, v2);
+		typedef typename std::common_type<T1, T2>::type T;
+		return CompareRationals<T>(v1.numerator(), v1.denominator(), v2.numerator(), v2.denominator()) != 0;
 	}
 
 	template<typename T>
 	inline bool operator!=(const Rational<T>& v1, const T v2)
 	{
-		//return v1.numerator() != v2 * v1.denominator();
-		return not_equal(v1, v2);
+		return CompareRationals<T>(v1.numerator(), v1.denominator(), v2, T(1)) != 0;
 	}
 
 	template<typename T>
 	inline bool operator!=(const T v1, const Rational<T>& v2)
 	{
-		//return v1 * v2.denominator() != v2.numerator();
-		return not_equal(v1, v2);
+		return CompareRationals<T>(v1, T(1), v2.numerator(), v2.denominator()) != 0;
 	}
 
 } /// namespace util
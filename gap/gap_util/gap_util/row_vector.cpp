@@ -72,10 +72,21 @@ namespace util
     template<typename T>
     RowVector<T>::RowVector(MatrixExt<T>&& X): MatrixExt<T>(std::move(X))
     {
-        if (X.n_rows != 1)
+        /** Moved-from X may be empty already, so dimensions of this instance are checked. */
+        if (this->n_rows != 1)
             throw std::logic_error("RowVector(const MatrixExt<T>& X): X.n_rows must be equal to 1");
     }
 
+    template<typename T>
+    RowVector<T>::RowVector(const RowVector& x): MatrixExt<T>(x)
+    {
+    }
+
+    template<typename T>
+    RowVector<T>::RowVector(RowVector&& x): MatrixExt<T>(std::move(x))
+    {
+    }
+
     template<typename T>
     const RowVector<T>& RowVector<T>::operator=(const MatrixExt<T>& X)
     {
@@ -120,64 +131,84 @@ namespace util
         return *this;
     }
 
+    template<typename T>
+    const RowVector<T>& RowVector<T>::operator=(const RowVector& x)
+    {
+        MatrixExt<T>::operator=(x);
+        return *this;
+    }
+
+    template<typename T>
+    const RowVector<T>& RowVector<T>::operator=(RowVector&& x)
+    {
+        MatrixExt<T>::operator=(std::move(x));
+        return *this;
+    }
+
     template<typename T>
     RowVector<T> operator+(const RowVector<T>& x, const RowVector<T>& y)
     {
-        return RowVector<T>(dynamic_cast<const MatrixExt<T>& >(x) + dynamic_cast<const MatrixExt<T>& >(y));
+        return RowVector<T>(static_cast<const Mat<T>& >(x) + static_cast<const Mat<T>& >(y));
     }
 
     template<typename T>
     RowVector<T> operator-(const RowVector<T>& x, const RowVector<T>& y)
     {
-        return RowVector<T>(dynamic_cast<const MatrixExt<T>& >(x) - dynamic_cast<const MatrixExt<T>& >(y));
+        return RowVector<T>(static_cast<const Mat<T>& >(x) - static_cast<const Mat<T>& >(y));
     }
 
     template<typename T>
     RowVector<T> operator*(const RowVector<T>& x, const MatrixExt<T>& Y)
     {
-        return RowVector<T>(dynamic_cast<const MatrixExt<T>& >(x) * Y);
+        return RowVector<T>(static_cast<const Mat<T>& >(x) * static_cast<const Mat<T>& >(Y));
     }
 
     template<typename T>
     T operator*(const RowVector<T>& x, const ColVector<T>& y)
     {
-        return RowVector<T>(dynamic_cast<const MatrixExt<T>& >(x) * dynamic_cast<const MatrixExt<T>& >(y))(0);
+        if (x.n_cols != y.n_rows)
+            throw std::logic_error("operator*(const RowVector<T>& x, const ColVector<T>& y): x and y must have the same number of elements");
+
+        T out(0);
+        for (auto i = 0U; i < x.n_cols; ++i)
+            out += x(i) * y(i);
+        return out;
     }
 
     template<typename T>
     MatrixExt<T> operator*(const ColVector<T>& x, const RowVector<T>& y)
     {
-        return RowVector<T>(dynamic_cast<const MatrixExt<T>& >(x) * dynamic_cast<const MatrixExt<T>& >(y));
+        return MatrixExt<T>(static_cast<const Mat<T>& >(x) * static_cast<const Mat<T>& >(y));
     }
 
     template<typename T>
     RowVector<T> operator*(const RowVector<T>& x, const T& scalar)
     {
-        return RowVector<T>(dynamic_cast<const MatrixExt<T>& >(x) * scalar);
+        return RowVector<T>(static_cast<const Mat<T>& >(x) * scalar);
     }
 
     template<typename T>
     RowVector<T> operator*(const T& scalar, const RowVector<T>& x)
     {
-        return RowVector<T>(scalar * dynamic_cast<const MatrixExt<T>& >(x));
+        return RowVector<T>(scalar * static_cast<const Mat<T>& >(x));
     }
 
     template<typename T>
     RowVector<T> operator/(const RowVector<T>& x, const RowVector<T>& y)
     {
-        return RowVector<T>(dynamic_cast<const MatrixExt<T>& >(x) / dynamic_cast<const MatrixExt<T>& >(y));
+        return RowVector<T>(static_cast<const Mat<T>& >(x) / static_cast<const Mat<T>& >(y));
     }
 
     template<typename T>
     RowVector<T> operator/(const RowVector<T>& x, const T& scalar)
     {
-        return RowVector<T>(dynamic_cast<const MatrixExt<T>& >(x) / scalar);
+        return RowVector<T>(static_cast<const Mat<T>& >(x) / scalar);
     }
 
     template<typename T>
     RowVector<T> operator/(const T& scalar, const RowVector<T>& x)
     {
-        return RowVector<T>(scalar / dynamic_cast<const MatrixExt<T>& >(x));
+        return RowVector<T>(scalar / static_cast<const Mat<T>& >(x));
     }
 
     template<typename T>
@@ -186,15 +217,15 @@ namespace util
         if (x.n_cols != y.n_cols)
             throw std::logic_error("RowVector::CompareLexicographically(): vectors must have the same number of cols");
 
-        RowVector<T> d(x - y);
-        level = d.GetLevel();
-        if (level == x.n_cols)
+        /** Level is the first element of vector x - y that is non-zero, so it is found without forming the difference. */
+        for (level = 0; level < x.n_cols; ++level)
         {
-            /** Vector d = y - x is zero vector, so x == y. */
-            return Equal;
+            if (x(level) != y(level))
+                return x(level) > y(level) ? LeftGreater : RightGreater;
         }
 
-        return d(level) > T(0) ? LeftGreater : RightGreater;
+        /** Vectors are equal, level is n_cols. */
+        return Equal;
     }
 
     template<typename T>
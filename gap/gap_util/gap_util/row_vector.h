@@ -39,6 +39,7 @@
 #include "column_vector.h"
 #include <vector>
 #include <initializer_list>
+#include <stdexcept>
 
 namespace gap
 {
@@ -98,9 +99,35 @@ namespace util
         RowVector(const std::initializer_list<T>& x);
         RowVector(const MatrixExt<T>& X);
         RowVector(MatrixExt<T>&& X);
+        RowVector(const RowVector& x);
+        RowVector(RowVector&& x);
+
+		/**
+		 * @brief Evaluates delayed armadillo expression X (for instance product of a subvector and a submatrix) directly into this
+		 * instance. @throw std::logic_error if X doesn't have exactly one row
+		 */
+		template<typename T1>
+		RowVector(const Base<T, T1>& X) : MatrixExt<T>(X)
+		{
+			if (this->n_rows != 1)
+				throw std::logic_error("RowVector(const Base<T, T1>& X): X.n_rows must be equal to 1");
+		}
+
         const RowVector& operator=(const MatrixExt<T>& X);
         const RowVector& operator=(const std::vector<T>& x);
         const RowVector& operator=(const std::initializer_list<T>& x);
+        const RowVector& operator=(const RowVector& x);
+        const RowVector& operator=(RowVector&& x);
+
+		template<typename T1>
+		const RowVector& operator=(const Base<T, T1>& X)
+		{
+			MatrixExt<T>::operator=(X);
+			if (this->n_rows != 1)
+				throw std::logic_error("RowVector::operator=(const Base<T, T1>& X): X.n_rows must be equal to 1");
+			return *this;
+		}
+
         virtual ~RowVector()
         {
         }
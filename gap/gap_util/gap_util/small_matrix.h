@@ -0,0 +1,400 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef GAP_UTIL_SMALL_MATRIX_H
+#define GAP_UTIL_SMALL_MATRIX_H
+
+#include "row_vector.h"
+#include <array>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+namespace gap
+{
+namespace util
+{
+
+	/** Default capacity of SmallMatrix in both dimensions. Dependence systems have 2m rows, so this covers loop nests up to 8 deep. */
+	const uword SMALL_MATRIX_CAPACITY = 16;
+
+	/**
+	 * @brief Integral matrix with at most MaxRows x MaxCols elements that are stored inline, so that the matrix lives on the stack when
+	 * used as a local variable. It is meant for nest-sized linear algebra (subscript, bound and unimodular matrices), where MatrixExt
+	 * allocates on every construction and on every elementary operation. The elementary operations and echelon reductions have the same
+	 * semantics as the ones of MatrixExt. Elements are stored in row-major order, so row operations access contiguous memory.
+	 *
+	 * Use Fits() to check whether the matrix of given dimensions can be represented, as constructing larger matrices throws.
+	 */
+	template<typename T, uword MaxRows = SMALL_MATRIX_CAPACITY, uword MaxCols = SMALL_MATRIX_CAPACITY>
+	class SmallMatrix
+	{
+		static_assert(std::is_integral<T>::value, "SmallMatrix class template can be instantiated with integral types only!");
+
+	public:
+		/** Square matrix type of unimodular matrices produced by the echelon reductions. */
+		typedef SmallMatrix<T, MaxRows, MaxRows> UnimodularType;
+
+		SmallMatrix() : n_rows(0), n_cols(0)
+		{
+		}
+
+		/** @throw std::range_error if the dimensions exceed the capacity. */
+		SmallMatrix(const uword num_rows, const uword num_cols) : n_rows(0), n_cols(0)
+		{
+			zeros(num_rows, num_cols);
+		}
+
+		/** Constructs (1 x num_cols) zero row vector, only available when MaxRows is 1 (@see SmallRowVector). */
+		explicit SmallMatrix(const uword num_cols) : n_rows(0), n_cols(0)
+		{
+			static_assert(MaxRows == 1, "SmallMatrix(num_cols) constructs row vectors only");
+			zeros(1, num_cols);
+		}
+
+		/** @throw std::range_error if the dimensions of X exceed the capacity. */
+		explicit SmallMatrix(const Mat<T>& X) : n_rows(0), n_cols(0)
+		{
+			set_size(X.n_rows, X.n_cols);
+			for (auto i = 0U; i < n_rows; ++i)
+				for (auto j = 0U; j < n_cols; ++j)
+					(*this)(i, j) = X(i, j);
+		}
+
+		static bool Fits(const uword num_rows, const uword num_cols)
+		{
+			return num_rows <= MaxRows && num_cols <= MaxCols;
+		}
+
+		MatrixExt<T> ToMatrixExt() const
+		{
+			MatrixExt<T> out(n_rows, n_cols);
+			for (auto i = 0U; i < n_rows; ++i)
+				for (auto j = 0U; j < n_cols; ++j)
+					out(i, j) = (*this)(i, j);
+			return out;
+		}
+
+		/** Returns columns [first_col, first_col + num_cols) of this (1 x n) matrix as RowVector. */
+		RowVector<T> ToRowVector(const uword first_col, const uword num_cols) const
+		{
+			RowVector<T> out(num_cols);
+			for (auto j = 0U; j < num_cols; ++j)
+				out(j) = (*this)(0, first_col + j);
+			return out;
+		}
+
+		T& operator()(const uword row, const uword col)
+		{
+			return m_elements[row * MaxCols + col];
+		}
+
+		const T& operator()(const uword row, const uword col) const
+		{
+			return m_elements[row * MaxCols + col];
+		}
+
+		/** Element access by column index, only available for row vectors (MaxRows is 1). */
+		T& operator()(const uword col)
+		{
+			static_assert(MaxRows == 1, "SmallMatrix::operator()(col) is available for row vectors only");
+			return m_elements[col];
+		}
+
+		const T& operator()(const uword col) const
+		{
+			static_assert(MaxRows == 1, "SmallMatrix::operator()(col) is available for row vectors only");
+			return m_elements[col];
+		}
+
+		/** Changes the dimensions without initializing the elements. @throw std::range_error if they exceed the capacity. */
+		void set_size(const uword num_rows, const uword num_cols)
+		{
+			if (!Fits(num_rows, num_cols))
+				throw std::range_error("SmallMatrix::set_size(): dimensions exceed the capacity of the matrix");
+
+			n_rows = num_rows;
+			n_cols = num_cols;
+		}
+
+		void zeros(const uword num_rows, const uword num_cols)
+		{
+			set_size(num_rows, num_cols);
+			for (auto i = 0U; i < n_rows; ++i)
+				for (auto j = 0U; j < n_cols; ++j)
+					(*this)(i, j) = T(0);
+		}
+
+		void eye(const uword num_rows, const uword num_cols)
+		{
+			zeros(num_rows, num_cols);
+			for (auto i = 0U; i < n_rows && i < n_cols; ++i)
+				(*this)(i, i) = T(1);
+		}
+
+		/** @see MatrixExt::GetRowLevel() */
+		uword GetRowLevel(const uword row) const
+		{
+			if (row >= n_rows)
+				throw std::range_error("SmallMatrix::GetRowLevel(): argument 'row' not within allowed range");
+
+			for (auto j = 0U; j < n_cols; ++j)
+			{
+				if ((*this)(row, j) != T(0))
+					return j;
+			}
+
+			/** Row is a zero vector. */
+			return n_cols;
+		}
+
+		/** @see MatrixExt::IsEchelon() */
+		bool IsEchelon() const
+		{
+			uword last_level(0);
+			for (auto i = 0U; i < n_rows; ++i)
+			{
+				uword level(GetRowLevel(i));
+				if (level < n_cols && i > 0 && level <= last_level)
+					return false;
+
+				last_level = level;
+			}
+			return true;
+		}
+
+		/** @see MatrixExt::ComputeRank() */
+		uword ComputeRank() const
+		{
+			UnimodularType U;
+			SmallMatrix S;
+			return ReduceToEchelon(U, S);
+		}
+
+		/** @see MatrixExt::DoReversalOperation() */
+		SmallMatrix& DoReversalOperation(const uword n_to_invert, bool row_reversal)
+		{
+			if (n_to_invert >= (row_reversal ? n_rows : n_cols))
+				throw std::range_error("SmallMatrix::DoReversalOperation(): n_to_invert must be smaller than n_rows/n_cols");
+
+			if (row_reversal)
+			{
+				for (auto j = 0U; j < n_cols; ++j)
+					(*this)(n_to_invert, j) *= -1;
+			}
+			else
+			{
+				for (auto i = 0U; i < n_rows; ++i)
+					(*this)(i, n_to_invert) *= -1;
+			}
+			return *this;
+		}
+
+		/** @see MatrixExt::DoInterchangeOperation() */
+		SmallMatrix& DoInterchangeOperation(const uword x, const uword y, bool row_interchange)
+		{
+			const uword limit(row_interchange ? n_rows : n_cols);
+			if (x >= limit || y >= limit)
+				throw std::range_error("SmallMatrix::DoInterchangeOperation(): x and y must be smaller than n_rows/n_cols");
+
+			if (row_interchange)
+			{
+				for (auto j = 0U; j < n_cols; ++j)
+					std::swap((*this)(x, j), (*this)(y, j));
+			}
+			else
+			{
+				for (auto i = 0U; i < n_rows; ++i)
+					std::swap((*this)(i, x), (*this)(i, y));
+			}
+			return *this;
+		}
+
+		/** @see MatrixExt::DoSkewingOperation() */
+		SmallMatrix& DoSkewingOperation(const uword source, const uword target, const T scalar, bool row_skew)
+		{
+			if (source == target)
+				throw std::logic_error("SmallMatrix::DoSkewingOperation(): source row/col must be different than target row/col");
+
+			const uword limit(row_skew ? n_rows : n_cols);
+			if (source >= limit || target >= limit)
+				throw std::range_error("SmallMatrix::DoSkewingOperation(): source/target must be smaller than n_rows/n_cols");
+
+			if (row_skew)
+			{
+				for (auto j = 0U; j < n_cols; ++j)
+					(*this)(target, j) += (*this)(source, j) * scalar;
+			}
+			else
+			{
+				for (auto i = 0U; i < n_rows; ++i)
+					(*this)(i, target) += (*this)(i, source) * scalar;
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Reduces this matrix A to echelon matrix S computing unimodular matrix U such that UA = S.
+		 *
+		 * @retval Rank of matrix S (number of non-zero rows in case of echelon matrices)
+		 * @see MatrixExt::ReduceToEchelon() and Loop Transformations for Restructuring Compilers, The Foundations (Algorithm 2.1)
+		 */
+		uword ReduceToEchelon(UnimodularType& U, SmallMatrix& S) const
+		{
+			U.eye(n_rows, n_rows);
+			S = *this;
+
+			uword rank(0);
+			for (auto j = 0U; j < n_cols && rank < n_rows; ++j)
+			{
+				if (S.IsZeroBelow(rank, j))
+					continue;
+
+				/**
+				 * Euclid's algorithm on rows i-1 and i, from the bottom row upwards, moves GCD of the column to row 'rank'. Rows are
+				 * contiguous, and elements of S left of column j are zero in both rows (@see DoEuclidStep()).
+				 */
+				for (auto i = n_rows - 1; i > rank; --i)
+				{
+					while (S(i, j) != T(0))
+					{
+						T multiplier(-(S(i - 1, j) / S(i, j)));
+						DoEuclidStep(&U(i - 1, 0), &U(i, 0), 1, U.n_cols, multiplier);
+						DoEuclidStep(&S(i - 1, j), &S(i, j), 1, n_cols - j, multiplier);
+					}
+				}
+				++rank;
+			}
+			return rank;
+		}
+
+		/**
+		 * @brief Reduces this matrix A to echelon matrix S computing unimodular matrix V such that A = VS.
+		 *
+		 * @retval Rank of matrix S (number of non-zero rows in case of echelon matrices)
+		 * @see MatrixExt::ReduceToEchelon2() and Loop Transformations for Restructuring Compilers, The Foundations (Algorithm 2.2)
+		 */
+		uword ReduceToEchelon2(UnimodularType& V, SmallMatrix& S) const
+		{
+			V.eye(n_rows, n_rows);
+			S = *this;
+
+			uword rank(0);
+			for (auto j = 0U; j < n_cols && rank < n_rows; ++j)
+			{
+				if (S.IsZeroBelow(rank, j))
+					continue;
+
+				for (auto i = n_rows - 1; i > rank; --i)
+				{
+					while (S(i, j) != T(0))
+					{
+						T multiplier(S(i - 1, j) / S(i, j));
+						DoEuclidStep(&S(i - 1, j), &S(i, j), 1, n_cols - j, T(-multiplier));
+						DoEuclidStep(&V(0, i), &V(0, i - 1), MaxRows, V.n_rows, multiplier);
+					}
+				}
+				++rank;
+			}
+			return rank;
+		}
+
+		/**
+		 * @brief Calculates exact inverse of this matrix if it is square and unimodular, without allocating memory.
+		 *
+		 * @retval FALSE if this matrix is not a square unimodular matrix.
+		 * @see MatrixExt::InvertUnimodular()
+		 */
+		bool InvertUnimodular(UnimodularType& inverse) const
+		{
+			if (n_rows != n_cols)
+				return false;
+
+			UnimodularType U;
+			SmallMatrix S;
+			const uword rank_s(ReduceToEchelon(U, S));
+			inverse.set_size(n_rows, n_rows);
+			return InvertFromEchelon(S, rank_s, U, inverse);
+		}
+
+		/** Dimensions of the matrix (named like the ones of arma::Mat). Change them through set_size(), zeros() or eye() only. */
+		uword n_rows;
+		uword n_cols;
+
+	private:
+		/** Returns TRUE if elements of column col are zero in rows first_row, first_row + 1,..., n_rows - 1. */
+		bool IsZeroBelow(const uword first_row, const uword col) const
+		{
+			for (auto i = first_row; i < n_rows; ++i)
+			{
+				if ((*this)(i, col) != T(0))
+					return false;
+			}
+			return true;
+		}
+
+		std::array<T, MaxRows * MaxCols> m_elements;
+	};
+
+	/** Row vector with inline storage. */
+	template<typename T, uword MaxCols = SMALL_MATRIX_CAPACITY>
+	using SmallRowVector = SmallMatrix<T, 1, MaxCols>;
+
+	/** @throw std::logic_error if X.n_cols != Y.n_rows, std::range_error if the product exceeds the capacity of the result. */
+	template<typename T, uword MaxRows1, uword MaxCols1, uword MaxRows2, uword MaxCols2>
+	SmallMatrix<T, MaxRows1, MaxCols2> operator*(const SmallMatrix<T, MaxRows1, MaxCols1>& X, const SmallMatrix<T, MaxRows2, MaxCols2>& Y)
+	{
+		if (X.n_cols != Y.n_rows)
+			throw std::logic_error("SmallMatrix::operator*(): number of cols of X must be equal to the number of rows of Y");
+
+		SmallMatrix<T, MaxRows1, MaxCols2> out(X.n_rows, Y.n_cols);
+		for (auto i = 0U; i < X.n_rows; ++i)
+		{
+			for (auto k = 0U; k < X.n_cols; ++k)
+			{
+				const T x_ik(X(i, k));
+				if (x_ik == T(0))
+					continue;
+
+				for (auto j = 0U; j < Y.n_cols; ++j)
+					out(i, j) += x_ik * Y(k, j);
+			}
+		}
+		return out;
+	}
+
+} /// namespace util
+} /// namespace gap
+
+#endif /// GAP_UTIL_SMALL_MATRIX_H
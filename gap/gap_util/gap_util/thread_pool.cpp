@@ -0,0 +1,136 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "thread_pool.h"
+#include <stdexcept>
+
+namespace gap
+{
+namespace util
+{
+
+	ThreadPool::ThreadPool(unsigned thread_cnt)
+		: m_pending(0)
+		, m_stop(false)
+	{
+		if (thread_cnt == 0)
+			throw std::logic_error("c2cuda::ThreadPool::ThreadPool(): thread_cnt must be positive");
+
+		m_workers.reserve(thread_cnt);
+		for (unsigned i = 0; i < thread_cnt; ++i)
+			m_workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+
+		m_task_available.notify_all();
+		for (auto & worker : m_workers)
+			worker.join();
+	}
+
+	unsigned ThreadPool::GetThreadCnt() const
+	{
+		return static_cast<unsigned>(m_workers.size());
+	}
+
+	void ThreadPool::Submit(Task task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_tasks.push_back(std::move(task));
+			++m_pending;
+		}
+
+		m_task_available.notify_one();
+	}
+
+	void ThreadPool::Wait()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_tasks_done.wait(lock, [this]() { return m_pending == 0; });
+
+		if (m_exception)
+		{
+			std::exception_ptr exc = m_exception;
+			m_exception = nullptr;
+			std::rethrow_exception(exc);
+		}
+	}
+
+	void ThreadPool::WorkerLoop(unsigned worker_idx)
+	{
+		for (;;)
+		{
+			Task task;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_task_available.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+				if (m_tasks.empty())
+					return;
+
+				task = std::move(m_tasks.front());
+				m_tasks.pop_front();
+			}
+
+			std::exception_ptr exc;
+			try
+			{
+				task(worker_idx);
+			}
+			catch (...)
+			{
+				exc = std::current_exception();
+			}
+
+			bool all_done;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (exc && !m_exception)
+					m_exception = exc;
+
+				all_done = (--m_pending == 0);
+			}
+
+			if (all_done)
+				m_tasks_done.notify_all();
+		}
+	}
+
+} /// namespace util
+} /// namespace gap
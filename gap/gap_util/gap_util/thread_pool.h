@@ -0,0 +1,90 @@
+///==============================================================================
+/// GAP (General Autonomous Parallelizer) License
+///==============================================================================
+///
+/// GAP is distributed under the following BSD-style license:
+///
+/// Copyright (c) 2016 Dzanan Bajgoric
+/// All rights reserved.
+/// 
+/// Redistribution and use in source and binary forms, with or without modification,
+/// are permitted provided that the following conditions are met:
+/// 
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+/// 
+/// 2. Redistributions in binary form must reproduce the above copyright notice, this
+///    list of conditions and the following disclaimer in the documentation and/or other
+///    materials provided with the distribution.
+/// 
+/// 3. The name of the author may not be used to endorse or promote products derived from
+///    this software without specific prior written permission from the author.
+/// 
+/// 4. Products derived from this software may not be called "GAP" nor may "GAP" appear
+///    in their names without specific prior written permission from the author.
+/// 
+/// THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+/// BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+/// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+/// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+/// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef GAP_UTIL_THREAD_POOL_H
+#define GAP_UTIL_THREAD_POOL_H
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <vector>
+#include <deque>
+
+namespace gap
+{
+namespace util
+{
+
+	/**
+	 * @brief Fixed-size pool of worker threads executing independent tasks. Tasks are executed in the
+	 * order of their submission, but there are no guarantees about the order in which they complete.
+	 * Each task receives the index of the worker that runs it (in range [0, GetThreadCnt())), so that
+	 * the caller can keep per-worker state without any locking. Wait() blocks until all submitted tasks
+	 * are finished and rethrows the first exception thrown by any of them (the remaining tasks are still
+	 * executed). The pool is meant to be created once and shared by all the analysis passes.
+	 */
+	class ThreadPool
+	{
+	public:
+		typedef std::function<void(unsigned)> Task;
+
+		explicit ThreadPool(unsigned thread_cnt);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		unsigned GetThreadCnt() const;
+		void Submit(Task task);
+		void Wait();
+
+	private:
+		void WorkerLoop(unsigned worker_idx);
+
+		std::vector<std::thread> m_workers;
+		std::deque<Task> m_tasks;
+		std::mutex m_mutex;
+		std::condition_variable m_task_available;
+		std::condition_variable m_tasks_done;
+		std::size_t m_pending;
+		bool m_stop;
+		std::exception_ptr m_exception;
+	};
+
+} /// namespace util
+} /// namespace gap
+
+#endif /// GAP_UTIL_THREAD_POOL_H